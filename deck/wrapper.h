@@ -126,6 +126,20 @@ vpic_simulation::user_particle_collisions( void )
 
 // FIXME: THESE GLOBAL POSITION CALCULATIONS NEED TO BE MADE MORE RIGOROUS
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+
+// Without material ids, the whole domain is filled with the first
+// material.  Only assigning that material is allowed.
+
+#define set_point_region_material( rgn, rmat ) do {                 \
+    const material_id _rmat = get_material_id( (rmat) );            \
+    if( _rmat>0 )                                                   \
+      ERROR(( "set_point_region_material is not supported when "    \
+              "VPIC is built with USE_VACUUM_FIELDS" ));            \
+  } while(0)
+
+#else
+
 #define set_point_region_material( rgn, rmat ) do {                 \
     const material_id _rmat = get_material_id( (rmat) );            \
     if( _rmat==-1 ) break;                                          \
@@ -147,6 +161,8 @@ vpic_simulation::user_particle_collisions( void )
     }}}                                                             \
   } while(0)
 
+#endif
+
 #define set_point_region_bc( rgn, ipbc, epbc ) do {            		 \
     const int64_t _ipbc = get_particle_bc_id( (particle_bc_t *)(ipbc) ); \
     const int64_t _epbc = get_particle_bc_id( (particle_bc_t *)(epbc) ); \
@@ -191,6 +207,7 @@ vpic_simulation::user_particle_collisions( void )
 #define set_point_region_field( rgn,                                     \
                                 eqn_ex, eqn_ey, eqn_ez,                  \
                                 eqn_bx, eqn_by, eqn_bz ) do {            \
+    unload_soa_field_array( field_array );                               \
     const double _x0 = grid->x0, _y0 = grid->y0, _z0 = grid->z0;         \
     const double _dx = grid->dx, _dy = grid->dy, _dz = grid->dz;         \
     const double _c  = grid->cvac;                                       \
@@ -210,6 +227,18 @@ vpic_simulation::user_particle_collisions( void )
     }}}                                                                  \
   } while(0)
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+
+#define set_region_material( rgn, vmat, smat ) do {                    \
+    const material_id _vmat = get_material_id( (vmat) );               \
+    const material_id _smat = get_material_id( (smat) );               \
+    if( _vmat>0 || _smat>0 )                                           \
+      ERROR(( "set_region_material is not supported when VPIC is "     \
+              "built with USE_VACUUM_FIELDS" ));                       \
+  } while(0)
+
+#else
+
 #define set_region_material( rgn, vmat, smat ) do {                    \
     const material_id _vmat = get_material_id( (vmat) );               \
     const material_id _smat = get_material_id( (smat) );               \
@@ -254,6 +283,8 @@ vpic_simulation::user_particle_collisions( void )
     }}}                                                                \
   } while(0)
 
+#endif
+
 #define set_region_bc( rgn, vpbc, ipbc, epbc ) do {                      \
     const int64_t _vpbc = get_particle_bc_id( (particle_bc_t *)(vpbc) ); \
     const int64_t _ipbc = get_particle_bc_id( (particle_bc_t *)(ipbc) ); \
@@ -389,6 +420,7 @@ vpic_simulation::user_particle_collisions( void )
 #define set_region_field( rgn,                                        \
                           eqn_ex, eqn_ey, eqn_ez,                     \
                           eqn_bx, eqn_by, eqn_bz ) do {               \
+    unload_soa_field_array( field_array );                            \
     const double _x0 = grid->x0, _y0 = grid->y0, _z0 = grid->z0;      \
     const double _dx = grid->dx, _dy = grid->dy, _dz = grid->dz;      \
     const double _c  = grid->cvac;                                    \
@@ -36,13 +36,232 @@ using namespace v8;
 
 enum { MAX_PBC = 32, MAX_SP = 32 };
 
-// This is the AoS implementation.
+// Modes of exchange_p.  FACE_EXCHANGE sends the particles leaving the
+// local domain to the face neighbours, which finish moving them.
+// CORNER_EXCHANGE finishes moving them here and sends them to the face,
+// edge or corner neighbour where they stop.  LOCAL_EXCHANGE only
+// handles the local boundary interactions.
+
+enum { FACE_EXCHANGE = 0, CORNER_EXCHANGE = 1, LOCAL_EXCHANGE = 2 };
+
+// Streaks of the neighbouring domains a particle routed by the edge and
+// corner exchange may make and the max local exchanges done after it.
+
+enum { MAX_ROUTE_STREAK = 4, MAX_LOCAL_EXCHANGE = 8 };
+
+// Follow a particle that left the local domain through a shared face.
+// pi holds the particle entering voxel (x,y,z) of the face neighbour,
+// in the local voxel coordinates extended by one domain on each side,
+// and q is its charge.  The move is done with the same arithmetic as
+// the scalar move_p and the current of each streak is saved in cj.
+//
+// On return pi holds the particle in the local voxel coordinates of
+// its new domain and port[0] is the port of that domain.  port[1+n] is
+// the port of the domain of cj[n].  The particle has no displacement
+// left if it was followed to its end.  Otherwise it is left at the
+// start of the voxel where it could not be followed further, for the
+// domain of that voxel to finish the move.  This is the case if it
+// leaves the neighbourhood, makes more than MAX_ROUTE_STREAK streaks
+// or hits a face plane of the neighbourhood where the local face has
+// a particle boundary condition other than reflection.  Particle
+// boundary conditions inside the neighbouring domains are not seen.
+//
+// plane[face] is 1 if the particles cross the face plane of the
+// neighbourhood on the local face, 2 if they are reflected and 0 if
+// they cannot be followed.  Returns the number of current injectors.
+
+static int
+route_p( particle_injector_t * RESTRICT pi,
+         current_injector_t  * RESTRICT cj,
+         int                 * RESTRICT port,
+         int x,
+         int y,
+         int z,
+         float q,
+         const int * RESTRICT n,
+         const int * RESTRICT peer,
+         const int * RESTRICT plane )
+{
+  float s_midx, s_midy, s_midz;
+  float s_dispx, s_dispy, s_dispz;
+  float s_dir[3];
+  float v0, v1, v2, v3, v4, v5;
+  float * a;
+  int c[3], o[3], b, k, axis, face, nc, in, cross;
 
-void
-boundary_p( particle_bc_t       * RESTRICT pbc_list,
+  particle_injector_t entry;
+
+  c[0] = x;
+  c[1] = y;
+  c[2] = z;
+
+  for( nc = 0; ; nc++ )
+  {
+    // Find the domain of the voxel.  It was checked to be in the
+    // neighbourhood when the particle entered it.
+
+    for( k = 0; k < 3; k++ )
+    {
+      o[k] = ( c[k] < 1 ) ? -1 : ( ( c[k] > n[k] ) ? 1 : 0 );
+    }
+
+    b = BOUNDARY( o[0], o[1], o[2] );
+
+    entry    = *pi;
+    entry.i  = VOXEL( c[0] - o[0] * n[0],
+                      c[1] - o[1] * n[1],
+                      c[2] - o[2] * n[2],
+                      n[0], n[1], n[2] );
+
+    // Move the particle to the end of the streak in the voxel.  See
+    // the scalar move_p.
+
+    s_midx = pi->dx;
+    s_midy = pi->dy;
+    s_midz = pi->dz;
+
+    s_dispx = pi->dispx;
+    s_dispy = pi->dispy;
+    s_dispz = pi->dispz;
+
+    s_dir[0] = ( s_dispx > 0.0f ) ? 1.0f : -1.0f;
+    s_dir[1] = ( s_dispy > 0.0f ) ? 1.0f : -1.0f;
+    s_dir[2] = ( s_dispz > 0.0f ) ? 1.0f : -1.0f;
+
+    v0 = ( s_dispx == 0.0f ) ? 3.4e38f : ( s_dir[0] - s_midx ) / s_dispx;
+    v1 = ( s_dispy == 0.0f ) ? 3.4e38f : ( s_dir[1] - s_midy ) / s_dispy;
+    v2 = ( s_dispz == 0.0f ) ? 3.4e38f : ( s_dir[2] - s_midz ) / s_dispz;
+
+    /**/           v3 = 2.0f, axis = 3;
+    if ( v0 < v3 ) v3 = v0,   axis = 0;
+    if ( v1 < v3 ) v3 = v1,   axis = 1;
+    if ( v2 < v3 ) v3 = v2,   axis = 2;
+    v3 *= 0.5f;
+
+    // Find out if the streak can be followed before accumulating it.
+
+    if ( axis != 3 )
+    {
+      face = axis;
+
+      if ( s_dir[axis] > 0.0f )
+      {
+        face += 3;
+      }
+
+      k     = c[axis] + ( ( s_dir[axis] > 0.0f ) ? 1 : -1 );
+      in    = ( k >= 1 && k <= n[axis] );
+      cross = ( in != ( o[axis] == 0 ) ) ? plane[face] : 1;
+
+      if ( cross == 1 )
+      {
+        o[axis] = ( k < 1 ) ? -1 : ( ( k > n[axis] ) ? 1 : 0 );
+
+        if ( k < 1 - n[axis] || k > 2 * n[axis] ||
+             peer[ BOUNDARY( o[0], o[1], o[2] ) ] < 0 )
+        {
+          cross = 0;
+        }
+      }
+
+      if ( cross == 0 || nc + 1 == MAX_ROUTE_STREAK )
+      {
+        *pi     = entry;
+        port[0] = b;
+
+        return nc;
+      }
+    }
+
+    s_dispx *= v3;
+    s_dispy *= v3;
+    s_dispz *= v3;
+
+    s_midx += s_dispx;
+    s_midy += s_dispy;
+    s_midz += s_dispz;
+
+    v5 = q * s_dispx * s_dispy * s_dispz * ( 1.0 / 3.0 );
+
+    a = cj[nc].jx;
+
+    #define accumulate_j(X,Y,Z)                                       \
+    v4  = q*s_disp##X;                                                \
+    v1  = v4*s_mid##Y;                                                \
+    v0  = v4-v1;                                                      \
+    v1 += v4;                                                         \
+    v4  = 1+s_mid##Z;                                                 \
+    v2  = v0*v4;                                                      \
+    v3  = v1*v4;                                                      \
+    v4  = 1-s_mid##Z;                                                 \
+    v0 *= v4;                                                         \
+    v1 *= v4;                                                         \
+    v0 += v5;                                                         \
+    v1 -= v5;                                                         \
+    v2 -= v5;                                                         \
+    v3 += v5;                                                         \
+    a[0] = v0;                                                        \
+    a[1] = v1;                                                        \
+    a[2] = v2;                                                        \
+    a[3] = v3
+
+    accumulate_j(x,y,z); a += 4;
+    accumulate_j(y,z,x); a += 4;
+    accumulate_j(z,x,y);
+
+    #undef accumulate_j
+
+    cj[nc].i     = entry.i;
+    cj[nc].sp_id = pi->sp_id;
+    port[1+nc]   = b;
+
+    pi->dispx -= s_dispx;
+    pi->dispy -= s_dispy;
+    pi->dispz -= s_dispz;
+
+    pi->dx += s_dispx + s_dispx;
+    pi->dy += s_dispy + s_dispy;
+    pi->dz += s_dispz + s_dispz;
+
+    if ( axis == 3 )
+    {
+      pi->dispx = 0;
+      pi->dispy = 0;
+      pi->dispz = 0;
+      pi->i     = entry.i;
+      port[0]   = b;
+
+      return nc + 1;
+    }
+
+    v0 = s_dir[axis];
+
+    ( &pi->dx )[axis] = v0;
+
+    if ( cross == 2 )
+    {
+      ( &pi->ux    )[axis] = - ( &pi->ux    )[axis];
+      ( &pi->dispx )[axis] = - ( &pi->dispx )[axis];
+
+      continue;
+    }
+
+    c[axis] = k;
+
+    ( &pi->dx )[axis] = - v0;
+  }
+}
+
+// Particles are accessed through the layout neutral accessors in
+// species_advance.h so this works with either particle layout.  The
+// vector copies below are only used with the AoS layout.
+
+static void
+exchange_p( particle_bc_t       * RESTRICT pbc_list,
             species_t           * RESTRICT sp_list,
             field_array_t       * RESTRICT fa,
-            accumulator_array_t * RESTRICT aa )
+            accumulator_array_t * RESTRICT aa,
+            int mode )
 {
   // Gives the local mp port associated with a local face.
   static const int f2b[6]  = { BOUNDARY(-1, 0, 0),
@@ -52,14 +271,6 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
                                BOUNDARY( 0, 1, 0),
                                BOUNDARY( 0, 0, 1) };
 
-  // Gives the remote mp port associated with a local face.
-  static const int f2rb[6] = { BOUNDARY( 1, 0, 0),
-                               BOUNDARY( 0, 1, 0),
-                               BOUNDARY( 0, 0, 1),
-                               BOUNDARY(-1, 0, 0),
-                               BOUNDARY( 0,-1, 0),
-                               BOUNDARY( 0, 0,-1) };
-
   // Gives the axis associated with a local face.
   static const int axis[6]  = { 0, 1, 2, 0, 1, 2 };
 
@@ -72,25 +283,32 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
   static int max_ci = 0;
 
-  int n_send[6], n_recv[6], n_ci;
+  // Temporary store for the particle and current injectors of the edge
+  // and corner exchange and their ports.
+  static particle_injector_t * RESTRICT ALIGNED(16) cs = NULL;
+  static current_injector_t  * RESTRICT ALIGNED(16) cc = NULL;
 
-  species_t * sp;
+  static int * cs_port = NULL, * cc_port = NULL;
 
-  int face;
+  static int max_cs = 0;
 
-  // Check input args.
+  // The ports exchanged, faces first.  A message sent on port
+  // BOUNDARY(i,j,k) is received on the port BOUNDARY(-i,-j,-k) of the
+  // receiver, which is 2*BOUNDARY(0,0,0) minus it.
+  int port_list[26], n_port, port, peer[27];
+  int64_t range[27];
 
-  if ( ! sp_list )
-  {
-    return; // Nothing to do if no species.
-  }
+  int n_send[27], n_cur[27], n_recv[27], sz_recv[27], n_ci, n_cs, n_cc;
 
-  if ( ! fa                ||
-       ! aa                ||
-       sp_list->g != aa->g ||
-       fa->g      != aa->g )
+  int n_lost[ MAX_SP ];
+
+  species_t * sp;
+
+  int face, route, k;
+
+  if ( num_species( sp_list ) > MAX_SP )
   {
-    ERROR( ( "Bad args." ) );
+    ERROR( ( "Update this to support more species." ) );
   }
 
   // Unpack the particle boundary conditions.
@@ -130,41 +348,79 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
   const int64_t rangeh = g->rangeh;
   const int64_t rangem = g->range[world_size];
 
-  /*const*/ int bc[6], shared[6];
-  /*const*/ int64_t range[6];
+  const int nvox[3] = { g->nx, g->ny, g->nz };
+
+  int plane[6];
 
   for( face = 0; face < 6; face++ )
   {
-    bc    [ face ] = g->bc[ f2b[ face ] ];
+    port_list[ face ] = f2b[ face ];
+  }
 
-    shared[ face ] = ( bc[ face ] >= 0          ) &&
-                     ( bc[ face ] <  world_size ) &&
-                     ( bc[ face ] != world_rank );
+  n_port = 6;
 
-    if ( shared[ face ] )
+  for( int kz = -1; kz <= 1; kz++ )
+  {
+    for( int ky = -1; ky <= 1; ky++ )
     {
-      range[ face ] = g->range[ bc[ face ] ];
+      for( int kx = -1; kx <= 1; kx++ )
+      {
+        if ( kx * kx + ky * ky + kz * kz > 1 )
+        {
+          port_list[ n_port++ ] = BOUNDARY( kx, ky, kz );
+        }
+      }
     }
   }
 
-  // Begin receiving the particle counts.
+  for( port = 0; port < 27; port++ )
+  {
+    peer[ port ] = -1;
+  }
 
-  for( face = 0; face < 6; face++ )
+  n_port = ( mode == CORNER_EXCHANGE ) ? 26 :
+           ( mode == FACE_EXCHANGE   ) ?  6 : 0;
+
+  // The edge and corner routing needs neighbours with the same local
+  // resolution as this domain (as made by the partition_* functions).
+
+  route = ( mode == CORNER_EXCHANGE );
+
+  for( k = 0; k < n_port; k++ )
   {
-    if ( shared[ face ] )
+    port = port_list[ k ];
+
+    const int rank = g->bc[ port ];
+
+    if ( rank >= 0 && rank < world_size && rank != world_rank )
     {
-      mp_size_recv_buffer( mp,
-                           f2b[ face ],
-                           sizeof( int ) );
+      peer [ port ] = rank;
+      range[ port ] = g->range[ rank ];
 
-      mp_begin_recv( mp,
-                     f2b[ face ],
-                     sizeof( int ),
-                     bc[ face ],
-                     f2rb[ face ] );
+      if ( g->range[ rank + 1 ] - g->range[ rank ] != g->nv )
+      {
+        route = 0;
+      }
     }
   }
 
+  // The particles cross a face plane of the edge and corner
+  // neighbourhood if the local face on it is joined and are reflected
+  // if it reflects them (see route_p).
+
+  for( face = 0; face < 6; face++ )
+  {
+    const int rank = g->bc[ f2b[ face ] ];
+
+    const int v    = ( face < 3 ) ? VOXEL( 1,     1,     1,     g->nx, g->ny, g->nz )
+                                  : VOXEL( g->nx, g->ny, g->nz, g->nx, g->ny, g->nz );
+
+    const int64_t nn = neighbor[ 6 * v + face ];
+
+    plane[ face ] = ( nn == reflect_particles                     ) ? 2 :
+                    ( nn >= 0 && rank >= 0 && rank < world_size ) ? 1 : 0;
+  }
+
   // Load the particle send and local injection buffers.
 
   do
@@ -185,7 +441,8 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
     // then move all injectors into the appropriate send buffers, leaving
     // only the local injectors.  This would require some extra data
     // motion though, but would give a more robust implementation against
-    // variations in MP implementation.
+    // variations in MP implementation.  The edge and corner exchange
+    // does this, since it would need 26 send buffers.
     //
     // FIXME: This presizing assumes that custom boundary conditions
     // inject at most one particle per incident particle.  Currently,
@@ -198,22 +455,45 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
     LIST_FOR_EACH( sp, sp_list ) nm += sp->nm;
 
-    for( face = 0; face < 6; face++ )
+    if ( mode == FACE_EXCHANGE )
     {
-      if ( shared[ face ] )
+      for( face = 0; face < 6; face++ )
       {
-        mp_size_send_buffer( mp,
-                             f2b[ face ],
-                             16 + nm * sizeof( particle_injector_t ) );
+        if ( peer[ f2b[ face ] ] >= 0 )
+        {
+          mp_size_send_buffer( mp,
+                               f2b[ face ],
+                               16 + nm * sizeof( particle_injector_t ) );
 
-        pi_send[ face ] = (particle_injector_t *) ( ( (char *) mp_send_buffer( mp,
-                                                                               f2b[ face ] )
-                                                    ) + 16 );
+          pi_send[ face ] = (particle_injector_t *) ( ( (char *) mp_send_buffer( mp,
+                                                                                 f2b[ face ] )
+                                                      ) + 16 );
 
-        n_send[ face ] = 0;
+          n_send[ f2b[ face ] ] = 0;
+        }
       }
     }
 
+    if ( mode == CORNER_EXCHANGE && max_cs < nm )
+    {
+      particle_injector_t * new_cs = cs;
+      current_injector_t  * new_cc = cc;
+
+      FREE_ALIGNED( new_cs );
+      FREE_ALIGNED( new_cc );
+      FREE( cs_port );
+      FREE( cc_port );
+
+      MALLOC_ALIGNED( new_cs, nm, 16 );
+      MALLOC_ALIGNED( new_cc, MAX_ROUTE_STREAK * nm, 16 );
+      MALLOC( cs_port, nm );
+      MALLOC( cc_port, MAX_ROUTE_STREAK * nm );
+
+      cs     = new_cs;
+      cc     = new_cc;
+      max_cs = nm;
+    }
+
     if ( max_ci < nm )
     {
       particle_injector_t * new_ci = ci;
@@ -227,6 +507,8 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
     }
 
     n_ci = 0;
+    n_cs = 0;
+    n_cc = 0;
 
     // For each species, load the movers.
 
@@ -235,16 +517,20 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
       const float   sp_q  = sp->q;
       const int32_t sp_id = sp->id;
 
-      particle_t * RESTRICT ALIGNED(128) p0 = sp->p;
+      particle_block_t * RESTRICT ALIGNED(128) p0 = sp->p;
       int np = sp->np;
 
+      DECLARE_PARTICLE_RECORD( p_rec );
+
       particle_mover_t * RESTRICT ALIGNED(16)  pm = sp->pm + sp->nm - 1;
       nm = sp->nm;
 
       particle_injector_t * RESTRICT ALIGNED(16) pi;
-      int i, voxel;
+      int i, voxel, c[3], m, n_route, route_port[ 1 + MAX_ROUTE_STREAK ];
       int64_t nn;
 
+      n_lost[ sp_id ] = 0;
+
       // Note that particle movers for each species are processed in
       // reverse order.  This allows us to backfill holes in the
       // particle list created by boundary conditions and/or
@@ -257,10 +543,10 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
       for( ; nm; pm--, nm-- )
       {
         i       = pm->i;
-        voxel   = p0[i].i;
+        voxel   = P_ELEM( p0, i, i );
         face    = voxel & 7;
         voxel >>= 3;
-        p0[i].i = voxel;
+        P_ELEM( p0, i, i ) = voxel;
         nn      = neighbor[ 6 * voxel + face ];
 
         // Absorb.
@@ -269,7 +555,7 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
         {
           // Ideally, we would batch all rhob accumulations together
           // for efficiency.
-          accumulate_rhob( f, p0 + i, g, sp_q );
+          accumulate_rhob( f, PARTICLE_RECORD( p_rec, p0, i ), g, sp_q );
 
           goto backfill;
         }
@@ -279,9 +565,32 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
         if ( ( ( nn >= 0      ) & ( nn <  rangel ) ) |
              ( ( nn >  rangeh ) & ( nn <= rangem ) ) )
         {
-          pi = &pi_send[ face ] [ n_send[ face ]++ ];
+          // The local exchange cannot deliver the particle.  It is
+          // removed like the particles advance drops after the last
+          // boundary_p round.
+
+          if ( mode == LOCAL_EXCHANGE )
+          {
+            accumulate_rhob( f, PARTICLE_RECORD( p_rec, p0, i ), g, sp_q );
+
+            n_lost[ sp_id ]++;
+
+            goto backfill;
+          }
+
+          if ( mode == FACE_EXCHANGE )
+          {
+            pi = &pi_send[ face ] [ n_send[ f2b[ face ] ]++ ];
+          }
+
+          else
+          {
+            pi = cs + n_cs;
+
+            cs_port[ n_cs++ ] = f2b[ face ];
+          }
 
-          #ifdef V4_ACCELERATION
+          #if defined(V4_ACCELERATION) && !defined(VPIC_USE_AOSOA_P)
 
           copy_4x1( &pi->dx,    &p0[i].dx  );
           copy_4x1( &pi->ux,    &p0[i].ux  );
@@ -289,14 +598,14 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
           #else
 
-          pi->dx    = p0[i].dx;
-          pi->dy    = p0[i].dy;
-          pi->dz    = p0[i].dz;
+          pi->dx    = P_ELEM( p0, i, dx );
+          pi->dy    = P_ELEM( p0, i, dy );
+          pi->dz    = P_ELEM( p0, i, dz );
 
-          pi->ux    = p0[i].ux;
-          pi->uy    = p0[i].uy;
-          pi->uz    = p0[i].uz;
-          pi->w     = p0[i].w;
+          pi->ux    = P_ELEM( p0, i, ux );
+          pi->uy    = P_ELEM( p0, i, uy );
+          pi->uz    = P_ELEM( p0, i, uz );
+          pi->w     = P_ELEM( p0, i, w  );
 
           pi->dispx = pm->dispx;
           pi->dispy = pm->dispy;
@@ -305,9 +614,37 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
           #endif
 
           ( &pi->dx )[ axis[ face ] ] = dir[ face ];
-          pi->i                       = nn - range[ face ];
+          pi->i                       = nn - range[ f2b[ face ] ];
           pi->sp_id                   = sp_id;
 
+          // Move the particle here as far as its path can be
+          // followed and send it to the domain where it stops.
+
+          if ( route )
+          {
+            c[0] = voxel % g->sy;
+            c[1] = ( voxel / g->sy ) % ( g->ny + 2 );
+            c[2] = voxel / g->sz;
+
+            c[ axis[ face ] ] -= (int) dir[ face ];
+
+            n_route = route_p( pi,
+                               cc + n_cc,
+                               route_port,
+                               c[0], c[1], c[2],
+                               sp_q * pi->w,
+                               nvox,
+                               peer,
+                               plane );
+
+            cs_port[ n_cs - 1 ] = route_port[0];
+
+            for( m = 0; m < n_route; m++ )
+            {
+              cc_port[ n_cc++ ] = route_port[ 1 + m ];
+            }
+          }
+
           goto backfill;
         }
 
@@ -336,7 +673,7 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
         {
           n_ci += pbc_interact[ nn ]( pbc_params[ nn ],
                                       sp,
-                                      p0 + i,
+                                      PARTICLE_RECORD( p_rec, p0, i ),
                                       pm,
                                       ci + n_ci,
                                       1,
@@ -355,7 +692,11 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
         np--;
 
-        #if defined(V8_ACCELERATION)
+        #if defined(VPIC_USE_AOSOA_P)
+
+        COPY_PARTICLE( p0, i, p0, np );
+
+        #elif defined(V8_ACCELERATION)
 
         copy_8x1( &p0[i].dx, &p0[np].dx );
 
@@ -377,74 +718,208 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
   } while(0);
 
-  // Finish exchanging particle counts and start exchanging actual
-  // particles.
+  // Move the injectors of the edge and corner exchange into the send
+  // buffers.  A message is a header with the number of particle and
+  // current injectors, the particle injectors and the current
+  // injectors.
 
-  // Note: This is wasteful of communications.  A better protocol
-  // would fuse the exchange of the counts with the exchange of the
-  // messages.  in a slightly more complex protocol.  However, the MP
-  // API prohibits such a model.  Unfortuantely, refining MP is not
-  // much help here.  Under the hood on Roadrunner, the DaCS API also
-  // prohibits such (specifically, in both, you can't do the
-  // equilvanet of a MPI_Getcount to determine how much data you
-  // actually received.
+  if ( mode == CORNER_EXCHANGE )
+  {
+    particle_injector_t * RESTRICT pi_send[27];
+    current_injector_t  * RESTRICT cj_send[27];
 
-  for( face = 0; face < 6; face++ )
+    int32_t * header;
+
+    for( k = 0; k < n_port; k++ )
+    {
+      port = port_list[ k ];
+
+      n_send[ port ] = 0;
+      n_cur [ port ] = 0;
+    }
+
+    for( k = 0; k < n_cs; k++ ) n_send[ cs_port[ k ] ]++;
+    for( k = 0; k < n_cc; k++ ) n_cur [ cc_port[ k ] ]++;
+
+    for( k = 0; k < n_port; k++ )
+    {
+      port = port_list[ k ];
+
+      if ( peer[ port ] >= 0 )
+      {
+        mp_size_send_buffer( mp,
+                             port,
+                             16 + n_send[ port ] * sizeof( particle_injector_t ) +
+                                  n_cur [ port ] * sizeof( current_injector_t ) );
+
+        header = (int32_t *) mp_send_buffer( mp, port );
+
+        header[0] = n_send[ port ];
+        header[1] = n_cur [ port ];
+        header[2] = 0;
+        header[3] = 0;
+
+        pi_send[ port ] = (particle_injector_t *) ( ( (char *) header ) + 16 );
+        cj_send[ port ] = (current_injector_t *) ( pi_send[ port ] + n_send[ port ] );
+      }
+    }
+
+    for( k = 0; k < n_cs; k++ ) *( pi_send[ cs_port[ k ] ]++ ) = cs[ k ];
+    for( k = 0; k < n_cc; k++ ) *( cj_send[ cc_port[ k ] ]++ ) = cc[ k ];
+  }
+
+  // Send the particles and begin receiving the particles.
+
+  #if defined(USE_MPRELAY)
+
+  // The relay cannot probe for the size of an incoming message.  So the
+  // message sizes are exchanged first and each exchange costs two message
+  // latencies.  The size is sent from the first word of the header, which
+  // is restored before the particles are sent.
+
+  for( k = 0; k < n_port; k++ )
   {
-    if ( shared[ face ] )
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
+    {
+      mp_size_recv_buffer( mp,
+                           port,
+                           sizeof( int ) );
+
+      mp_begin_recv( mp,
+                     port,
+                     sizeof( int ),
+                     peer[ port ],
+                     2 * BOUNDARY( 0, 0, 0 ) - port );
+    }
+  }
+
+  for( k = 0; k < n_port; k++ )
+  {
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
     {
       *( (int *) mp_send_buffer( mp,
-                                 f2b[ face ] ) ) = n_send[ face ];
+                                 port ) ) =
+        16 + n_send[ port ] * sizeof( particle_injector_t ) +
+             ( ( mode == CORNER_EXCHANGE ) ?
+               n_cur[ port ] * sizeof( current_injector_t ) : 0 );
 
       mp_begin_send( mp,
-                     f2b[ face ],
+                     port,
                      sizeof( int ),
-                     bc[ face ],
-                     f2b[ face ] );
+                     peer[ port ],
+                     port );
     }
   }
 
-  for( face = 0; face < 6; face++ )
+  for( k = 0; k < n_port; k++ )
   {
-    if ( shared[ face ] )
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
     {
       mp_end_recv( mp,
-                   f2b[ face ] );
+                   port );
 
-      n_recv[ face ] = *( (int *) mp_recv_buffer( mp,
-                                                  f2b[ face ] ) );
+      sz_recv[ port ] = *( (int *) mp_recv_buffer( mp,
+                                                   port ) );
+
+      // For the edge and corner exchange, this is an upper bound until
+      // the header is received.
+
+      n_recv[ port ] = ( sz_recv[ port ] - 16 ) / sizeof( particle_injector_t );
 
       mp_size_recv_buffer( mp,
-                           f2b[ face ],
-                           16 + n_recv[ face ] * sizeof( particle_injector_t ) );
+                           port,
+                           sz_recv[ port ] );
 
       mp_begin_recv( mp,
-                     f2b[ face ],
-                     16 + n_recv[ face ] * sizeof( particle_injector_t ),
-                     bc[ face ],
-                     f2rb[ face ] );
+                     port,
+                     sz_recv[ port ],
+                     peer[ port ],
+                     2 * BOUNDARY( 0, 0, 0 ) - port );
     }
   }
 
-  for( face = 0; face < 6; face++ )
+  for( k = 0; k < n_port; k++ )
   {
-    if ( shared[ face ] )
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
     {
       mp_end_send( mp,
-                   f2b[ face ] );
+                   port );
 
-      // FIXME: ASSUMES MP WON'T MUCK WITH REST OF SEND BUFFER. IF WE
-      // DID MORE EFFICIENT MOVER ALLOCATION ABOVE, THIS WOULD BE
-      // ROBUSTED AGAINST MP IMPLEMENTATION VAGARIES.
+      // Assumes MP does not touch the rest of the send buffer.
 
+      *( (int32_t *) mp_send_buffer( mp,
+                                     port ) ) = n_send[ port ];
+
+      mp_begin_send( mp,
+                     port,
+                     16 + n_send[ port ] * sizeof( particle_injector_t ) +
+                          ( ( mode == CORNER_EXCHANGE ) ?
+                            n_cur[ port ] * sizeof( current_injector_t ) : 0 ),
+                     peer[ port ],
+                     port );
+    }
+  }
+
+  #else
+
+  // The particle counts are not exchanged separately.  The receiver
+  // finds the number of particles from the size of the message, so each
+  // exchange costs one message latency instead of two.
+
+  for( k = 0; k < n_port; k++ )
+  {
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
+    {
       mp_begin_send( mp,
-                     f2b[ face ],
-                     16 + n_send[ face ] * sizeof( particle_injector_t ),
-                     bc[ face ],
-                     f2b[ face ] );
+                     port,
+                     16 + n_send[ port ] * sizeof( particle_injector_t ) +
+                          ( ( mode == CORNER_EXCHANGE ) ?
+                            n_cur[ port ] * sizeof( current_injector_t ) : 0 ),
+                     peer[ port ],
+                     port );
+    }
+  }
+
+  for( k = 0; k < n_port; k++ )
+  {
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
+    {
+      sz_recv[ port ] = mp_probe_recv( mp,
+                                       port,
+                                       peer[ port ],
+                                       2 * BOUNDARY( 0, 0, 0 ) - port );
+
+      // For the edge and corner exchange, this is an upper bound until
+      // the header is received.
+
+      n_recv[ port ] = ( sz_recv[ port ] - 16 ) / sizeof( particle_injector_t );
+
+      mp_size_recv_buffer( mp,
+                           port,
+                           sz_recv[ port ] );
+
+      mp_begin_recv( mp,
+                     port,
+                     sz_recv[ port ],
+                     peer[ port ],
+                     2 * BOUNDARY( 0, 0, 0 ) - port );
     }
   }
 
+  #endif
+
   #ifndef DISABLE_DYNAMIC_RESIZING
   // Resize particle storage to accomodate worst case inject.
 
@@ -454,23 +929,25 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
     // Resize each species's particle and mover storage to be large
     // enough to guarantee successful injection.  If we broke down
-    // the n_recv[face] by species before sending it, we could be
+    // the n_recv[port] by species before sending it, we could be
     // tighter on memory footprint here.
 
     int max_inj = n_ci;
 
-    for( face = 0; face < 6; face++ )
+    for( k = 0; k < n_port; k++ )
     {
-      if ( shared[ face ] )
+      port = port_list[ k ];
+
+      if ( peer[ port ] >= 0 )
       {
-        max_inj += n_recv[ face ];
+        max_inj += n_recv[ port ];
       }
     }
 
     LIST_FOR_EACH( sp, sp_list )
     {
       particle_mover_t * new_pm;
-      particle_t       * new_p;
+      particle_block_t * new_p;
 
       n = sp->np + max_inj;
 
@@ -486,9 +963,9 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
                    //sp->max_np,
                    //n ) );
 
-        MALLOC_ALIGNED( new_p, n, 128 );
+        MALLOC_ALIGNED( new_p, PARTICLE_BLOCKS( n ), 128 );
 
-        COPY( new_p, sp->p, sp->np );
+        COPY( new_p, sp->p, PARTICLE_BLOCKS( sp->np ) );
 
         FREE_ALIGNED( sp->p );
 
@@ -512,9 +989,9 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
                    //sp->max_np,
                    //n ) );
 
-        MALLOC_ALIGNED( new_p, n, 128 );
+        MALLOC_ALIGNED( new_p, PARTICLE_BLOCKS( n ), 128 );
 
-        COPY( new_p, sp->p, sp->np );
+        COPY( new_p, sp->p, PARTICLE_BLOCKS( sp->np ) );
 
         FREE_ALIGNED( sp->p );
 
@@ -555,8 +1032,9 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
   {
     // Unpack the species list for random acesss.
 
-    particle_t       * RESTRICT ALIGNED(32) sp_p [ MAX_SP ];
+    particle_block_t * RESTRICT ALIGNED(32) sp_p [ MAX_SP ];
     particle_mover_t * RESTRICT ALIGNED(32) sp_pm[ MAX_SP ];
+    accumulator_t    * RESTRICT ALIGNED(128) sp_a0[ MAX_SP ];
 
     float sp_q [ MAX_SP ];
     int   sp_np[ MAX_SP ];
@@ -567,16 +1045,16 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
     int sp_max_nm[64], n_dropped_movers   [64];
     #endif
 
-    if ( num_species( sp_list ) > MAX_SP )
-    {
-      ERROR( ( "Update this to support more species." ) );
-    }
-
     LIST_FOR_EACH( sp, sp_list )
     {
       sp_p [ sp->id ] = sp->p;
       sp_pm[ sp->id ] = sp->pm;
       sp_q [ sp->id ] = sp->q;
+
+      // Subcycled species accumulate pushed particles into their held
+      // accumulator.  Particles injected between pushes use aa.
+      sp_a0[ sp->id ] = ( sp->subcycle > 1 && sp->held &&
+                          SPECIES_PUSH_STEP( sp ) ) ? sp->held->a : a0;
       sp_np[ sp->id ] = sp->np;
       sp_nm[ sp->id ] = sp->nm;
 
@@ -592,39 +1070,56 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
     // Inject particles.  We do custom local injection first to
     // increase message overlap opportunities.
 
-    face = 5;
-
-    do
+    for( k = -1; k < n_port; k++ )
     {
-      /**/  particle_t          * RESTRICT ALIGNED(32) p;
+      /**/  particle_block_t    * RESTRICT ALIGNED(32) p;
       /**/  particle_mover_t    * RESTRICT ALIGNED(16) pm;
       const particle_injector_t * RESTRICT ALIGNED(16) pi;
 
       int np, nm, n, id;
 
-      face++;
-
-      if ( face == 7 )
-      {
-        face = 0;
-      }
-
-      if ( face == 6 )
+      if ( k < 0 )
       {
         pi = ci;
         n  = n_ci;
       }
 
-      else if ( shared[ face ] )
+      else if ( peer[ port_list[ k ] ] >= 0 )
       {
+        port = port_list[ k ];
+
         mp_end_recv( mp,
-                     f2b[ face ] );
+                     port );
 
         pi = (const particle_injector_t *)
              ( ( (char *) mp_recv_buffer( mp,
-                                          f2b[ face ] ) ) + 16 );
+                                          port ) ) + 16 );
+
+        n  = n_recv[ port ];
+
+        // Add the current deposited in the local voxels by the
+        // particles the sender routed through them.
+
+        if ( mode == CORNER_EXCHANGE )
+        {
+          const int32_t * header = ( (const int32_t *) pi ) - 4;
+
+          const current_injector_t * RESTRICT cj =
+            (const current_injector_t *) ( pi + header[0] );
 
-        n  = n_recv[ face ];
+          n = header[0];
+
+          for( int m = header[1]; m; m--, cj++ )
+          {
+            float       * RESTRICT a = (float *) ( sp_a0[ cj->sp_id ] + cj->i );
+            const float * RESTRICT b = cj->jx;
+
+            for( int l = 0; l < 12; l++ )
+            {
+              a[l] += b[l];
+            }
+          }
+        }
       }
 
       else
@@ -661,27 +1156,36 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
         }
         #endif
 
-        #ifdef V4_ACCELERATION
+        #if defined(V4_ACCELERATION) && !defined(VPIC_USE_AOSOA_P)
 
         copy_4x1( &p[np].dx, &pi->dx );
         copy_4x1( &p[np].ux, &pi->ux );
 
         #else
 
-        p[np].dx = pi->dx;
-        p[np].dy = pi->dy;
-        p[np].dz = pi->dz;
-        p[np].i  = pi->i;
+        P_ELEM( p, np, dx ) = pi->dx;
+        P_ELEM( p, np, dy ) = pi->dy;
+        P_ELEM( p, np, dz ) = pi->dz;
+        P_ELEM( p, np, i  ) = pi->i;
 
-        p[np].ux = pi->ux;
-        p[np].uy = pi->uy;
-        p[np].uz = pi->uz;
-        p[np].w  = pi->w;
+        P_ELEM( p, np, ux ) = pi->ux;
+        P_ELEM( p, np, uy ) = pi->uy;
+        P_ELEM( p, np, uz ) = pi->uz;
+        P_ELEM( p, np, w  ) = pi->w;
 
         #endif
 
         sp_np[id] = np + 1;
 
+        // A particle the sender moved to its end has no move left.
+        // The v4 move_p could see it cross a face it is on.
+
+        if ( mode == CORNER_EXCHANGE &&
+             pi->dispx == 0 && pi->dispy == 0 && pi->dispz == 0 )
+        {
+          continue;
+        }
+
         #ifdef DISABLE_DYNAMIC_RESIZING
         if ( nm >= sp_max_nm[ id ] )
         {
@@ -706,9 +1210,9 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
 
         #endif
 
-        sp_nm[id] = nm + move_p( p, pm + nm, a0, g, sp_q[id] );
+        sp_nm[id] = nm + move_p( p, pm + nm, sp_a0[id], g, sp_q[id] );
       }
-    } while( face != 5 );
+    }
 
     LIST_FOR_EACH( sp, sp_list )
     {
@@ -733,18 +1237,89 @@ boundary_p( particle_bc_t       * RESTRICT pbc_list,
       }
       #endif
 
+      if ( n_lost[ sp->id ] )
+      {
+        WARNING( ( "Removing %i particles from species \"%s\" that did not "
+                   "reach their domain with the edge and corner exchange.  "
+                   "Check the Courant condition and the particle boundary "
+                   "conditions.",
+                   n_lost[ sp->id ],
+                   sp->name ) );
+      }
+
       sp->np = sp_np[ sp->id ];
       sp->nm = sp_nm[ sp->id ];
     }
 
   } while(0);
 
-  for( face = 0; face < 6; face++ )
+  for( k = 0; k < n_port; k++ )
   {
-    if ( shared[ face ] )
+    port = port_list[ k ];
+
+    if ( peer[ port ] >= 0 )
     {
       mp_end_send( mp,
-                   f2b[ face ] );
+                   port );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper exchange_p function.
+//
+// With the grid's corner_exchange set, the particles leaving the local
+// domain go straight to the face, edge or corner neighbour where they
+// stop, so one call moves them all if they satisfy the Courant
+// condition.  The particles the received ones and the custom boundary
+// conditions push into local boundaries are then handled locally.
+//----------------------------------------------------------------------------//
+
+void
+boundary_p( particle_bc_t       * RESTRICT pbc_list,
+            species_t           * RESTRICT sp_list,
+            field_array_t       * RESTRICT fa,
+            accumulator_array_t * RESTRICT aa )
+{
+  species_t * sp;
+
+  int n, nm;
+
+  // Check input args.
+
+  if ( ! sp_list )
+  {
+    return; // Nothing to do if no species.
+  }
+
+  if ( ! fa                ||
+       ! aa                ||
+       sp_list->g != aa->g ||
+       fa->g      != aa->g )
+  {
+    ERROR( ( "Bad args." ) );
+  }
+
+  if ( ! fa->g->corner_exchange )
+  {
+    exchange_p( pbc_list, sp_list, fa, aa, FACE_EXCHANGE );
+
+    return;
+  }
+
+  exchange_p( pbc_list, sp_list, fa, aa, CORNER_EXCHANGE );
+
+  for( n = 0; n < MAX_LOCAL_EXCHANGE; n++ )
+  {
+    nm = 0;
+
+    LIST_FOR_EACH( sp, sp_list ) nm += sp->nm;
+
+    if ( ! nm )
+    {
+      break;
     }
+
+    exchange_p( pbc_list, sp_list, fa, aa, LOCAL_EXCHANGE );
   }
 }
@@ -33,6 +33,17 @@ typedef int /* Number of particles injected */
 typedef void
 (*delete_particle_bc_func_t)( particle_bc_t * RESTRICT pbc );
 
+/* With the edge and corner exchange, the current a particle deposits
+   in the voxels of another domain on its way to its final voxel is
+   sent to that domain in these. */
+
+typedef struct current_injector {
+  float jx[4], jy[4], jz[4]; /* Current to add to the accumulator */
+  int32_t i;                 /* Local voxel index on the receiver */
+  int32_t sp_id;             /* Species of the depositing particle */
+  int32_t pad[2];            /* Pad to 64 bytes */
+} current_injector_t;
+
 struct particle_bc {
   void * params;
   particle_bc_func_t interact;
@@ -46,7 +46,7 @@ END_C_DECLS
 
 typedef struct langevin_pipeline_args
 {
-  MEM_PTR( particle_t, 128 ) p;
+  MEM_PTR( particle_block_t, 128 ) p;
   MEM_PTR( rng_t,      128 ) rng[ MAX_PIPELINE ];
   float decay; 
   float drive;
@@ -30,19 +30,23 @@ binary_pipeline_scalar( binary_collision_model_t * RESTRICT cm,
   /**/  species_t  * RESTRICT spj           = cm->spj;
   /**/  rng_t      * RESTRICT rng           = cm->rp->rng[ pipeline_rank ];
 
-  /**/  particle_t * RESTRICT spi_p         = spi->p;
+  /**/  particle_block_t * RESTRICT spi_p   = spi->p;
   const int        * RESTRICT spi_partition = spi->partition;
   const grid_t     * RESTRICT g             = spi->g;
 
-  /**/  particle_t * RESTRICT spj_p         = spj->p;
+  /**/  particle_block_t * RESTRICT spj_p   = spj->p;
   const int        * RESTRICT spj_partition = spj->partition;
 
   const double sample        = (spi_p==spj_p ? 0.5 : 1)*cm->sample;
   const float  dtinterval_dV = ( g->dt * (float)cm->interval ) / g->dV;
 
+  particle_t * pk, * pl;
   float pr_norm, pr_coll, wk, wl, w_max, w_min;
   int v, v1, k, k0, nk, rk, l, l0, nl, rl, np, nc, type, n_large_pr = 0;
 
+  DECLARE_PARTICLE_RECORD( pk_rec );
+  DECLARE_PARTICLE_RECORD( pl_rec );
+
   /* Stripe the (mostly non-ghost) voxels over threads for load balance */
 
   v  = VOXEL( 0,0,0,             g->nx,g->ny,g->nz ) + pipeline_rank;
@@ -57,8 +61,8 @@ binary_pipeline_scalar( binary_collision_model_t * RESTRICT cm,
        split the range of the fastest integer rng into intervals
        suitable for sampling pairs. */
 
-    k0 = spi_partition[v  ];
-    nk = spi_partition[v+1] - k0;
+    k0 = spi_partition[ g->sfc[v]   ];
+    nk = spi_partition[ g->sfc[v]+1 ] - k0;
     if( !nk ) continue; /* Nothing to do */
     rk = UINT_MAX / (unsigned)nk;
 
@@ -93,8 +97,8 @@ binary_pipeline_scalar( binary_collision_model_t * RESTRICT cm,
          such that, for sample==1, on average every particle is tested
          for collision at least once. */
 
-      l0 = spj_partition[v  ];
-      nl = spj_partition[v+1] - l0;
+      l0 = spj_partition[ g->sfc[v]   ];
+      nl = spj_partition[ g->sfc[v]+1 ] - l0;
       if( !nl ) continue; /* Nothing to do */
       rl = UINT_MAX / (unsigned)nl;
       np = nk*nl;
@@ -128,11 +132,14 @@ binary_pipeline_scalar( binary_collision_model_t * RESTRICT cm,
          If this probability is bigger than one, make a note for
          diagnostic use. */
 
-      wk = spi_p[k].w;
-      wl = spj_p[l].w;
+      pk = PARTICLE_RECORD( pk_rec, spi_p, k );
+      pl = PARTICLE_RECORD( pl_rec, spj_p, l );
+
+      wk = pk->w;
+      wl = pl->w;
       w_max = (wk>wl) ? wk : wl;
       pr_coll = w_max * pr_norm *
-        rate_constant( params, spi, spj, &spi_p[k], &spj_p[l] );
+        rate_constant( params, spi, spj, pk, pl );
       if( pr_coll>1 ) n_large_pr++;
 
       /* Yes, >= so that 0 rate constants guarantee no collision and
@@ -149,7 +156,10 @@ binary_pipeline_scalar( binary_collision_model_t * RESTRICT cm,
       w_min = (wk>wl) ? wl : wk;
       type = 1; if( wl==w_min ) type++;
       if( w_max==w_min || w_max*frand_c0(rng)<w_min ) type = 3;
-      collision( params, spi, spj, &spi_p[k], &spj_p[l], rng, type );
+      collision( params, spi, spj, pk, pl, rng, type );
+
+      FLUSH_PARTICLE_RECORD( spi_p, k, pk_rec );
+      FLUSH_PARTICLE_RECORD( spj_p, l, pl_rec );
     }
   }
 
@@ -18,7 +18,7 @@ langevin_pipeline_scalar( langevin_pipeline_args_t * RESTRICT args,
     return; /* No host straggler cleanup */
   }
 
-  particle_t * RESTRICT p     = args->p;
+  particle_block_t * RESTRICT p = args->p;
   rng_t      * RESTRICT rng   = args->rng[ pipeline_rank ];
   float                 decay = args->decay;
   float                 drive = args->drive;
@@ -30,9 +30,9 @@ langevin_pipeline_scalar( langevin_pipeline_args_t * RESTRICT args,
 
   for( ; i < i1; i++ )
   {
-    p[i].ux = decay * p[i].ux + drive * frandn(rng);
-    p[i].uy = decay * p[i].uy + drive * frandn(rng);
-    p[i].uz = decay * p[i].uz + drive * frandn(rng);
+    P_ELEM( p, i, ux ) = decay * P_ELEM( p, i, ux ) + drive * frandn(rng);
+    P_ELEM( p, i, uy ) = decay * P_ELEM( p, i, uy ) + drive * frandn(rng);
+    P_ELEM( p, i, uz ) = decay * P_ELEM( p, i, uz ) + drive * frandn(rng);
   }
 }
 
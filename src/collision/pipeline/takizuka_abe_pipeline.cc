@@ -11,17 +11,19 @@
 #define CMOV(a,b) if(t0<t1) a=b
 
 // Branchless and direction-agnositc method for computing momentum transfer.
-#define takizuka_abe_collision(PI,PJ,mu_i,mu_j,std,rng) do {            \
-    particle_t * const RESTRICT pi = (PI);                              \
-    particle_t * const RESTRICT pj = (PJ);                              \
+#define takizuka_abe_collision(PI,KI,PJ,KJ,mu_i,mu_j,std,rng) do {      \
+    particle_block_t * const pi = (PI);                                 \
+    particle_block_t * const pj = (PJ);                                 \
+    const int ki = (KI);                                                \
+    const int kj = (KJ);                                                \
     float dd, ur, urx, ury, urz, tx, ty, tz, t0, t1, t2, wi, wj, stack[3]; \
     int d0, d1, d2;                                                     \
                                                                         \
-    urx = pi->ux - pj->ux;                                              \
-    ury = pi->uy - pj->uy;                                              \
-    urz = pi->uz - pj->uz;                                              \
-    wi  = pi->w;                                                        \
-    wj  = pj->w;                                                        \
+    urx = P_ELEM( pi, ki, ux ) - P_ELEM( pj, kj, ux );                  \
+    ury = P_ELEM( pi, ki, uy ) - P_ELEM( pj, kj, uy );                  \
+    urz = P_ELEM( pi, ki, uz ) - P_ELEM( pj, kj, uz );                  \
+    wi  = P_ELEM( pi, ki, w );                                          \
+    wj  = P_ELEM( pj, kj, w );                                          \
                                                                         \
     /* There are lots of ways to formulate T vector formation    */     \
     /* This has no branches (but uses L1 heavily)                */     \
@@ -68,12 +70,12 @@
     if(wj < wi && wi*t0 > wj) t1 = 0 ;                                  \
     if(wi < wj && wj*t0 > wi) t2 = 0 ;                                  \
                                                                         \
-    pi->ux += t1*stack[0];                                              \
-    pi->uy += t1*stack[1];                                              \
-    pi->uz += t1*stack[2];                                              \
-    pj->ux -= t2*stack[0];                                              \
-    pj->uy -= t2*stack[1];                                              \
-    pj->uz -= t2*stack[2];                                              \
+    P_ELEM( pi, ki, ux ) += t1*stack[0];                                \
+    P_ELEM( pi, ki, uy ) += t1*stack[1];                                \
+    P_ELEM( pi, ki, uz ) += t1*stack[2];                                \
+    P_ELEM( pj, kj, ux ) -= t2*stack[0];                                \
+    P_ELEM( pj, kj, uy ) -= t2*stack[1];                                \
+    P_ELEM( pj, kj, uz ) -= t2*stack[2];                                \
                                                                         \
   } while(0)
 
@@ -88,10 +90,10 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
   /**/  rng_t        * RESTRICT rng           = cm->rp->rng[ pipeline_rank ];
   const grid_t       * RESTRICT g             = spi->g;
 
-  /**/  particle_t   * RESTRICT ALIGNED(128) spi_p         = spi->p;
+  /**/  particle_block_t * RESTRICT ALIGNED(128) spi_p       = spi->p;
   const int          * RESTRICT ALIGNED(128) spi_partition = spi->partition;
 
-  /**/  particle_t   * RESTRICT ALIGNED(128) spj_p         = spj->p;
+  /**/  particle_block_t * RESTRICT ALIGNED(128) spj_p       = spj->p;
   const int          * RESTRICT ALIGNED(128) spj_partition = spj->partition;
 
   const float dtinterval_dV = ( g->dt * (float)cm->interval ) / g->dV;
@@ -117,8 +119,8 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
        split the range of the fastest integer rng into intervals
        suitable for sampling pairs. */
 
-    k0 = spi_partition[v  ];
-    nk = spi_partition[v+1] - k0;
+    k0 = spi_partition[ g->sfc[v]   ];
+    nk = spi_partition[ g->sfc[v]+1 ] - k0;
     if( !nk ) continue; /* Nothing to do */
 
     // Compute the species density for this cell while doing a Fisher-Yates
@@ -129,23 +131,25 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
     for(i=k0 ; i < k1-1 ; ++i){
       rn = UINT32_MAX / (uint32_t)(k1-i);
       do { j = i + (int)(uirand(rng)/rn); } while( j>=k1 );
-      ptemp = spi_p[j], spi_p[j] = spi_p[i], spi_p[i] = ptemp;
-      density_k += spi_p[i].w;
+      LOAD_PARTICLE( ptemp, spi_p, j );
+      COPY_PARTICLE( spi_p, j, spi_p, i );
+      STORE_PARTICLE( spi_p, i, ptemp );
+      density_k += P_ELEM( spi_p, i, w );
     }
-    density_k += spi_p[i].w;
+    density_k += P_ELEM( spi_p, i, w );
 
     if( spi==spj ) {
 
       if( nk%2 && nk >= 3 ) {
         std = sqrtf(0.5*density_k*cvar*dtinterval_dV);
-        takizuka_abe_collision( spi_p + k0,
-                                spi_p + k0 + 1,
+        takizuka_abe_collision( spi_p, k0,
+                                spi_p, k0 + 1,
                                 mu_i, mu_j, std, rng );
-        takizuka_abe_collision( spi_p + k0,
-                                spi_p + k0 + 2,
+        takizuka_abe_collision( spi_p, k0,
+                                spi_p, k0 + 2,
                                 mu_i, mu_j, std, rng );
-        takizuka_abe_collision( spi_p + k0 + 1,
-                                spi_p + k0 + 2,
+        takizuka_abe_collision( spi_p, k0 + 1,
+                                spi_p, k0 + 2,
                                 mu_i, mu_j, std, rng );
         nk -= 3;
         k0 += 3;
@@ -158,8 +162,8 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
 
     } else {
 
-      l0 = spj_partition[v  ];
-      nl = spj_partition[v+1] - l0;
+      l0 = spj_partition[ g->sfc[v]   ];
+      nl = spj_partition[ g->sfc[v]+1 ] - l0;
       if( !nl ) continue; /* Nothing to do */
 
       // Since spi_p is already randomized, setting spi_j to any specific
@@ -169,7 +173,7 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
       // Compute the species density for this cell.
       density_l = 0;
       for(i=0 ; i < nl ; ++i)
-        density_l += spj_p[l0+i].w;
+        density_l += P_ELEM( spj_p, l0+i, w );
 
       // Compute the standard deviation of the collision angle.
       std = sqrtf( cvar*(density_l > density_k ? density_k : density_l)*dtinterval_dV );
@@ -182,14 +186,14 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
 
       for( i=0 ; i < rn ; ++i, ++l0 )
         for( j=0 ; j <= ii ; ++j, ++k0 )
-          takizuka_abe_collision( spi_p + k0,
-                                  spj_p + l0,
+          takizuka_abe_collision( spi_p, k0,
+                                  spj_p, l0,
                                   mu_i, mu_j, std, rng);
 
       for( ; i < nl ; ++i, ++l0 )
         for( j=0 ; j < ii ; ++j, ++k0 )
-          takizuka_abe_collision( spi_p + k0,
-                                  spj_p + l0,
+          takizuka_abe_collision( spi_p, k0,
+                                  spj_p, l0,
                                   mu_i, mu_j, std, rng);
 
     } else {
@@ -199,14 +203,14 @@ takizuka_abe_pipeline_scalar( takizuka_abe_t * RESTRICT cm,
 
       for( i=0 ; i < rn ; ++i, ++k0 )
         for( j=0 ; j <= ii ; ++j, ++l0 )
-          takizuka_abe_collision( spi_p + k0,
-                                  spj_p + l0,
+          takizuka_abe_collision( spi_p, k0,
+                                  spj_p, l0,
                                   mu_i, mu_j, std, rng);
 
       for( ; i < nk ; ++i, ++k0 )
         for( j=0 ; j < ii ; ++j, ++l0 )
-          takizuka_abe_collision( spi_p + k0,
-                                  spj_p + l0,
+          takizuka_abe_collision( spi_p, k0,
+                                  spj_p, l0,
                                   mu_i, mu_j, std, rng);
 
     }
@@ -25,7 +25,7 @@ unary_pipeline_scalar( unary_collision_model_t * RESTRICT cm,
 
   /**/  void       * RESTRICT params = cm->params;
   const species_t  * RESTRICT sp     = cm->sp;
-  /**/  particle_t * RESTRICT p      = cm->sp->p;
+  /**/  particle_block_t * RESTRICT p = cm->sp->p;
   /**/  rng_t      * RESTRICT rng    = cm->rp->rng[ pipeline_rank ];
 
   const float dt = sp->g->dt * (float) cm->interval;
@@ -35,9 +35,12 @@ unary_pipeline_scalar( unary_collision_model_t * RESTRICT cm,
   /**/  int i  = (int) ( 0.5 + n_target * (double)  pipeline_rank    );
   const int i1 = (int) ( 0.5 + n_target * (double) (pipeline_rank+1) );
 
+  particle_t * pi;
   float pr_coll;
   int n_large_pr = 0;
 
+  DECLARE_PARTICLE_RECORD( p_rec );
+
   /* For each computational particle assigned to this pipeline, compute
      the probability a comoving physical particle had collision with
      the background.  If this "probability" is greater than one, make
@@ -46,7 +49,9 @@ unary_pipeline_scalar( unary_collision_model_t * RESTRICT cm,
 
   for( ; i < i1; i++ )
   {
-    pr_coll = dt * rate_constant( params, sp, &p[i] );
+    pi = PARTICLE_RECORD( p_rec, p, i );
+
+    pr_coll = dt * rate_constant( params, sp, pi );
 
     if ( pr_coll > 1 )
     {
@@ -57,7 +62,9 @@ unary_pipeline_scalar( unary_collision_model_t * RESTRICT cm,
        and, yes, _c0, so that 1 probabilities guarantee a collision  */
     if ( frand_c0( rng ) < pr_coll )
     {
-      collision( params, sp, &p[i], rng );
+      collision( params, sp, pi, rng );
+
+      FLUSH_PARTICLE_RECORD( p, i, p_rec );
     }
   }
 
@@ -41,7 +41,7 @@ emit_child_langmuir( child_langmuir_t * RESTRICT              cl,
   /**/  accumulator_t    * RESTRICT ALIGNED(128) a   = cl->aa->a;
   /**/  rng_t            * RESTRICT              rng = cl->rng;
 
-  /**/  particle_t       * RESTRICT ALIGNED(128) p   = sp->p;
+  /**/  particle_block_t * RESTRICT ALIGNED(128) p   = sp->p;
   /**/  particle_mover_t * RESTRICT ALIGNED(128) pm  = sp->pm;
   /**/  grid_t           * RESTRICT              g   = sp->g;
 
@@ -69,6 +69,8 @@ emit_child_langmuir( child_langmuir_t * RESTRICT              cl,
   float w, ux, uy, uz;
   int c, cc, i, np_emit;
 
+  DECLARE_PARTICLE_RECORD( p_rec );
+
   // Loop over all components of the region
 
   for( c=0; c<n_component; c++ ) {
@@ -90,15 +92,15 @@ emit_child_langmuir( child_langmuir_t * RESTRICT              cl,
         u##X = dir ut_para*sqrtf(2*frande(rng));                        \
         u##Y = ut_perp*frandn(rng);                                     \
         u##Z = ut_perp*frandn(rng);                                     \
-        p[np].d##X = -(dir 1);                                          \
-        p[np].d##Y = 2*frand_c0(rng)-1;                                 \
-        p[np].d##Z = 2*frand_c0(rng)-1;                                 \
-        p[np].i    = i;                                                 \
-        p[np].u##X = u##X;                                              \
-        p[np].u##Y = u##Y;                                              \
-        p[np].u##Z = u##Z;                                              \
-        p[np].w    = w;                                                 \
-        accumulate_rhob( f, p+np, g, -qsp );                            \
+        P_ELEM( p, np, d##X ) = -(dir 1);                               \
+        P_ELEM( p, np, d##Y ) = 2*frand_c0(rng)-1;                      \
+        P_ELEM( p, np, d##Z ) = 2*frand_c0(rng)-1;                      \
+        P_ELEM( p, np, i ) = i;                                         \
+        P_ELEM( p, np, u##X ) = u##X;                                   \
+        P_ELEM( p, np, u##Y ) = u##Y;                                   \
+        P_ELEM( p, np, u##Z ) = u##Z;                                   \
+        P_ELEM( p, np, w ) = w;                                         \
+        accumulate_rhob( f, PARTICLE_RECORD( p_rec, p, np ), g, -qsp ); \
         np++;                                                           \
                                                                         \
         /* Age the particle */                                          \
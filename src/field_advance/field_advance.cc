@@ -19,9 +19,12 @@ checkpt_field_advance_kernels( const field_advance_kernels_t * kernel )
   CHECKPT_SYM( kernel->delete_fa                 );
   CHECKPT_SYM( kernel->advance_b                 );
   CHECKPT_SYM( kernel->advance_e                 );
+  CHECKPT_SYM( kernel->advance_fields            );
   CHECKPT_SYM( kernel->energy_f                  );
   CHECKPT_SYM( kernel->clear_jf                  );
   CHECKPT_SYM( kernel->synchronize_jf            );
+  CHECKPT_SYM( kernel->begin_synchronize_jf      );
+  CHECKPT_SYM( kernel->end_synchronize_jf        );
   CHECKPT_SYM( kernel->clear_rhof                );
   CHECKPT_SYM( kernel->synchronize_rho           );
   CHECKPT_SYM( kernel->compute_rhob              );
@@ -41,9 +44,12 @@ restore_field_advance_kernels( field_advance_kernels_t * kernel )
   RESTORE_SYM( kernel->delete_fa                 );
   RESTORE_SYM( kernel->advance_b                 );
   RESTORE_SYM( kernel->advance_e                 );
+  RESTORE_SYM( kernel->advance_fields            );
   RESTORE_SYM( kernel->energy_f                  );
   RESTORE_SYM( kernel->clear_jf                  );
   RESTORE_SYM( kernel->synchronize_jf            );
+  RESTORE_SYM( kernel->begin_synchronize_jf      );
+  RESTORE_SYM( kernel->end_synchronize_jf        );
   RESTORE_SYM( kernel->clear_rhof                );
   RESTORE_SYM( kernel->synchronize_rho           );
   RESTORE_SYM( kernel->compute_rhob              );
@@ -143,12 +143,26 @@
 // should be set in the ghost cells too. Further, these IDs should be
 // consistent with the neighboring domains (if any)!
 
-// FIXME: MATERIAL-LESS FIELD_T SHOULD EVENTUALLY USE ITS OWN FIELD_T
-// WITH MORE COMPACT LAYOUT.
+// When VPIC_USE_VACUUM_FIELDS is defined, field_t has no material ids.
+// The whole domain is then filled with the first material and only the
+// vacuum field advance (see new_vacuum_field_array) is available.  This
+// makes field_t 64 bytes, one cache line per voxel, instead of 80.
 
 // FIXME: SHOULD HAVE DIFFERENT FIELD_T FOR CELL BUILDS AND USE NEW
 // INFRASTRUCTURE
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+
+typedef struct field
+{
+  float ex,   ey,   ez,   div_e_err;     // Electric field and div E error
+  float cbx,  cby,  cbz,  div_b_err;     // Magnetic field and div B error
+  float tcax, tcay, tcaz, rhob;          // TCA fields and bound charge density
+  float jfx,  jfy,  jfz,  rhof;          // Free current and charge density
+} field_t;
+
+#else
+
 typedef struct field
 {
   float ex,   ey,   ez,   div_e_err;     // Electric field and div E error
@@ -159,6 +173,8 @@ typedef struct field
   material_id fmatx, fmaty, fmatz, cmat; // Material at face and cell centers
 } field_t;
 
+#endif
+
 // field_advance_kernels holds all the function pointers to all the
 // kernels used by a specific field_advance instance.
 
@@ -181,6 +197,11 @@ typedef struct field_advance_kernels
   void (*advance_b)( struct field_array * RESTRICT fa, float frac );
   void (*advance_e)( struct field_array * RESTRICT fa, float frac );
 
+  // advance_fields does the advance_b / advance_e / advance_b sequence
+  // of a full time step.  Kernels may fuse the three sweeps.
+
+  void (*advance_fields)( struct field_array * RESTRICT fa );
+
   // Diagnostic interface
   // FIXME: MAY NEED MORE CAREFUL THOUGHT FOR CURVILINEAR SYSTEMS
 
@@ -191,6 +212,15 @@ typedef struct field_advance_kernels
 
   void (*clear_jf       )( struct field_array * RESTRICT fa );
   void (*synchronize_jf )( struct field_array * RESTRICT fa );
+
+  // begin_synchronize_jf / end_synchronize_jf do synchronize_jf in two
+  // halves.  Kernels that do not touch jf (e.g. advance_b) may be
+  // called in between to hide the communication.  Field arrays whose
+  // advance_b communicates do the whole exchange in the first half.
+
+  void (*begin_synchronize_jf)( struct field_array * RESTRICT fa );
+  void (*end_synchronize_jf  )( struct field_array * RESTRICT fa );
+
   void (*clear_rhof     )( struct field_array * RESTRICT fa );
   void (*synchronize_rho)( struct field_array * RESTRICT fa );
 
@@ -217,6 +247,30 @@ typedef struct field_advance_kernels
 
 } field_advance_kernels_t;
 
+// soa_field holds the fields touched every time step (E, cB, TCA and
+// jf) as separate planes of nv floats, each indexed like the field_t
+// array.  Unlike field_t, neighboring voxels along x of one component
+// are adjacent in memory, so the curl stencils of the field advance
+// become unit stride loops along x.  The planes share one allocation;
+// each plane is padded to a multiple of 128 bytes.
+//
+// When in_f is set, the field_t array holds the current values and the
+// planes are stale.  Otherwise, the planes hold the current values of
+// E, cB, TCA and jf and the corresponding members of the field_t array
+// are stale.  The remaining members of field_t (div_e_err, div_b_err,
+// rhob, rhof and material ids) always live in the field_t array.
+
+typedef struct soa_field
+{
+  float * ALIGNED(128) ex,   * ALIGNED(128) ey,   * ALIGNED(128) ez;
+  float * ALIGNED(128) cbx,  * ALIGNED(128) cby,  * ALIGNED(128) cbz;
+  float * ALIGNED(128) tcax, * ALIGNED(128) tcay, * ALIGNED(128) tcaz;
+  float * ALIGNED(128) jfx,  * ALIGNED(128) jfy,  * ALIGNED(128) jfz;
+  float * ALIGNED(128) plane; // Allocation holding all the planes
+  int stride;                 // Number of floats between planes
+  int in_f;                   // Are the field_t values current?
+} soa_field_t;
+
 // A field_array holds all the field quanties and pointers to
 // kernels used to advance them.
 
@@ -225,6 +279,7 @@ typedef struct field_array
   field_t * ALIGNED(128) f;          // Local field data
   grid_t  * g;                       // Underlying grid
   void    * params;                  // Field advance specific parameters
+  soa_field_t * soa;                 // SoA field storage (NULL if none)
   field_advance_kernels_t kernel[1]; // Field advance kernels
 } field_array_t;
 
@@ -235,6 +290,99 @@ new_standard_field_array( grid_t           * RESTRICT g,
                           const material_t * RESTRICT m_list,
                           float                       damp );
 
+// Field array for a domain filled by a single material.  It uses the
+// vacuum field kernels, which never look at the material ids of the
+// field_t.  m_list must hold exactly one material.
+
+field_array_t *
+new_vacuum_field_array( grid_t           * RESTRICT g,
+                        const material_t * RESTRICT m_list,
+                        float                       damp );
+
+// Field array for a domain filled by a single material that keeps E,
+// cB, TCA and jf in soa_field planes during the time step.  It uses
+// the same difference equations as new_vacuum_field_array.  Anything
+// outside the field advance that reads or writes E, cB, TCA or jf
+// through fa->f in the middle of a run must call
+// unload_soa_field_array first (the dumps and the field setting deck
+// macros already do).
+
+field_array_t *
+new_soa_field_array( grid_t           * RESTRICT g,
+                     const material_t * RESTRICT m_list,
+                     float                       damp );
+
+// Field array for a domain filled by a single material with
+// convolutional perfectly matched layers (pml) n_cell cells thick
+// inside the local faces whose field boundary condition is pml_fields.
+// The pml faces must be set before the field array is created.  The
+// layers absorb outgoing waves with a cubic conductivity grading and
+// are terminated by a pec.  Elsewhere it advances the fields like
+// new_vacuum_field_array.
+
+field_array_t *
+new_pml_field_array( grid_t           * RESTRICT g,
+                     const material_t * RESTRICT m_list,
+                     float                       damp,
+                     int                         n_cell );
+
+// Field array for a domain filled by a single material that advances
+// B with the Cole-Karkkainen extended curl of E, which averages each
+// difference over the neighboring voxels in the plane normal to it.
+// This removes the numerical dispersion of waves along the axis of the
+// smallest cell size at c dt = min( dx, dy, dz ), the stability limit,
+// and greatly reduces it in other directions.  The Yee divergence of B
+// is not kept exactly, so div b cleaning should be on.  Elsewhere it
+// advances the fields like new_vacuum_field_array.
+
+field_array_t *
+new_ckc_field_array( grid_t           * RESTRICT g,
+                     const material_t * RESTRICT m_list,
+                     float                       damp );
+
+// Field array for a fully periodic vacuum domain held by a single rank
+// (define_periodic_grid with a 1,1,1 topology) that advances E and cB
+// with the pseudo-spectral analytical time domain (PSATD) method.  The
+// fields are Fourier transformed every step and advanced exactly for a
+// current constant over the step, so there is no numerical dispersion
+// and no Courant limit on dt.  The spectral divergences of E and B are
+// kept, not the Yee ones, so the divergence cleaning intervals should
+// be 0.  cB is advanced with E, so user current injection sees B_0.
+
+field_array_t *
+new_psatd_field_array( grid_t           * RESTRICT g,
+                       const material_t * RESTRICT m_list );
+
+// load_soa_field_array copies E, cB, TCA and jf from the field_t
+// array into the planes and makes the planes current.
+// unload_soa_field_array does the reverse.  Both do nothing if the
+// field array has no SoA storage or the values are already where
+// they are asked for.
+
+void
+load_soa_field_array( field_array_t * RESTRICT fa );
+
+void
+unload_soa_field_array( field_array_t * RESTRICT fa );
+
+// has_yee_advance_b returns nonzero if the field array advances cB with
+// the Yee curl of E and then zeros the normal cB on the local
+// symmetric_fields faces (the standard and vacuum field arrays).
+// Fused kernels outside the field advance can then do advance_b
+// themselves.
+
+int
+has_yee_advance_b( const field_array_t * RESTRICT fa );
+
+// has_standard_synchronize_jf returns nonzero if the field array keeps
+// jf in the field_t array, clears it with clear_jf and exchanges the
+// shared currents with begin_synchronize_jf / end_synchronize_jf.
+// Fused kernels outside the field advance can then unload currents
+// straight into the exchange.
+
+int
+has_standard_synchronize_jf( const field_array_t * RESTRICT fa );
+
 void
 delete_field_array( field_array_t * fa );
 
@@ -20,6 +20,17 @@ advance_e( field_array_t * RESTRICT fa,
     ERROR( ( "standard advance_e does not support frac != 1 yet" ) );
   }
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR( ( "advance_e is not available when VPIC is built with USE_VACUUM_FIELDS" ) );
+#else
   // Conditionally execute this when more abstractions are available.
-  advance_e_pipeline( fa, frac );
+  if ( fa->g->nx == 1 || fa->g->ny == 1 || fa->g->nz == 1 )
+  {
+    advance_e_2d_pipeline( fa, frac );
+  }
+  else
+  {
+    advance_e_pipeline( fa, frac );
+  }
+#endif
 }
@@ -0,0 +1,46 @@
+#define IN_sfa
+
+#include "sfa_private.h"
+
+//----------------------------------------------------------------------------//
+// Reference field step for field arrays without a fused kernel.
+//----------------------------------------------------------------------------//
+
+void
+advance_fields( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  fa->kernel->advance_b( fa, 0.5 );
+  fa->kernel->advance_e( fa, 1.0 );
+  fa->kernel->advance_b( fa, 0.5 );
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper vacuum_advance_fields
+// function.
+//----------------------------------------------------------------------------//
+
+void
+vacuum_advance_fields( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  // The slabs of the wavefront are the z = 2:nz of the 3d interior.  With
+  // only one cell on some axis there are none, so use the 2d kernels.
+
+  if ( fa->g->nx == 1 || fa->g->ny == 1 || fa->g->nz == 1 )
+  {
+    advance_fields( fa );
+  }
+  else
+  {
+    vacuum_advance_fields_pipeline( fa );
+  }
+}
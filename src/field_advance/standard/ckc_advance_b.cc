@@ -0,0 +1,31 @@
+#define IN_sfa
+
+#include "sfa_private.h"
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper ckc_advance_b function.
+//----------------------------------------------------------------------------//
+
+void
+ckc_advance_b( field_array_t * RESTRICT fa,
+               float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  // Conditionally execute this when more abstractions are available.
+  ckc_advance_b_pipeline( fa, frac );
+}
+
+// The shared currents were all exchanged by begin_synchronize_jf.
+
+void
+ckc_end_synchronize_jf( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+}
@@ -14,6 +14,10 @@ clean_div_e( field_array_t * fa )
     ERROR( ( "Bad args" ) );
   }
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR( ( "clean_div_e is not available when VPIC is built with USE_VACUUM_FIELDS" ) );
+#else
   // Conditionally execute this when more abstractions are available.
   clean_div_e_pipeline( fa );
+#endif
 }
@@ -14,6 +14,10 @@ compute_curl_b( field_array_t * RESTRICT fa )
     ERROR( ( "Bad args" ) );
   }
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR( ( "compute_curl_b is not available when VPIC is built with USE_VACUUM_FIELDS" ) );
+#else
   // Conditionally execute this when more abstractions are available.
   compute_curl_b_pipeline( fa );
+#endif
 }
@@ -16,6 +16,10 @@ compute_div_e_err( field_array_t * RESTRICT fa )
     ERROR( ( "Bad args" ) );
   }
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR( ( "compute_div_e_err is not available when VPIC is built with USE_VACUUM_FIELDS" ) );
+#else
   // Conditionally execute this when more abstractions are available.
   compute_div_e_err_pipeline( fa );
+#endif
 }
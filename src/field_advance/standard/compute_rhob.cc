@@ -16,6 +16,10 @@ compute_rhob( field_array_t * RESTRICT fa )
     ERROR( ( "Bad args" ) );
   }
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR( ( "compute_rhob is not available when VPIC is built with USE_VACUUM_FIELDS" ) );
+#else
   // Conditionally execute this when more abstractions are available.
   compute_rhob_pipeline( fa );
+#endif
 }
@@ -17,7 +17,11 @@ energy_f( double * global,
     ERROR( ( "Bad args" ) );
   }
 
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR( ( "energy_f is not available when VPIC is built with USE_VACUUM_FIELDS" ) );
+#else
   // Conditionally execute this when more abstractions are available.
   energy_f_pipeline( global, fa );
+#endif
 }
 
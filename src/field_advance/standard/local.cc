@@ -11,7 +11,7 @@
 /******************************************************************************
  * local.c sets local boundary conditions. Functions are divided into two
  * categories:
- *   local_ghosts_xxx where xxx = tang_b, norm_e, div_b
+ *   local_ghosts_xxx where xxx = tang_b, norm_e, div_b, e
  *   - Sets ghosts values of the fields just interior to a local boundary
  *     condition
  *   local_adjust_xxx where xxx = norm_b, tang_e, rhof, rhob, div_e_err
@@ -43,6 +43,10 @@
 #define y_FACE_LOOP(y) XYZ_LOOP(1,nx,y,y,1,nz)
 #define z_FACE_LOOP(z) XYZ_LOOP(1,nx,1,ny,z,z)
 
+#define x_GHOST_LOOP(x) XYZ_LOOP(x,x,0,ny+1,0,nz+1)
+#define y_GHOST_LOOP(y) XYZ_LOOP(0,nx+1,y,y,0,nz+1)
+#define z_GHOST_LOOP(z) XYZ_LOOP(0,nx+1,0,ny+1,z,z)
+
 /*****************************************************************************
  * Local ghosts
  *****************************************************************************/
@@ -71,7 +75,7 @@ local_ghost_tang_b( field_t      * ALIGNED(128) f,
       ghost = (i+j+k)<0 ? 0 : n##X+1;                                    \
       face  = (i+j+k)<0 ? 1 : n##X+1;                                    \
       switch(bc) {                                                       \
-      case anti_symmetric_fields:                                        \
+      case anti_symmetric_fields: case pml_fields:                       \
 	Z##Y##_EDGE_LOOP(ghost) f(x,y,z).cb##Y= f(x-i,y-j,z-k).cb##Y;    \
 	Y##Z##_EDGE_LOOP(ghost) f(x,y,z).cb##Z= f(x-i,y-j,z-k).cb##Z;    \
 	break;                                                           \
@@ -138,7 +142,7 @@ local_ghost_norm_e( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                              \
       face = (i+j+k)<0 ? 0 : n##X+1;                            \
       switch(bc) {                                              \
-      case anti_symmetric_fields:                               \
+      case anti_symmetric_fields: case pml_fields:              \
 	X##_NODE_LOOP(face) {                                   \
           f0 = &f(x,y,z);                                       \
           f1 = &f(x-i,y-j,z-k);                                 \
@@ -190,7 +194,7 @@ local_ghost_div_b( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                                          \
       face = (i+j+k)<0 ? 0 : n##X+1;					    \
       switch(bc) {							    \
-      case anti_symmetric_fields:					    \
+      case anti_symmetric_fields: case pml_fields:			    \
 	X##_FACE_LOOP(face) f(x,y,z).div_b_err =  f(x-i,y-j,z-k).div_b_err; \
 	break;								    \
       case symmetric_fields: case pmc_fields:				    \
@@ -214,6 +218,61 @@ local_ghost_div_b( field_t      * ALIGNED(128) f,
   APPLY_LOCAL_DIV_B( 0, 0, 1,z,x,y);
 }
 
+// A ghost E is set to t1 times the E one voxel in from it plus t2 times
+// the E two voxels in (n1 and n2 for the normal E).  Tangential E is
+// odd about an anti-symmetric face and even about a symmetric one.
+// Absorbing faces extrapolate linearly as in local_ghost_norm_e.  The
+// faces are done over the whole ghost plane one axis after the other,
+// so the edges and corners are images of ghosts set before.
+
+void
+local_ghost_e( field_t      * ALIGNED(128) f,
+               const grid_t *              g ) {
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  int bc, ghost, x, y, z;
+  float t1, t2, n1, n2;
+  field_t * ALIGNED(16) f0, * ALIGNED(16) f1, * ALIGNED(16) f2;
+
+# define APPLY_LOCAL_GHOST_E(i,j,k,X,Y,Z)                       \
+  do {                                                          \
+    bc = g->bc[BOUNDARY(i,j,k)];                                \
+    if( bc<0 || bc>=world_size ) {                              \
+      ghost = (i+j+k)<0 ? 0 : n##X+1;                           \
+      switch(bc) {                                              \
+      case anti_symmetric_fields: case pml_fields:              \
+        t1 = 0; t2 = -1; n1 =  1; n2 =  0;                      \
+        break;                                                  \
+      case symmetric_fields: case pmc_fields:                   \
+        t1 = 0; t2 =  1; n1 = -1; n2 =  0;                      \
+        break;                                                  \
+      case absorb_fields:                                       \
+        t1 = 2; t2 = -1; n1 =  2; n2 = -1;                      \
+        break;                                                  \
+      default:                                                  \
+	ERROR(("Bad boundary condition encountered."));         \
+	break;                                                  \
+      }                                                         \
+      X##_GHOST_LOOP(ghost) {                                   \
+        f0 = &f(x,y,z);                                         \
+        f1 = &f(x-i,y-j,z-k);                                   \
+        f2 = &f(x-i*2,y-j*2,z-k*2);                             \
+        f0->e##X = n1*f1->e##X + n2*f2->e##X;                   \
+        if( (i+j+k)<0 ) {                                       \
+          f0->e##Y = t1*f1->e##Y + t2*f2->e##Y;                 \
+          f0->e##Z = t1*f1->e##Z + t2*f2->e##Z;                 \
+        }                                                       \
+      }                                                         \
+    }                                                           \
+  } while(0)
+
+  APPLY_LOCAL_GHOST_E((-1), 0, 0,x,y,z);
+  APPLY_LOCAL_GHOST_E( 1, 0, 0,x,y,z);
+  APPLY_LOCAL_GHOST_E( 0,(-1), 0,y,z,x);
+  APPLY_LOCAL_GHOST_E( 0, 1, 0,y,z,x);
+  APPLY_LOCAL_GHOST_E( 0, 0,(-1),z,x,y);
+  APPLY_LOCAL_GHOST_E( 0, 0, 1,z,x,y);
+}
+
 /*****************************************************************************
  * Local adjusts
  *****************************************************************************/
@@ -234,7 +293,7 @@ local_adjust_tang_e( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                                      \
       face = (i+j+k)<0 ? 1 : n##X+1;                                    \
       switch(bc) {                                                      \
-      case anti_symmetric_fields:                                       \
+      case anti_symmetric_fields: case pml_fields:                      \
 	Y##Z##_EDGE_LOOP(face) {                                        \
           fs = &f(x,y,z);                                               \
           fs->e##Y = 0;                                                 \
@@ -275,7 +334,8 @@ local_adjust_norm_b( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                                      \
       face = (i+j+k)<0 ? 1 : n##X+1;                                    \
       switch(bc) {                                                      \
-      case anti_symmetric_fields: case pmc_fields: case absorb_fields:  \
+      case anti_symmetric_fields: case pml_fields:                      \
+      case pmc_fields: case absorb_fields:                              \
 	break;                                                          \
       case symmetric_fields:                                            \
 	X##_FACE_LOOP(face) f(x,y,z).cb##X = 0;                         \
@@ -307,7 +367,8 @@ local_adjust_div_e( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {				 \
       face = (i+j+k)<0 ? 1 : n##X+1;				 \
       switch(bc) {						 \
-      case anti_symmetric_fields: case absorb_fields:		 \
+      case anti_symmetric_fields: case pml_fields:		 \
+      case absorb_fields:					 \
         X##_NODE_LOOP(face) f(x,y,z).div_e_err = 0;              \
         break;                                                   \
       case symmetric_fields: case pmc_fields:			 \
@@ -344,7 +405,7 @@ local_adjust_jf( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                                      \
       face = (i+j+k)<0 ? 1 : n##X+1;                                    \
       switch(bc) {                                                      \
-      case anti_symmetric_fields:                                       \
+      case anti_symmetric_fields: case pml_fields:                      \
 	Y##Z##_EDGE_LOOP(face) f(x,y,z).jf##Y = 0;                      \
         Z##Y##_EDGE_LOOP(face) f(x,y,z).jf##Z = 0;                      \
 	break;                                                          \
@@ -385,7 +446,7 @@ local_adjust_rhof( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                                      \
       face = (i+j+k)<0 ? 1 : n##X+1;                                    \
       switch(bc) {                                                      \
-      case anti_symmetric_fields:                                       \
+      case anti_symmetric_fields: case pml_fields:                      \
 	X##_NODE_LOOP(face) f(x,y,z).rhof = 0;                          \
 	break;                                                          \
       case symmetric_fields: case pmc_fields: case absorb_fields:       \
@@ -423,7 +484,7 @@ local_adjust_rhob( field_t      * ALIGNED(128) f,
     if( bc<0 || bc>=world_size ) {                                      \
       face = (i+j+k)<0 ? 1 : n##X+1;                                    \
       switch(bc) {                                                      \
-      case anti_symmetric_fields:                                       \
+      case anti_symmetric_fields: case pml_fields:                      \
 	X##_NODE_LOOP(face) f(x,y,z).rhob = 0;                          \
 	break;                                                          \
       case symmetric_fields: case pmc_fields: case absorb_fields:       \
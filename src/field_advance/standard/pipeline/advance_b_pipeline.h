@@ -33,11 +33,16 @@ typedef struct pipeline_args
 
 #define f(x,y,z) f[ VOXEL( x, y, z, nx, ny, nz ) ]
 
-#define INIT_STENCIL()  \
-  f0 = &f( x,   y,   z   ); \
-  fx = &f( x+1, y,   z   ); \
-  fy = &f( x,   y+1, z   ); \
-  fz = &f( x,   y,   z+1 )
+// The differences across an axis with one cell have zero coefficients
+// so the neighbor across it is the voxel itself.  This keeps 2d and 1d
+// runs from streaming in a second row or plane of voxels that is never
+// used.
+
+#define INIT_STENCIL()                     \
+  f0 = &f( x,        y,        z        ); \
+  fx = &f( x+(nx>1), y,        z        ); \
+  fy = &f( x,        y+(ny>1), z        ); \
+  fz = &f( x,        y,        z+(nz>1) )
 
 #define NEXT_STENCIL()                      \
   f0++; fx++; fy++; fz++; x++;              \
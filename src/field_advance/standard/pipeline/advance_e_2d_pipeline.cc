@@ -0,0 +1,87 @@
+#define IN_sfa
+#define IN_advance_e_pipeline
+
+// The 2D kernel only has a scalar pipeline.  See advance_e_2d_pipeline.h.
+
+#include "advance_e_pipeline.h"
+
+#include "advance_e_2d_pipeline.h"
+
+#include "../sfa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
+//----------------------------------------------------------------------------//
+// Reference implementation for an advance_e_2d pipeline function.
+//----------------------------------------------------------------------------//
+
+void
+advance_e_2d_pipeline_scalar( pipeline_args_t * args,
+                                     int pipeline_rank,
+                                     int n_pipeline )
+{
+  DECLARE_STENCIL();
+
+  ADVANCE_E_2D_INTERIOR();
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to call the advance_e_2d pipeline.
+//----------------------------------------------------------------------------//
+
+void
+advance_e_2d_pipeline( field_array_t * RESTRICT fa,
+                              float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  if ( frac != 1 )
+  {
+    ERROR( ( "standard advance_e does not support frac != 1 yet" ) );
+  }
+
+  //--------------------------------------------------------------------------//
+  // Begin tangential B ghost setup
+  //--------------------------------------------------------------------------//
+
+  begin_remote_ghost_tang_b( fa->f, fa->g );
+
+  local_ghost_tang_b( fa->f, fa->g );
+
+  //--------------------------------------------------------------------------//
+  // Update interior fields
+  //--------------------------------------------------------------------------//
+
+  pipeline_args_t args[1];
+
+  args->f = fa->f;
+  args->p = (sfa_params_t *) fa->params;
+  args->g = fa->g;
+
+  EXEC_PIPELINES( advance_e_2d, args, 0 );
+
+  WAIT_PIPELINES();
+
+  //--------------------------------------------------------------------------//
+  // Finish tangential B ghost setup
+  //--------------------------------------------------------------------------//
+
+  end_remote_ghost_tang_b( fa->f, fa->g );
+
+  //--------------------------------------------------------------------------//
+  // Update exterior fields
+  //--------------------------------------------------------------------------//
+
+  DECLARE_STENCIL();
+
+  ADVANCE_E_2D_EXTERIOR();
+
+  local_adjust_tang_e( fa->f, fa->g );
+}
+
+#endif
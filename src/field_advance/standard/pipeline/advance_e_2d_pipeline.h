@@ -0,0 +1,111 @@
+#ifndef _advance_e_2d_pipeline_h_
+#define _advance_e_2d_pipeline_h_
+
+#if !defined(IN_advance_e_pipeline) && !defined(IN_vacuum_advance_e_pipeline)
+#error "Only include advance_e_2d_pipeline.h in advance_e_pipeline source files."
+#endif
+
+// Loops shared by advance_e_2d and vacuum_advance_e_2d.  These are for
+// local domains where at least one axis has only one cell.  There, the
+// interior of the 3D kernels (2:n on each axis) is empty and all of E
+// would be updated on the host as exterior fields.
+//
+// The coefficients of differences across an axis with one cell are zero
+// (see DECLARE_STENCIL) so the neighbor across such an axis is taken to
+// be the voxel itself.  The E on both faces normal to that axis then do
+// not need ghosts and are updated with the interior.  The interior box of
+// a component is thus all the cells along the component, 2:n on the other
+// axes with more than one cell and 1:2 on the axes with one cell.  What
+// is left are the faces normal to the other axes.  This includes the
+// DECLARE_STENCIL and UPDATE macros of the including source file.
+
+#define DECLARE_2D_BOX()                                                \
+  const int xl = (nx>1) ? 2 : 1, xh = (nx>1) ? nx : 2;                  \
+  const int yl = (ny>1) ? 2 : 1, yh = (ny>1) ? ny : 2;                  \
+  const int zl = (nz>1) ? 2 : 1, zh = (nz>1) ? nz : 2
+
+#define INIT_2D_STENCIL()                       \
+  f0 = &f( x,        y,        z        );      \
+  fx = &f( x-(nx>1), y,        z        );      \
+  fy = &f( x,        y-(ny>1), z        );      \
+  fz = &f( x,        y,        z-(nz>1) )
+
+#define NEXT_2D_STENCIL(xa,xb,ya,yb)                    \
+  f0++; fx++; fy++; fz++; x++;                          \
+  if ( x > (xb) )                                       \
+  {                                                     \
+                     y++;                  x = (xa);    \
+    if ( y > (yb) ) { z++; y = (ya); }                  \
+    INIT_2D_STENCIL();                                  \
+  }
+
+// Update the box (xa:xb,ya:yb,za:zb) split over the pipelines.
+
+#define UPDATE_2D_BOX(xa,xb,ya,yb,za,zb,UPDATE) do {                    \
+    DISTRIBUTE_VOXELS( xa,xb, ya,yb, za,zb, 16,                         \
+                       pipeline_rank, n_pipeline,                       \
+                       x, y, z, n_voxel );                              \
+    INIT_2D_STENCIL();                                                  \
+    for( ; n_voxel; n_voxel-- )                                         \
+    {                                                                   \
+      UPDATE();                                                         \
+      NEXT_2D_STENCIL( xa,xb, ya,yb );                                  \
+    }                                                                   \
+  } while(0)
+
+// Update the box (xa:xb,ya:yb,za:zb) on the caller.
+
+#define UPDATE_2D_FACE(xa,xb,ya,yb,za,zb,UPDATE) do {                   \
+    for( z = (za); z <= (zb); z++ )                                     \
+      for( y = (ya); y <= (yb); y++ )                                   \
+        for( x = (xa); x <= (xb); x++ )                                 \
+        {                                                               \
+          INIT_2D_STENCIL();                                            \
+          UPDATE();                                                     \
+        }                                                               \
+  } while(0)
+
+#define ADVANCE_E_2D_INTERIOR()                                 \
+  DECLARE_2D_BOX();                                             \
+  int n_voxel;                                                  \
+  UPDATE_2D_BOX( 1,nx,  yl,yh, zl,zh, UPDATE_EX );              \
+  UPDATE_2D_BOX( xl,xh, 1,ny,  zl,zh, UPDATE_EY );              \
+  UPDATE_2D_BOX( xl,xh, yl,yh, 1,nz,  UPDATE_EZ )
+
+// The faces normal to y and z for ex cover the edges on x.  Likewise
+// for ey and ez.
+
+#define ADVANCE_E_2D_EXTERIOR()                                         \
+  DECLARE_2D_BOX();                                                     \
+  if ( ny > 1 )                                                         \
+  {                                                                     \
+    UPDATE_2D_FACE( 1,nx, 1,1,       1,nz+1, UPDATE_EX );               \
+    UPDATE_2D_FACE( 1,nx, ny+1,ny+1, 1,nz+1, UPDATE_EX );               \
+  }                                                                     \
+  if ( nz > 1 )                                                         \
+  {                                                                     \
+    UPDATE_2D_FACE( 1,nx, yl,yh, 1,1,       UPDATE_EX );                \
+    UPDATE_2D_FACE( 1,nx, yl,yh, nz+1,nz+1, UPDATE_EX );                \
+  }                                                                     \
+  if ( nz > 1 )                                                         \
+  {                                                                     \
+    UPDATE_2D_FACE( 1,nx+1, 1,ny, 1,1,       UPDATE_EY );               \
+    UPDATE_2D_FACE( 1,nx+1, 1,ny, nz+1,nz+1, UPDATE_EY );               \
+  }                                                                     \
+  if ( nx > 1 )                                                         \
+  {                                                                     \
+    UPDATE_2D_FACE( 1,1,       1,ny, zl,zh, UPDATE_EY );                \
+    UPDATE_2D_FACE( nx+1,nx+1, 1,ny, zl,zh, UPDATE_EY );                \
+  }                                                                     \
+  if ( nx > 1 )                                                         \
+  {                                                                     \
+    UPDATE_2D_FACE( 1,1,       1,ny+1, 1,nz, UPDATE_EZ );               \
+    UPDATE_2D_FACE( nx+1,nx+1, 1,ny+1, 1,nz, UPDATE_EZ );               \
+  }                                                                     \
+  if ( ny > 1 )                                                         \
+  {                                                                     \
+    UPDATE_2D_FACE( xl,xh, 1,1,       1,nz, UPDATE_EZ );                \
+    UPDATE_2D_FACE( xl,xh, ny+1,ny+1, 1,nz, UPDATE_EZ );                \
+  }
+
+#endif // _advance_e_2d_pipeline_h_
@@ -11,6 +11,8 @@
 
 #include "../../../util/pipelines/pipelines_exec.h"
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
 //----------------------------------------------------------------------------//
 // Reference implementation for an advance_e pipeline function which does not
 // make use of explicit calls to vector intrinsic functions.
@@ -329,3 +331,5 @@ advance_e_pipeline( field_array_t * RESTRICT fa,
 
   local_adjust_tang_e( fa->f, fa->g );
 }
+
+#endif
@@ -0,0 +1,238 @@
+#define IN_sfa
+#define IN_ckc_advance_b_pipeline
+
+// The extended curl only has a scalar pipeline.
+
+#include "ckc_advance_b_pipeline.h"
+
+#include "../sfa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+//----------------------------------------------------------------------------//
+// Cole-Karkkainen weights with the coefficients of Cowan et al. (2013).
+// With rX the squared ratio of the smallest cell size to dX, the X
+// difference has
+//   bXY = rY / 8
+//   gX  = rY rZ ( 1/16 - rY rZ / ( 8 ( rY rZ + rZ rX + rX rY ) ) )
+//   aX  = 1 - 2 bXY - 2 bXZ - 4 gX
+// The waves along the axis of the smallest cell size then have no
+// numerical dispersion at c dt = min( dx, dy, dz ), which is also the
+// stability limit.  Axes with one cell have rX = 0, which gives the 2d
+// and 1d weights.
+//----------------------------------------------------------------------------//
+
+static void
+ckc_weights( pipeline_args_t * args,
+             float frac )
+{
+  const grid_t * g = args->g;
+
+  const float beta = 0.125;
+  const float px   = (g->nx>1) ? frac*g->cvac*g->dt*g->rdx : 0;
+  const float py   = (g->ny>1) ? frac*g->cvac*g->dt*g->rdy : 0;
+  const float pz   = (g->nz>1) ? frac*g->cvac*g->dt*g->rdz : 0;
+
+  float rd = 0, rx, ry, rz, s, gx, gy, gz;
+
+  if ( g->nx > 1 && g->rdx > rd ) rd = g->rdx;
+  if ( g->ny > 1 && g->rdy > rd ) rd = g->rdy;
+  if ( g->nz > 1 && g->rdz > rd ) rd = g->rdz;
+
+  rx = (g->nx>1) ? ( g->rdx / rd ) * ( g->rdx / rd ) : 0;
+  ry = (g->ny>1) ? ( g->rdy / rd ) * ( g->rdy / rd ) : 0;
+  rz = (g->nz>1) ? ( g->rdz / rd ) * ( g->rdz / rd ) : 0;
+  s  = ry*rz + rz*rx + rx*ry;
+
+  gx = ( ry*rz > 0 ) ? ry*rz*( 0.0625f - beta*ry*rz/s ) : 0;
+  gy = ( rz*rx > 0 ) ? rz*rx*( 0.0625f - beta*rz*rx/s ) : 0;
+  gz = ( rx*ry > 0 ) ? rx*ry*( 0.0625f - beta*rx*ry/s ) : 0;
+
+  args->ax  = px*( 1 - 2*beta*ry - 2*beta*rz - 4*gx );
+  args->bxy = px*beta*ry;
+  args->bxz = px*beta*rz;
+  args->gx  = px*gx;
+
+  args->ay  = py*( 1 - 2*beta*rz - 2*beta*rx - 4*gy );
+  args->byz = py*beta*rz;
+  args->byx = py*beta*rx;
+  args->gy  = py*gy;
+
+  args->az  = pz*( 1 - 2*beta*rx - 2*beta*ry - 4*gz );
+  args->bzx = pz*beta*rx;
+  args->bzy = pz*beta*ry;
+  args->gz  = pz*gz;
+}
+
+//----------------------------------------------------------------------------//
+// Reference implementation for a ckc_advance_b pipeline function.
+//----------------------------------------------------------------------------//
+
+void
+ckc_advance_b_pipeline_scalar( pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline )
+{
+  DECLARE_STENCIL();
+
+  int n_voxel;
+
+  DISTRIBUTE_VOXELS( 1,nx, 1,ny, 1,nz, 16,
+                     pipeline_rank, n_pipeline,
+                     x, y, z, n_voxel );
+
+  INIT_STENCIL();
+
+  for( ; n_voxel; n_voxel-- )
+  {
+    UPDATE_CBX();
+    UPDATE_CBY();
+    UPDATE_CBZ();
+
+    NEXT_STENCIL();
+  }
+}
+
+//----------------------------------------------------------------------------//
+// The extended curl of the normal B on a far face reaches the nodes past
+// it.  On local faces, the tangential E there is i1 times that on the
+// face plus i2 times that on the nodes before (see local_ghost_e), which
+// folds the average along the normal t onto the side before the face.
+//----------------------------------------------------------------------------//
+
+#define FCKC(c,s,a,t,bt,u,bu,g)                                         \
+  ( ( a + bt*i1 )*D(c,s,0) + bt*( 1 + i2 )*D(c,s,-(t))                  \
+    + ( bu + g*i1 )*( D(c,s,u) + D(c,s,-(u)) )                          \
+    + g*( 1 + i2 )*( D(c,s,u-(t)) + D(c,s,-(t)-(u)) ) )
+
+#define UPDATE_FAR_CBX() f0->cbx -= ( FCKC(ez,sy,ay,sx,byx,sz,byz,gy) - \
+                                      FCKC(ey,sz,az,sx,bzx,sy,bzy,gz) )
+#define UPDATE_FAR_CBY() f0->cby -= ( FCKC(ex,sz,az,sy,bzy,sx,bzx,gz) - \
+                                      FCKC(ez,sx,ax,sy,bxy,sz,bxz,gx) )
+#define UPDATE_FAR_CBZ() f0->cbz -= ( FCKC(ey,sx,ax,sz,bxz,sy,bxy,gx) - \
+                                      FCKC(ex,sy,ay,sz,byz,sx,byx,gy) )
+
+static int
+far_face_image( const grid_t * g,
+                int boundary,
+                float * i1,
+                float * i2 )
+{
+  const int bc = g->bc[ boundary ];
+
+  if ( bc >= 0 && bc < world_size )
+  {
+    return 0;
+  }
+
+  switch( bc )
+  {
+  case anti_symmetric_fields: case pml_fields:
+    *i1 = 0; *i2 = -1;
+    break;
+
+  case symmetric_fields: case pmc_fields:
+    *i1 = 0; *i2 =  1;
+    break;
+
+  case absorb_fields:
+    *i1 = 2; *i2 = -1;
+    break;
+
+  default:
+    ERROR( ( "Bad boundary condition encountered." ) );
+    break;
+  }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to call the ckc_advance_b pipeline.
+//----------------------------------------------------------------------------//
+
+void
+ckc_advance_b_pipeline( field_array_t * RESTRICT fa,
+                        float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  pipeline_args_t args[1];
+
+  args->f = fa->f;
+  args->g = fa->g;
+
+  ckc_weights( args, frac );
+
+  // The extended curl reaches one voxel past the B on all sides.
+
+  remote_ghost_e( fa->f, fa->g );
+
+  local_ghost_e( fa->f, fa->g );
+
+  // Do the bulk of the magnetic fields in the pipelines.
+
+  EXEC_PIPELINES( ckc_advance_b, args, 0 );
+
+  // While the pipelines are busy, do the normal B on the far faces
+  // with local boundary conditions.
+
+  DECLARE_STENCIL();
+
+  float i1, i2;
+
+  if ( far_face_image( g, BOUNDARY( 1, 0, 0 ), &i1, &i2 ) )
+  {
+    for( z = 1; z <= nz; z++ )
+    {
+      for( y = 1; y <= ny; y++ )
+      {
+        f0 = &f( nx+1, y, z );
+
+        UPDATE_FAR_CBX();
+      }
+    }
+  }
+
+  if ( far_face_image( g, BOUNDARY( 0, 1, 0 ), &i1, &i2 ) )
+  {
+    for( z = 1; z <= nz; z++ )
+    {
+      f0 = &f( 1, ny+1, z );
+
+      for( x = 1; x <= nx; x++ )
+      {
+        UPDATE_FAR_CBY();
+
+        f0++;
+      }
+    }
+  }
+
+  if ( far_face_image( g, BOUNDARY( 0, 0, 1 ), &i1, &i2 ) )
+  {
+    for( y = 1; y <= ny; y++ )
+    {
+      f0 = &f( 1, y, nz+1 );
+
+      for( x = 1; x <= nx; x++ )
+      {
+        UPDATE_FAR_CBZ();
+
+        f0++;
+      }
+    }
+  }
+
+  WAIT_PIPELINES();
+
+  // The far faces shared with other domains get their normal B from
+  // there.
+
+  remote_far_norm_b( f, g );
+
+  local_adjust_norm_b( f, g );
+}
@@ -0,0 +1,82 @@
+#ifndef _ckc_advance_b_pipeline_h_
+#define _ckc_advance_b_pipeline_h_
+
+#ifndef IN_ckc_advance_b_pipeline
+#error "Only include ckc_advance_b_pipeline.h in ckc_advance_b_pipeline source files."
+#endif
+
+#include "../../field_advance.h"
+
+// With (X,Y,Z) a cyclic permutation of (x,y,z), the X difference in the
+// curl of E is averaged over the voxels around it in the plane normal to
+// X.  aX is the weight of the difference itself, bXY that of the two
+// displaced one voxel along Y and gX that of the four displaced along
+// both Y and Z.  The weights already include frac c dt / dX.
+
+typedef struct pipeline_args
+{
+  field_t      * ALIGNED(128) f;
+  const grid_t *              g;
+  float ax, bxy, bxz, gx;
+  float ay, byz, byx, gy;
+  float az, bzx, bzy, gz;
+} pipeline_args_t;
+
+#define DECLARE_STENCIL()                                               \
+        field_t * ALIGNED(128) f = args->f;                             \
+  const grid_t  *              g = args->g;                             \
+                                                                        \
+  const int nx = g->nx, ny = g->ny, nz = g->nz;                         \
+  const int sx = 1, sy = nx + 2, sz = sy * ( ny + 2 );                  \
+                                                                        \
+  const float ax = args->ax, bxy = args->bxy, bxz = args->bxz;          \
+  const float ay = args->ay, byz = args->byz, byx = args->byx;          \
+  const float az = args->az, bzx = args->bzx, bzy = args->bzy;          \
+  const float gx = args->gx, gy  = args->gy,  gz  = args->gz;           \
+                                                                        \
+  field_t * ALIGNED(16) f0;                                             \
+  int x, y, z
+
+#define f(x,y,z) f[ VOXEL( x, y, z, nx, ny, nz ) ]
+
+#define INIT_STENCIL() f0 = &f( x, y, z )
+
+#define NEXT_STENCIL()                      \
+  f0++; x++;                                \
+  if ( x > nx )                             \
+  {                                         \
+                  y++;               x = 1; \
+    if ( y > ny ) { z++; y = 1; }           \
+    INIT_STENCIL();                         \
+  }
+
+// Difference of component c along the stride s at the voxel o away
+// from f0.
+
+#define D(c,s,o) ( f0[(o)+(s)].c - f0[(o)].c )
+
+// Difference of component c along the stride s averaged over the
+// voxels displaced by the strides t and u.
+
+#define CKC(c,s,a,t,bt,u,bu,g)                                          \
+  ( a*D(c,s,0) + bt*( D(c,s,t)   + D(c,s,-(t)) )                        \
+               + bu*( D(c,s,u)   + D(c,s,-(u)) )                        \
+               + g *( D(c,s,t+u) + D(c,s,t-(u)) +                       \
+                      D(c,s,u-(t)) + D(c,s,-(t)-(u)) ) )
+
+// See advance_b_pipeline.h for why -fno-unsafe-math-optimizations
+// must be used.
+
+#define UPDATE_CBX() f0->cbx -= ( CKC(ez,sy,ay,sz,byz,sx,byx,gy) -      \
+                                  CKC(ey,sz,az,sx,bzx,sy,bzy,gz) )
+#define UPDATE_CBY() f0->cby -= ( CKC(ex,sz,az,sx,bzx,sy,bzy,gz) -      \
+                                  CKC(ez,sx,ax,sy,bxy,sz,bxz,gx) )
+#define UPDATE_CBZ() f0->cbz -= ( CKC(ey,sx,ax,sy,bxy,sz,bxz,gx) -      \
+                                  CKC(ex,sy,ay,sz,byz,sx,byx,gy) )
+
+void
+ckc_advance_b_pipeline_scalar( pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline );
+
+#endif // _ckc_advance_b_pipeline_h_
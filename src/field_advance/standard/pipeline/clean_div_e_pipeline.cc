@@ -1,6 +1,8 @@
 #define IN_sfa
 #define IN_clean_div_e_pipeline
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
 #include "clean_div_e_pipeline.h"
 
 #include "../sfa_private.h"
@@ -114,3 +116,4 @@ clean_div_e_pipeline( field_array_t * fa )
   local_adjust_tang_e( fa->f, fa->g );
 }
 
+#endif
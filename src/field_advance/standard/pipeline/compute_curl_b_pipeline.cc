@@ -11,6 +11,8 @@
 
 #include "../../../util/pipelines/pipelines_exec.h"
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
 //----------------------------------------------------------------------------//
 // Reference implementation for a compute_curl_b pipeline function which does
 // not make use of explicit calls to vector intrinsic functions.
@@ -325,3 +327,5 @@ compute_curl_b_pipeline( field_array_t * RESTRICT fa )
 
   local_adjust_tang_e( fa->f, fa->g );
 }
+
+#endif
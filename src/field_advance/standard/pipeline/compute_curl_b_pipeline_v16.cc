@@ -5,7 +5,7 @@
 
 #include "../sfa_private.h"
 
-#if defined(V16_ACCELERATION)
+#if defined(V16_ACCELERATION) && !defined(VPIC_USE_VACUUM_FIELDS)
 
 using namespace v16;
 
@@ -5,7 +5,7 @@
 
 #include "../sfa_private.h"
 
-#if defined(V8_ACCELERATION)
+#if defined(V8_ACCELERATION) && !defined(VPIC_USE_VACUUM_FIELDS)
 
 using namespace v8;
 
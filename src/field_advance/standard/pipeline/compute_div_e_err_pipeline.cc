@@ -9,6 +9,8 @@
 
 #include "../../../util/pipelines/pipelines_exec.h"
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
 void
 compute_div_e_err_pipeline_scalar( pipeline_args_t * args,
                                    int pipeline_rank,
@@ -171,3 +173,5 @@ compute_div_e_err_pipeline( field_array_t * RESTRICT fa )
 
   local_adjust_div_e( fa->f, fa->g );
 }
+
+#endif
@@ -9,6 +9,8 @@
 
 #include "../../../util/pipelines/pipelines_exec.h"
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
 void
 compute_rhob_pipeline_scalar( pipeline_args_t * args,
                               int pipeline_rank,
@@ -172,3 +174,5 @@ compute_rhob_pipeline( field_array_t * RESTRICT fa )
 
   local_adjust_rhob( fa->f, fa->g );
 }
+
+#endif
@@ -9,6 +9,8 @@
 
 #include "../../../util/pipelines/pipelines_exec.h"
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
+
 void
 energy_f_pipeline_scalar( pipeline_args_t * args,
                           int pipeline_rank,
@@ -93,3 +95,5 @@ energy_f_pipeline( double * global,
 
   mp_allsum_d( args->en[0], global, 6 );
 }
+
+#endif
@@ -0,0 +1,437 @@
+#define IN_sfa
+#define IN_psatd_advance_e_pipeline
+
+// The spectral solver only has a scalar pipeline.
+
+#include "psatd_advance_e_pipeline.h"
+
+#include "../sfa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+#include <stddef.h>
+
+//----------------------------------------------------------------------------//
+// Complex arithmetic
+//----------------------------------------------------------------------------//
+
+static inline psatd_complex_t
+cmplx( double re,
+       double im )
+{
+  psatd_complex_t a;
+  a.re = re;
+  a.im = im;
+  return a;
+}
+
+static inline psatd_complex_t
+cadd( psatd_complex_t a,
+      psatd_complex_t b )
+{
+  return cmplx( a.re + b.re, a.im + b.im );
+}
+
+static inline psatd_complex_t
+csub( psatd_complex_t a,
+      psatd_complex_t b )
+{
+  return cmplx( a.re - b.re, a.im - b.im );
+}
+
+static inline psatd_complex_t
+cmul( psatd_complex_t a,
+      psatd_complex_t b )
+{
+  return cmplx( a.re*b.re - a.im*b.im, a.re*b.im + a.im*b.re );
+}
+
+static inline psatd_complex_t
+cscale( psatd_complex_t a,
+        double s )
+{
+  return cmplx( s*a.re, s*a.im );
+}
+
+// o = a x b and a . b without conjugation
+
+static inline void
+ccross( psatd_complex_t       * o,
+        const psatd_complex_t * a,
+        const psatd_complex_t * b )
+{
+  o[0] = csub( cmul( a[1], b[2] ), cmul( a[2], b[1] ) );
+  o[1] = csub( cmul( a[2], b[0] ), cmul( a[0], b[2] ) );
+  o[2] = csub( cmul( a[0], b[1] ), cmul( a[1], b[0] ) );
+}
+
+static inline psatd_complex_t
+cdot( const psatd_complex_t * a,
+      const psatd_complex_t * b )
+{
+  return cadd( cadd( cmul( a[0], b[0] ), cmul( a[1], b[1] ) ),
+               cmul( a[2], b[2] ) );
+}
+
+//----------------------------------------------------------------------------//
+// Mixed radix FFT.  out[k] = sum_j in[j*stride] w^(j k) for the n point
+// line, where w^j = tw[j*tw_stride] (sign < 0) or its conjugate (sign >
+// 0).  The line is split on its smallest prime factor p into p
+// interleaved lines whose transforms are combined with a p point DFT,
+// so any n works and powers of small primes are fast.  t is scratch
+// for n complex.
+//----------------------------------------------------------------------------//
+
+static void
+fft( const psatd_complex_t * in,
+     int stride,
+     psatd_complex_t * out,
+     int n,
+     const psatd_complex_t * tw,
+     int tw_stride,
+     int sign,
+     psatd_complex_t * t )
+{
+  psatd_complex_t w, s;
+  int p, m, r, q, k;
+
+  if ( n == 1 )
+  {
+    out[0] = in[0];
+    return;
+  }
+
+  for( p = 2; p*p <= n && n%p; p++ ) ;
+  if ( n%p ) p = n;
+  m = n/p;
+
+  for( r = 0; r < p; r++ )
+  {
+    fft( in + r*stride, stride*p, out + r*m, m, tw, tw_stride*p, sign, t );
+  }
+
+  for( k = 0; k < m; k++ )
+  {
+    for( r = 0; r < p; r++ )
+    {
+      w = tw[ r*k*tw_stride ];
+      if ( sign > 0 ) w.im = -w.im;
+      t[r] = cmul( out[ r*m + k ], w );
+    }
+
+    for( q = 0; q < p; q++ )
+    {
+      s = t[0];
+      for( r = 1; r < p; r++ )
+      {
+        w = tw[ ( (r*q)%p )*m*tw_stride ];
+        if ( sign > 0 ) w.im = -w.im;
+        s = cadd( s, cmul( t[r], w ) );
+      }
+      out[ q*m + k ] = s;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Line stages
+//----------------------------------------------------------------------------//
+
+static const size_t component[ N_LOAD ] = {
+  offsetof( field_t, ex  ), offsetof( field_t, ey  ), offsetof( field_t, ez  ),
+  offsetof( field_t, cbx ), offsetof( field_t, cby ), offsetof( field_t, cbz ),
+  offsetof( field_t, jfx ), offsetof( field_t, jfy ), offsetof( field_t, jfz )
+};
+
+#define COMPONENT(f0,c) ( *(float *)( (char *)(f0) + component[c] ) )
+
+// Transform the lines along the x axis.  The lines are loaded from the
+// owned voxels of the field_t array (load_x) or stored back into them
+// with the 1 / ( nx ny nz ) normalization of the inverse (store_x).
+
+static void
+transform_x( pipeline_args_t * args,
+             int pipeline_rank,
+             int n_pipeline )
+{
+  field_t     * ALIGNED(128) f     = args->f;
+  sfa_psatd_t *              psatd = args->psatd;
+  const int nx = psatd->n[0], ny = psatd->n[1], nz = psatd->n[2];
+  const int store = args->stage == store_x;
+  const int n_c = store ? N_STORE : N_LOAD;
+  const double rn = 1./( (double)nx*(double)ny*(double)nz );
+
+  psatd_complex_t * in  = psatd->line + 3*psatd->n_max*pipeline_rank;
+  psatd_complex_t * out = in  + psatd->n_max;
+  psatd_complex_t * t   = out + psatd->n_max;
+  psatd_complex_t * s;
+  field_t * f0;
+  int l0, n_line, l, c, x, y, z;
+
+  DISTRIBUTE( ny*nz, 1, pipeline_rank, n_pipeline, l0, n_line );
+
+  for( l = l0; l < l0 + n_line; l++ )
+  {
+    y = l%ny + 1;
+    z = l/ny + 1;
+    f0 = &f( 1, y, z );
+
+    for( c = 0; c < n_c; c++ )
+    {
+      s = SPECTRUM( c ) + l*nx;
+
+      if ( store )
+      {
+        fft( s, 1, out, nx, psatd->tw[0], 1, 1, t );
+        for( x = 0; x < nx; x++ ) COMPONENT( f0 + x, c ) = rn*out[x].re;
+      }
+      else
+      {
+        for( x = 0; x < nx; x++ ) in[x] = cmplx( COMPONENT( f0 + x, c ), 0 );
+        fft( in, 1, s, nx, psatd->tw[0], 1, -1, t );
+      }
+    }
+  }
+}
+
+// Transform the lines along the y (a = 1) or z (a = 2) axis of the
+// spectra in place.
+
+static void
+transform_yz( pipeline_args_t * args,
+              int a,
+              int pipeline_rank,
+              int n_pipeline )
+{
+  sfa_psatd_t * psatd = args->psatd;
+  const int nx = psatd->n[0], ny = psatd->n[1], nz = psatd->n[2];
+  const int n = psatd->n[a];
+  const int sign = ( args->stage < advance ) ? -1 : 1;
+  const int n_c = ( sign < 0 ) ? N_LOAD : N_STORE;
+  const int stride = ( a == 1 ) ? nx : nx*ny;
+
+  psatd_complex_t * out = psatd->line + 3*psatd->n_max*pipeline_rank;
+  psatd_complex_t * t   = out + psatd->n_max;
+  psatd_complex_t * s;
+  int l0, n_line, l, c, j;
+
+  if ( n == 1 )
+  {
+    return;
+  }
+
+  DISTRIBUTE( nx*ny*nz/n, 1, pipeline_rank, n_pipeline, l0, n_line );
+
+  for( l = l0; l < l0 + n_line; l++ )
+  {
+    for( c = 0; c < n_c; c++ )
+    {
+      s = SPECTRUM( c ) + ( ( a == 1 ) ? l%nx + nx*ny*( l/nx ) : l );
+
+      fft( s, stride, out, n, psatd->tw[a], 1, sign, t );
+      for( j = 0; j < n; j++ ) s[ j*stride ] = out[j];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Mode stage.  With D+ and D- the spectral derivatives of the E to cB
+// and cB to E differences, k^2 = -D+ . D- and Dy the Yee backward
+// difference, a mode advances over h = frac dt by
+//   E' = E - ( 1 - C ) PT E + ( S / k ) D- x cB
+//          - ( S / ( c k eps0 ) ) PT J + ( h / eps0 ) D+ ( Dy . J ) / k^2
+//   cB' = cB - ( 1 - C ) QT cB - ( S / k ) D+ x E
+//          + ( ( 1 - C ) / ( c k^2 eps0 ) ) D+ x J
+// where C = cos( c k h ), S = sin( c k h ), PT = D- x D+ x / k^2 and
+// QT = D+ x D- x / k^2 are the transverse projections of E and cB and
+// the last term of E' is the longitudinal part of the corrected J.
+// The uniform mode has E' = E - ( h / eps0 ) J.
+//----------------------------------------------------------------------------//
+
+static void
+advance_modes( pipeline_args_t * args,
+               int pipeline_rank,
+               int n_pipeline )
+{
+  sfa_psatd_t  * psatd = args->psatd;
+  const grid_t * g     = args->g;
+  const int nx = psatd->n[0], ny = psatd->n[1], nz = psatd->n[2];
+  const double h    = args->frac*g->dt;
+  const double c    = g->cvac;
+  const double reps = 1./g->eps0;
+
+  psatd_complex_t * ALIGNED(16) s[ N_LOAD ];
+  psatd_complex_t e[3], b[3], j[3], dp[3], dm[3], dy[3];
+  psatd_complex_t u[3], v[3], pe[3], pj[3], qb[3], ce[3], cb[3], cj[3];
+  psatd_complex_t dyj;
+  double k2, k, cs, sn, a0, a1, a2, a3, a4;
+  int v0, n_mode, m, i, x, y, z;
+
+  for( i = 0; i < N_LOAD; i++ ) s[i] = SPECTRUM( i );
+
+  DISTRIBUTE( nx*ny*nz, 1, pipeline_rank, n_pipeline, v0, n_mode );
+
+  for( m = v0; m < v0 + n_mode; m++ )
+  {
+    x = m%nx;
+    y = ( m/nx )%ny;
+    z = m/( nx*ny );
+
+    for( i = 0; i < 3; i++ )
+    {
+      e[i] = s[i  ][m];
+      b[i] = s[i+3][m];
+      j[i] = s[i+6][m];
+    }
+
+    dp[0] = psatd->dp[0][x]; dy[0] = psatd->dy[0][x];
+    dp[1] = psatd->dp[1][y]; dy[1] = psatd->dy[1][y];
+    dp[2] = psatd->dp[2][z]; dy[2] = psatd->dy[2][z];
+
+    k2 = 0;
+    for( i = 0; i < 3; i++ )
+    {
+      dm[i] = cmplx( -dp[i].re, dp[i].im );
+      k2   += dp[i].re*dp[i].re + dp[i].im*dp[i].im;
+    }
+
+    if ( k2 == 0 )
+    {
+      for( i = 0; i < 3; i++ ) s[i][m] = csub( e[i], cscale( j[i], h*reps ) );
+      continue;
+    }
+
+    k  = sqrt( k2 );
+    cs = cos( c*k*h );
+    sn = sin( c*k*h );
+
+    ccross( u, dp, e ); ccross( pe, dm, u );   // k^2 PT E
+    ccross( u, dp, j ); ccross( pj, dm, u );   // k^2 PT J
+    ccross( v, dm, b ); ccross( qb, dp, v );   // k^2 QT cB
+    ccross( cb, dm, b );
+    ccross( ce, dp, e );
+    ccross( cj, dp, j );
+    dyj = cdot( dy, j );
+
+    a0 = ( 1 - cs )/k2;
+    a1 = sn/k;
+    a2 = sn*reps/( c*k*k2 );
+    a3 = h*reps/k2;
+    a4 = ( 1 - cs )*reps/( c*k2 );
+
+    for( i = 0; i < 3; i++ )
+    {
+      s[i  ][m] = cadd( csub( cadd( csub( e[i], cscale( pe[i], a0 ) ),
+                                    cscale( cb[i], a1 ) ),
+                              cscale( pj[i], a2 ) ),
+                        cscale( cmul( dp[i], dyj ), a3 ) );
+      s[i+3][m] = cadd( csub( csub( b[i], cscale( qb[i], a0 ) ),
+                              cscale( ce[i], a1 ) ),
+                        cscale( cj[i], a4 ) );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Reference implementation for a psatd_advance_e pipeline function.
+//----------------------------------------------------------------------------//
+
+void
+psatd_advance_e_pipeline_scalar( pipeline_args_t * args,
+                                 int pipeline_rank,
+                                 int n_pipeline )
+{
+  switch( args->stage )
+  {
+  case load_x:
+  case store_x:
+    transform_x( args, pipeline_rank, n_pipeline );
+    break;
+
+  case fft_y:
+  case ifft_y:
+    transform_yz( args, 1, pipeline_rank, n_pipeline );
+    break;
+
+  case fft_z:
+  case ifft_z:
+    transform_yz( args, 2, pipeline_rank, n_pipeline );
+    break;
+
+  case advance:
+    advance_modes( args, pipeline_rank, n_pipeline );
+    break;
+
+  default:
+    ERROR( ( "Bad stage" ) );
+    break;
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to call the psatd_advance_e pipeline.
+//----------------------------------------------------------------------------//
+
+void
+psatd_advance_e_pipeline( field_array_t * RESTRICT fa,
+                          float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  static const int stage[7] = {
+    load_x, fft_y, fft_z, advance, ifft_z, ifft_y, store_x
+  };
+
+  pipeline_args_t args[1];
+
+  args->f     = fa->f;
+  args->psatd = ( (sfa_params_t *) fa->params )->psatd;
+  args->g     = fa->g;
+  args->frac  = frac;
+
+  for( int i = 0; i < 7; i++ )
+  {
+    args->stage = stage[i];
+
+    EXEC_PIPELINES( psatd_advance_e, args, 0 );
+
+    WAIT_PIPELINES();
+  }
+
+  //--------------------------------------------------------------------------//
+  // The local domain is periodic on itself, so the ghosts and the far
+  // faces are copies of the owned voxels on the opposite side.
+  //--------------------------------------------------------------------------//
+
+  field_t * ALIGNED(128) f = fa->f;
+  const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;
+  int x, y, z;
+
+# define COPY_E_B( d, s )                                             \
+  d->ex  = s->ex;  d->ey  = s->ey;  d->ez  = s->ez;                   \
+  d->cbx = s->cbx; d->cby = s->cby; d->cbz = s->cbz
+
+# define WRAP( X, Y, Z, ya, yb, za, zb ) do {                         \
+    field_t * fl, * fh;                                               \
+    for( Z = (za); Z <= (zb); Z++ )                                   \
+      for( Y = (ya); Y <= (yb); Y++ )                                 \
+      {                                                               \
+        X = 0;       fl = &f( x, y, z );                              \
+        X = n##X;    fh = &f( x, y, z );                              \
+        COPY_E_B( fl, fh );                                           \
+        X = n##X+1;  fh = &f( x, y, z );                              \
+        X = 1;       fl = &f( x, y, z );                              \
+        COPY_E_B( fh, fl );                                           \
+      }                                                               \
+  } while(0)
+
+  WRAP( x, y, z, 1, ny,   1, nz   );
+  WRAP( y, z, x, 1, nz,   0, nx+1 );
+  WRAP( z, x, y, 0, nx+1, 0, ny+1 );
+
+# undef WRAP
+# undef COPY_E_B
+}
@@ -0,0 +1,50 @@
+#ifndef _psatd_advance_e_pipeline_h_
+#define _psatd_advance_e_pipeline_h_
+
+#ifndef IN_psatd_advance_e_pipeline
+#error "Only include psatd_advance_e_pipeline.h in psatd_advance_e_pipeline source files."
+#endif
+
+#include "../sfa_private.h"
+
+// The pipelines are run in stages.  The line stages transform the
+// lines of the spectra along one axis, split over the pipelines.  The
+// first x stage loads the lines from the field_t array and the last
+// one stores them back.  The mode stage advances the modes.
+
+enum psatd_advance_e_stage
+{
+  load_x   = 0,
+  fft_y    = 1,
+  fft_z    = 2,
+  advance  = 3,
+  ifft_z   = 4,
+  ifft_y   = 5,
+  store_x  = 6
+};
+
+typedef struct pipeline_args
+{
+        field_t     * ALIGNED(128) f;
+        sfa_psatd_t *              psatd;
+  const grid_t      *              g;
+  float frac;
+  int stage;
+} pipeline_args_t;
+
+// The spectra are ex, ey, ez, cbx, cby, cbz, jfx, jfy and jfz.  Only E
+// and cB come back.
+
+#define N_LOAD  9
+#define N_STORE 6
+
+#define f(x,y,z) f[ VOXEL( x, y, z, nx, ny, nz ) ]
+
+#define SPECTRUM(s) ( psatd->c + (s)*nx*ny*nz )
+
+void
+psatd_advance_e_pipeline_scalar( pipeline_args_t * args,
+                                 int pipeline_rank,
+                                 int n_pipeline );
+
+#endif // _psatd_advance_e_pipeline_h_
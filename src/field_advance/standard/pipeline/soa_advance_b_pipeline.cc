@@ -0,0 +1,107 @@
+#define IN_sfa
+#define IN_soa_advance_b_pipeline
+
+#include "soa_advance_b_pipeline.h"
+
+#include "../sfa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+//----------------------------------------------------------------------------//
+// The pipelines update whole rows along x.  There are no explicit v4, v8
+// or v16 versions; the row loops are unit stride and are vectorized by
+// the compiler.
+//----------------------------------------------------------------------------//
+
+void
+soa_advance_b_pipeline_scalar( pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline )
+{
+  DECLARE_STENCIL();
+
+  int r, n_row, v;
+
+  // Rows are y = 1:ny, z = 1:nz
+
+  DISTRIBUTE( ny*nz, 1, pipeline_rank, n_pipeline, r, n_row );
+
+  for( ; n_row; n_row--, r++ )
+  {
+    y = r%ny + 1;
+    z = r/ny + 1;
+    v = VOXEL( 1, y, z, nx, ny, nz );
+
+    UPDATE_CBX( v, nx );
+    UPDATE_CBY( v, nx );
+    UPDATE_CBZ( v, nx );
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper soa_advance_b pipeline
+// function.
+//----------------------------------------------------------------------------//
+
+void
+soa_advance_b_pipeline( field_array_t * RESTRICT fa,
+                        float _frac )
+{
+  if ( !fa || !fa->soa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  load_soa_field_array( fa );
+
+  // Do the bulk of the magnetic fields in the pipelines.  The host
+  // handles stragglers.
+
+  pipeline_args_t args[1];
+
+  args->soa  = fa->soa;
+  args->g    = fa->g;
+  args->frac = _frac;
+
+  EXEC_PIPELINES( soa_advance_b, args, 0 );
+
+  // While the pipelines are busy, do surface fields
+
+  DECLARE_STENCIL();
+
+  // Do left over bx
+  for( z = 1; z <= nz; z++ )
+  {
+    for( y = 1; y <= ny; y++ )
+    {
+      UPDATE_CBX( VOXEL( nx+1, y, z, nx, ny, nz ), 1 );
+    }
+  }
+
+  // Do left over by
+  for( z = 1; z <= nz; z++ )
+  {
+    UPDATE_CBY( VOXEL( 1, ny+1, z, nx, ny, nz ), nx );
+  }
+
+  // Do left over bz
+  for( y = 1; y <= ny; y++ )
+  {
+    UPDATE_CBZ( VOXEL( 1, y, nz+1, nx, ny, nz ), nx );
+  }
+
+  WAIT_PIPELINES();
+
+  // local_adjust_norm_b only changes the fields on local symmetric
+  // boundaries.  Skip the round trip through the field_t array when
+  // there are none.
+
+  if ( soa_has_local_bc( g, symmetric_fields ) )
+  {
+    soa_shell_to_f( fa, soa_cb );
+
+    local_adjust_norm_b( fa->f, fa->g );
+
+    soa_shell_from_f( fa, soa_cb );
+  }
+}
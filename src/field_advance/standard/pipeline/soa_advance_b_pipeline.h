@@ -0,0 +1,62 @@
+#ifndef _soa_advance_b_pipeline_h_
+#define _soa_advance_b_pipeline_h_
+
+#ifndef IN_soa_advance_b_pipeline
+#error "Only include soa_advance_b_pipeline.h in soa_advance_b_pipeline source files."
+#endif
+
+#include "../../field_advance.h"
+
+typedef struct pipeline_args
+{
+  soa_field_t  * soa;
+  const grid_t * g;
+  float frac;
+} pipeline_args_t;
+
+// The updates below work on n consecutive voxels along x starting at
+// voxel v.  The planes do not alias each other so the loops are unit
+// stride vector loops.
+
+#define DECLARE_STENCIL()                                       \
+  const soa_field_t * soa = args->soa;                          \
+  const grid_t      * g   = args->g;                            \
+                                                                \
+  const int   nx   = g->nx;                                     \
+  const int   ny   = g->ny;                                     \
+  const int   nz   = g->nz;                                     \
+  const int   sy   = nx + 2;                                    \
+  const int   sz   = sy*( ny + 2 );                             \
+                                                                \
+  const float frac = args->frac;                                \
+  const float px   = (nx>1) ? frac*g->cvac*g->dt*g->rdx : 0;    \
+  const float py   = (ny>1) ? frac*g->cvac*g->dt*g->rdy : 0;    \
+  const float pz   = (nz>1) ? frac*g->cvac*g->dt*g->rdz : 0;    \
+                                                                \
+  const float * RESTRICT ALIGNED(128) ex  = soa->ex;            \
+  const float * RESTRICT ALIGNED(128) ey  = soa->ey;            \
+  const float * RESTRICT ALIGNED(128) ez  = soa->ez;            \
+  /**/  float * RESTRICT ALIGNED(128) cbx = soa->cbx;           \
+  /**/  float * RESTRICT ALIGNED(128) cby = soa->cby;           \
+  /**/  float * RESTRICT ALIGNED(128) cbz = soa->cbz;           \
+                                                                \
+  int i, y, z
+
+#define UPDATE_CBX(v,n)                                         \
+  for( i = (v); i < (v)+(n); i++ )                              \
+    cbx[i] -= ( py*( ez[i+sy]-ez[i] ) - pz*( ey[i+sz]-ey[i] ) )
+
+#define UPDATE_CBY(v,n)                                         \
+  for( i = (v); i < (v)+(n); i++ )                              \
+    cby[i] -= ( pz*( ex[i+sz]-ex[i] ) - px*( ez[i+1] -ez[i] ) )
+
+#define UPDATE_CBZ(v,n)                                         \
+  for( i = (v); i < (v)+(n); i++ )                              \
+    cbz[i] -= ( px*( ey[i+1] -ey[i] ) - py*( ex[i+sy]-ex[i] ) )
+
+void
+soa_advance_b_pipeline_scalar( pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline );
+
+#endif // _soa_advance_b_pipeline_h_
@@ -0,0 +1,181 @@
+#define IN_sfa
+#define IN_soa_advance_e_pipeline
+
+#include "soa_advance_e_pipeline.h"
+
+#include "../sfa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+//----------------------------------------------------------------------------//
+// The pipelines update whole rows along x.  There are no explicit v4, v8
+// or v16 versions; the row loops are unit stride and are vectorized by
+// the compiler.
+//----------------------------------------------------------------------------//
+
+void
+soa_advance_e_pipeline_scalar( pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline )
+{
+  DECLARE_STENCIL();
+
+  int r, n_row, v;
+
+  // Rows are y = 2:ny, z = 2:nz
+
+  DISTRIBUTE( (ny-1)*(nz-1), 1, pipeline_rank, n_pipeline, r, n_row );
+
+  for( ; n_row; n_row--, r++ )
+  {
+    y = r%(ny-1) + 2;
+    z = r/(ny-1) + 2;
+    v = VOXEL( 1, y, z, nx, ny, nz );
+
+    UPDATE_EX( v,   nx   );
+    UPDATE_EY( v+1, nx-1 );
+    UPDATE_EZ( v+1, nx-1 );
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper soa_advance_e pipeline
+// function.
+//----------------------------------------------------------------------------//
+
+void
+soa_advance_e_pipeline( field_array_t * RESTRICT fa,
+                        float frac )
+{
+  if ( !fa || !fa->soa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  if ( frac != 1 )
+  {
+    ERROR( ( "standard advance_e does not support frac != 1 yet" ) );
+  }
+
+  load_soa_field_array( fa );
+
+  //--------------------------------------------------------------------------//
+  // Begin tangential B ghost setup
+  //--------------------------------------------------------------------------//
+
+  // The ghost setup works on the field_t array.  Absorbing boundaries
+  // also need the tangential E on the surface.
+
+  soa_shell_to_f( fa, soa_e | soa_cb );
+
+  begin_remote_ghost_tang_b( fa->f, fa->g );
+
+  local_ghost_tang_b( fa->f, fa->g );
+
+  //--------------------------------------------------------------------------//
+  // Update interior fields
+  //--------------------------------------------------------------------------//
+  // Note: ex all (1:nx,  1:ny+1,1,nz+1) interior (1:nx,2:ny,2:nz)
+  // Note: ey all (1:nx+1,1:ny,  1:nz+1) interior (2:nx,1:ny,2:nz)
+  // Note: ez all (1:nx+1,1:ny+1,1:nz  ) interior (1:nx,1:ny,2:nz)
+  //--------------------------------------------------------------------------//
+
+  // Do majority of interior in a single pass.  The host handles stragglers.
+
+  pipeline_args_t args[1];
+
+  args->soa = fa->soa;
+  args->p   = (sfa_params_t *) fa->params;
+  args->g   = fa->g;
+
+  EXEC_PIPELINES( soa_advance_e, args, 0 );
+
+  // While the pipelines are busy, do non-bulk interior fields
+
+  DECLARE_STENCIL();
+
+  // Do left over interior ey
+  for( z = 2; z <= nz; z++ )
+  {
+    UPDATE_EY( VOXEL( 2, 1, z, nx, ny, nz ), nx-1 );
+  }
+
+  // Do left over interior ez
+  for( y = 2; y <= ny; y++ )
+  {
+    UPDATE_EZ( VOXEL( 2, y, 1, nx, ny, nz ), nx-1 );
+  }
+
+  WAIT_PIPELINES();
+
+  //--------------------------------------------------------------------------//
+  // Finish tangential B ghost setup
+  //--------------------------------------------------------------------------//
+
+  end_remote_ghost_tang_b( fa->f, fa->g );
+
+  soa_shell_from_f( fa, soa_cb );
+
+  //--------------------------------------------------------------------------//
+  // Update exterior fields
+  //--------------------------------------------------------------------------//
+
+  // Do exterior ex
+  for( y = 1; y <= ny+1; y++ )
+  {
+    UPDATE_EX( VOXEL( 1, y, 1,    nx, ny, nz ), nx );
+    UPDATE_EX( VOXEL( 1, y, nz+1, nx, ny, nz ), nx );
+  }
+
+  for( z = 2; z <= nz; z++ )
+  {
+    UPDATE_EX( VOXEL( 1, 1,    z, nx, ny, nz ), nx );
+    UPDATE_EX( VOXEL( 1, ny+1, z, nx, ny, nz ), nx );
+  }
+
+  // Do exterior ey
+  for( z = 1; z <= nz+1; z++ )
+  {
+    for( y = 1; y <= ny; y++ )
+    {
+      UPDATE_EY( VOXEL( 1,    y, z, nx, ny, nz ), 1 );
+      UPDATE_EY( VOXEL( nx+1, y, z, nx, ny, nz ), 1 );
+    }
+  }
+
+  for( y = 1; y <= ny; y++ )
+  {
+    UPDATE_EY( VOXEL( 2, y, 1,    nx, ny, nz ), nx-1 );
+    UPDATE_EY( VOXEL( 2, y, nz+1, nx, ny, nz ), nx-1 );
+  }
+
+  // Do exterior ez
+  for( z = 1; z <= nz; z++ )
+  {
+    UPDATE_EZ( VOXEL( 1, 1,    z, nx, ny, nz ), nx+1 );
+    UPDATE_EZ( VOXEL( 1, ny+1, z, nx, ny, nz ), nx+1 );
+  }
+
+  for( z = 1; z <= nz; z++ )
+  {
+    for( y = 2; y <= ny; y++ )
+    {
+      UPDATE_EZ( VOXEL( 1,    y, z, nx, ny, nz ), 1 );
+      UPDATE_EZ( VOXEL( nx+1, y, z, nx, ny, nz ), 1 );
+    }
+  }
+
+  // local_adjust_tang_e only changes the fields on local anti-symmetric
+  // and pml boundaries.  Skip the round trip through the field_t array
+  // when there are none.
+
+  if ( soa_has_local_bc( g, anti_symmetric_fields ) ||
+       soa_has_local_bc( g, pml_fields ) )
+  {
+    soa_shell_to_f( fa, soa_e | soa_tca );
+
+    local_adjust_tang_e( fa->f, fa->g );
+
+    soa_shell_from_f( fa, soa_e | soa_tca );
+  }
+}
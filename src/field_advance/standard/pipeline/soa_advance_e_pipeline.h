@@ -0,0 +1,84 @@
+#ifndef _soa_advance_e_pipeline_h_
+#define _soa_advance_e_pipeline_h_
+
+#ifndef IN_soa_advance_e_pipeline
+#error "Only include soa_advance_e_pipeline.h in soa_advance_e_pipeline source files."
+#endif
+
+#include "../sfa_private.h"
+
+typedef struct pipeline_args
+{
+  const soa_field_t  * soa;
+  const sfa_params_t * p;
+  const grid_t       * g;
+} pipeline_args_t;
+
+// The updates below work on n consecutive voxels along x starting at
+// voxel v.  The planes do not alias each other so the loops are unit
+// stride vector loops.
+
+#define DECLARE_STENCIL()                                                    \
+  const soa_field_t            *              soa = args->soa;               \
+  const material_coefficient_t * ALIGNED(128) m   = args->p->mc;             \
+  const grid_t                 *              g   = args->g;                 \
+  const int nx = g->nx, ny = g->ny, nz = g->nz;                              \
+  const int sy = nx + 2, sz = sy*( ny + 2 );                                 \
+                                                                             \
+  const float decayx = m->decayx, drivex = m->drivex;                        \
+  const float decayy = m->decayy, drivey = m->drivey;                        \
+  const float decayz = m->decayz, drivez = m->drivez;                        \
+  const float damp   = args->p->damp;                                        \
+  const float px_muz = ((nx>1) ? (1+damp)*g->cvac*g->dt*g->rdx : 0)*m->rmuz; \
+  const float px_muy = ((nx>1) ? (1+damp)*g->cvac*g->dt*g->rdx : 0)*m->rmuy; \
+  const float py_mux = ((ny>1) ? (1+damp)*g->cvac*g->dt*g->rdy : 0)*m->rmux; \
+  const float py_muz = ((ny>1) ? (1+damp)*g->cvac*g->dt*g->rdy : 0)*m->rmuz; \
+  const float pz_muy = ((nz>1) ? (1+damp)*g->cvac*g->dt*g->rdz : 0)*m->rmuy; \
+  const float pz_mux = ((nz>1) ? (1+damp)*g->cvac*g->dt*g->rdz : 0)*m->rmux; \
+  const float cj     = g->dt/g->eps0;                                        \
+                                                                             \
+  /**/  float * RESTRICT ALIGNED(128) ex   = soa->ex;                        \
+  /**/  float * RESTRICT ALIGNED(128) ey   = soa->ey;                        \
+  /**/  float * RESTRICT ALIGNED(128) ez   = soa->ez;                        \
+  const float * RESTRICT ALIGNED(128) cbx  = soa->cbx;                       \
+  const float * RESTRICT ALIGNED(128) cby  = soa->cby;                       \
+  const float * RESTRICT ALIGNED(128) cbz  = soa->cbz;                       \
+  /**/  float * RESTRICT ALIGNED(128) tcax = soa->tcax;                      \
+  /**/  float * RESTRICT ALIGNED(128) tcay = soa->tcay;                      \
+  /**/  float * RESTRICT ALIGNED(128) tcaz = soa->tcaz;                      \
+  const float * RESTRICT ALIGNED(128) jfx  = soa->jfx;                       \
+  const float * RESTRICT ALIGNED(128) jfy  = soa->jfy;                       \
+  const float * RESTRICT ALIGNED(128) jfz  = soa->jfz;                       \
+                                                                             \
+  int i, y, z
+
+#define UPDATE_EX(v,n)                                                  \
+  for( i = (v); i < (v)+(n); i++ )                                      \
+  {                                                                     \
+    tcax[i] = ( py_muz * ( cbz[i] - cbz[i-sy] ) -                       \
+                pz_muy * ( cby[i] - cby[i-sz] ) ) - damp * tcax[i];     \
+    ex[i]   = decayx * ex[i] + drivex * ( tcax[i] - cj * jfx[i] );      \
+  }
+
+#define UPDATE_EY(v,n)                                                  \
+  for( i = (v); i < (v)+(n); i++ )                                      \
+  {                                                                     \
+    tcay[i] = ( pz_mux * ( cbx[i] - cbx[i-sz] ) -                       \
+                px_muz * ( cbz[i] - cbz[i-1]  ) ) - damp * tcay[i];     \
+    ey[i]   = decayy * ey[i] + drivey * ( tcay[i] - cj * jfy[i] );      \
+  }
+
+#define UPDATE_EZ(v,n)                                                  \
+  for( i = (v); i < (v)+(n); i++ )                                      \
+  {                                                                     \
+    tcaz[i] = ( px_muy * ( cby[i] - cby[i-1]  ) -                       \
+                py_mux * ( cbx[i] - cbx[i-sy] ) ) - damp * tcaz[i];     \
+    ez[i]   = decayz * ez[i] + drivez * ( tcaz[i] - cj * jfz[i] );      \
+  }
+
+void
+soa_advance_e_pipeline_scalar( pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline );
+
+#endif // _soa_advance_e_pipeline_h_
@@ -42,113 +42,21 @@ vacuum_advance_e_pipeline_scalar( pipeline_args_t * args,
 }
 
 //----------------------------------------------------------------------------//
-// Top level function to select and call the proper vacuum_advance_e pipeline
-// function.
+// Update the exterior fields, the tangential E on the surface of the local
+// domain.  These need the tangential B ghosts.
 //----------------------------------------------------------------------------//
 
 void
-vacuum_advance_e_pipeline( field_array_t * RESTRICT fa,
-                           float frac )
+vacuum_advance_e_exterior( field_array_t * RESTRICT fa )
 {
-  if ( !fa )
-  {
-    ERROR( ( "Bad args" ) );
-  }
-
-  if ( frac != 1 )
-  {
-    ERROR( ( "standard advance_e does not support frac != 1 yet" ) );
-  }
-
-  //--------------------------------------------------------------------------//
-  // Begin tangential B ghost setup
-  //--------------------------------------------------------------------------//
-
-  begin_remote_ghost_tang_b( fa->f, fa->g );
-
-  local_ghost_tang_b( fa->f, fa->g );
-
-  //--------------------------------------------------------------------------//
-  // Update interior fields
-  //--------------------------------------------------------------------------//
-  // Note: ex all (1:nx,  1:ny+1,1,nz+1) interior (1:nx,2:ny,2:nz)
-  // Note: ey all (1:nx+1,1:ny,  1:nz+1) interior (2:nx,1:ny,2:nz)
-  // Note: ez all (1:nx+1,1:ny+1,1:nz  ) interior (1:nx,1:ny,2:nz)
-  //--------------------------------------------------------------------------//
-
-  // Do majority of interior in a single pass.  The host handles stragglers.
-
   pipeline_args_t args[1];
 
   args->f = fa->f;
   args->p = (sfa_params_t *) fa->params;
   args->g = fa->g;
 
-  EXEC_PIPELINES( vacuum_advance_e, args, 0 );
-
-  // While the pipelines are busy, do non-bulk interior fields
-
   DECLARE_STENCIL();
 
-  // Do left over interior ex
-  for( z = 2; z <= nz; z++ )
-  {
-    for( y = 2; y <= ny; y++ )
-    {
-      f0 = &f( 1, y,   z   );
-      fy = &f( 1, y-1, z   );
-      fz = &f( 1, y,   z-1 );
-
-      UPDATE_EX();
-    }
-  }
-
-  // Do left over interior ey
-  for( z = 2; z <= nz; z++ )
-  {
-    f0 = &f( 2, 1, z   );
-    fx = &f( 1, 1, z   );
-    fz = &f( 2, 1, z-1 );
-
-    for( x = 2; x <= nx; x++ )
-    {
-      UPDATE_EY();
-
-      f0++;
-      fx++;
-      fz++;
-    }
-  }
-
-  // Do left over interior ez
-  for( y = 2; y <= ny; y++ )
-  {
-    f0 = &f( 2, y,   1 );
-    fx = &f( 1, y,   1 );
-    fy = &f( 2, y-1, 1 );
-
-    for( x = 2; x <= nx; x++ )
-    {
-      UPDATE_EZ();
-
-      f0++;
-      fx++;
-      fy++;
-    }
-  }
-
-  WAIT_PIPELINES();
-
-  //--------------------------------------------------------------------------//
-  // Finish tangential B ghost setup
-  //--------------------------------------------------------------------------//
-
-  end_remote_ghost_tang_b( fa->f, fa->g );
-
-  //--------------------------------------------------------------------------//
-  // Update exterior fields
-  //--------------------------------------------------------------------------//
-
   // Do exterior ex
   for( y = 1; y <= ny+1; y++ )
   {
@@ -327,6 +235,117 @@ vacuum_advance_e_pipeline( field_array_t * RESTRICT fa,
       UPDATE_EZ();
     }
   }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper vacuum_advance_e pipeline
+// function.
+//----------------------------------------------------------------------------//
+
+void
+vacuum_advance_e_pipeline( field_array_t * RESTRICT fa,
+                           float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  if ( frac != 1 )
+  {
+    ERROR( ( "standard advance_e does not support frac != 1 yet" ) );
+  }
+
+  //--------------------------------------------------------------------------//
+  // Begin tangential B ghost setup
+  //--------------------------------------------------------------------------//
+
+  begin_remote_ghost_tang_b( fa->f, fa->g );
+
+  local_ghost_tang_b( fa->f, fa->g );
+
+  //--------------------------------------------------------------------------//
+  // Update interior fields
+  //--------------------------------------------------------------------------//
+  // Note: ex all (1:nx,  1:ny+1,1,nz+1) interior (1:nx,2:ny,2:nz)
+  // Note: ey all (1:nx+1,1:ny,  1:nz+1) interior (2:nx,1:ny,2:nz)
+  // Note: ez all (1:nx+1,1:ny+1,1:nz  ) interior (1:nx,1:ny,2:nz)
+  //--------------------------------------------------------------------------//
+
+  // Do majority of interior in a single pass.  The host handles stragglers.
+
+  pipeline_args_t args[1];
+
+  args->f = fa->f;
+  args->p = (sfa_params_t *) fa->params;
+  args->g = fa->g;
+
+  EXEC_PIPELINES( vacuum_advance_e, args, 0 );
+
+  // While the pipelines are busy, do non-bulk interior fields
+
+  DECLARE_STENCIL();
+
+  // Do left over interior ex
+  for( z = 2; z <= nz; z++ )
+  {
+    for( y = 2; y <= ny; y++ )
+    {
+      f0 = &f( 1, y,   z   );
+      fy = &f( 1, y-1, z   );
+      fz = &f( 1, y,   z-1 );
+
+      UPDATE_EX();
+    }
+  }
+
+  // Do left over interior ey
+  for( z = 2; z <= nz; z++ )
+  {
+    f0 = &f( 2, 1, z   );
+    fx = &f( 1, 1, z   );
+    fz = &f( 2, 1, z-1 );
+
+    for( x = 2; x <= nx; x++ )
+    {
+      UPDATE_EY();
+
+      f0++;
+      fx++;
+      fz++;
+    }
+  }
+
+  // Do left over interior ez
+  for( y = 2; y <= ny; y++ )
+  {
+    f0 = &f( 2, y,   1 );
+    fx = &f( 1, y,   1 );
+    fy = &f( 2, y-1, 1 );
+
+    for( x = 2; x <= nx; x++ )
+    {
+      UPDATE_EZ();
+
+      f0++;
+      fx++;
+      fy++;
+    }
+  }
+
+  WAIT_PIPELINES();
+
+  //--------------------------------------------------------------------------//
+  // Finish tangential B ghost setup
+  //--------------------------------------------------------------------------//
+
+  end_remote_ghost_tang_b( fa->f, fa->g );
+
+  //--------------------------------------------------------------------------//
+  // Update exterior fields
+  //--------------------------------------------------------------------------//
+
+  vacuum_advance_e_exterior( fa );
 
   local_adjust_tang_e( fa->f, fa->g );
 }
@@ -0,0 +1,302 @@
+#define IN_sfa
+#define IN_vacuum_advance_fields_pipeline
+
+// The fused step works on rows along x and only has a scalar pipeline.
+
+#include "vacuum_advance_fields_pipeline.h"
+
+#include "../sfa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+//----------------------------------------------------------------------------//
+// Row kernels.  The core is the voxels 2:nx-1 x 2:ny-1 x 2:nz-1 whose B
+// update reads no E on the surface of the local domain.  The shell is
+// the rest of the voxels that advance_b updates.
+//----------------------------------------------------------------------------//
+
+// Update the B of the core voxels of slab k.
+
+static void
+advance_b_core( pipeline_args_t * args,
+                int k )
+{
+  DECLARE_STENCIL();
+  DECLARE_B_COEFFS();
+
+  int x, y;
+
+  for( y = 2; y < ny; y++ )
+  {
+    f0 = &f( 2, y, k );
+
+    for( x = 2; x < nx; x++ )
+    {
+      UPDATE_CBX();
+      UPDATE_CBY();
+      UPDATE_CBZ();
+
+      f0++;
+    }
+  }
+}
+
+// Update the interior E of slab k, except ey on y = 1.
+
+static void
+advance_e_slab( pipeline_args_t * args,
+                int k )
+{
+  DECLARE_STENCIL();
+  DECLARE_E_COEFFS();
+  DECLARE_EX_COEFFS();
+  DECLARE_EY_COEFFS();
+  DECLARE_EZ_COEFFS();
+
+  int x, y;
+
+  for( y = 2; y <= ny; y++ )
+  {
+    f0 = &f( 1, y, k );
+
+    UPDATE_EX();
+
+    f0++;
+
+    for( x = 2; x <= nx; x++ )
+    {
+      UPDATE_EX();
+      UPDATE_EY();
+      UPDATE_EZ();
+
+      f0++;
+    }
+  }
+}
+
+// Update the B of the shell voxels and the left over bx, by and bz.
+
+static void
+advance_b_shell( pipeline_args_t * args )
+{
+  DECLARE_STENCIL();
+  DECLARE_B_COEFFS();
+
+  int x, y, z, dx;
+
+  for( z = 1; z <= nz; z++ )
+  {
+    for( y = 1; y <= ny; y++ )
+    {
+      // Rows through the core only have x = 1 and x = nx in the shell.
+      dx = ( z == 1 || z == nz || y == 1 || y == ny || nx < 3 ) ? 1 : nx-1;
+
+      for( x = 1; x <= nx; x += dx )
+      {
+        f0 = &f( x, y, z );
+
+        UPDATE_CBX();
+        UPDATE_CBY();
+        UPDATE_CBZ();
+      }
+    }
+  }
+
+  // Do left over bx
+  for( z = 1; z <= nz; z++ )
+  {
+    for( y = 1; y <= ny; y++ )
+    {
+      f0 = &f( nx+1, y, z );
+
+      UPDATE_CBX();
+    }
+  }
+
+  // Do left over by
+  for( z = 1; z <= nz; z++ )
+  {
+    f0 = &f( 1, ny+1, z );
+
+    for( x = 1; x <= nx; x++ )
+    {
+      UPDATE_CBY();
+
+      f0++;
+    }
+  }
+
+  // Do left over bz
+  for( y = 1; y <= ny; y++ )
+  {
+    f0 = &f( 1, y, nz+1 );
+
+    for( x = 1; x <= nx; x++ )
+    {
+      UPDATE_CBZ();
+
+      f0++;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Reference implementation for a vacuum_advance_fields pipeline function.
+// A pipeline walks its z-slabs with the E update one slab behind the
+// first B update and the second B update one slab behind the E update,
+// so each slab is only brought into cache once.
+//----------------------------------------------------------------------------//
+
+void
+vacuum_advance_fields_pipeline_scalar( pipeline_args_t * args,
+                                       int pipeline_rank,
+                                       int n_pipeline )
+{
+  const int nz = args->g->nz;
+
+  int za, zb, n_slab, z;
+
+  // The slabs are z = 2:nz and the host gets none.
+
+  DISTRIBUTE( nz-1, 1, pipeline_rank, n_pipeline, za, n_slab );
+
+  if ( !n_slab )
+  {
+    return;
+  }
+
+  za += 2;
+  zb  = za + n_slab - 1;
+
+  switch( args->stage )
+  {
+  case first_b_last_slab:
+    if ( zb < nz ) advance_b_core( args, zb );
+    break;
+
+  case wavefront:
+    for( z = za; z <= zb; z++ )
+    {
+      if ( z < zb ) advance_b_core( args, z );
+
+      advance_e_slab( args, z );
+
+      if ( z-1 >= za && z-1 < nz ) advance_b_core( args, z-1 );
+    }
+    break;
+
+  case second_b_last_slab:
+    if ( zb < nz ) advance_b_core( args, zb );
+    break;
+
+  default:
+    ERROR( ( "Bad stage" ) );
+    break;
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to call the vacuum_advance_fields pipeline.
+//----------------------------------------------------------------------------//
+
+void
+vacuum_advance_fields_pipeline( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  pipeline_args_t args[1];
+
+  args->f = fa->f;
+  args->p = (sfa_params_t *) fa->params;
+  args->g = fa->g;
+
+  //--------------------------------------------------------------------------//
+  // Half advance B on the shell and begin tangential B ghost setup.  E
+  // has not been touched yet so the absorbing ghosts see E_0 as in
+  // advance_e.
+  //--------------------------------------------------------------------------//
+
+  advance_b_shell( args );
+
+  local_adjust_norm_b( fa->f, fa->g );
+
+  begin_remote_ghost_tang_b( fa->f, fa->g );
+
+  local_ghost_tang_b( fa->f, fa->g );
+
+  //--------------------------------------------------------------------------//
+  // Wavefront over the z-slabs.
+  //--------------------------------------------------------------------------//
+
+  args->stage = first_b_last_slab;
+
+  EXEC_PIPELINES( vacuum_advance_fields, args, 0 );
+
+  WAIT_PIPELINES();
+
+  args->stage = wavefront;
+
+  EXEC_PIPELINES( vacuum_advance_fields, args, 0 );
+
+  // While the pipelines are busy, do the interior E the slabs do not
+  // cover.  The core B never reads these.
+
+  DECLARE_STENCIL();
+  DECLARE_E_COEFFS();
+  DECLARE_EY_COEFFS();
+  DECLARE_EZ_COEFFS();
+
+  int x, y, z;
+
+  // Do left over interior ey
+  for( z = 2; z <= nz; z++ )
+  {
+    f0 = &f( 2, 1, z );
+
+    for( x = 2; x <= nx; x++ )
+    {
+      UPDATE_EY();
+
+      f0++;
+    }
+  }
+
+  // Do left over interior ez
+  for( y = 2; y <= ny; y++ )
+  {
+    f0 = &f( 2, y, 1 );
+
+    for( x = 2; x <= nx; x++ )
+    {
+      UPDATE_EZ();
+
+      f0++;
+    }
+  }
+
+  WAIT_PIPELINES();
+
+  args->stage = second_b_last_slab;
+
+  EXEC_PIPELINES( vacuum_advance_fields, args, 0 );
+
+  WAIT_PIPELINES();
+
+  //--------------------------------------------------------------------------//
+  // Finish tangential B ghost setup, update exterior E and finish B on
+  // the shell.
+  //--------------------------------------------------------------------------//
+
+  end_remote_ghost_tang_b( fa->f, fa->g );
+
+  vacuum_advance_e_exterior( fa );
+
+  local_adjust_tang_e( fa->f, fa->g );
+
+  advance_b_shell( args );
+
+  local_adjust_norm_b( fa->f, fa->g );
+}
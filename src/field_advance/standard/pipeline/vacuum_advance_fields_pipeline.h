@@ -0,0 +1,100 @@
+#ifndef _vacuum_advance_fields_pipeline_h_
+#define _vacuum_advance_fields_pipeline_h_
+
+#ifndef IN_vacuum_advance_fields_pipeline
+#error "Only include vacuum_advance_fields_pipeline.h in vacuum_advance_fields_pipeline source files."
+#endif
+
+#include "../sfa_private.h"
+
+// The pipelines are run in three stages.  Pipeline p owns the z-slabs
+// za:zb of 2:nz.  In the first stage it half advances the core B of
+// zb, in the second it does the wavefront over za:zb and in the third
+// it finishes the B of zb, which needs the E of the next pipeline's
+// first slab.
+
+enum vacuum_advance_fields_stage
+{
+  first_b_last_slab  = 0,
+  wavefront          = 1,
+  second_b_last_slab = 2
+};
+
+typedef struct pipeline_args
+{
+        field_t      * ALIGNED(128) f;
+  const sfa_params_t *              p;
+  const grid_t       *              g;
+  int stage;
+} pipeline_args_t;
+
+// The B coefficients are those of advance_b with frac = 0.5 and the E
+// coefficients are those of vacuum_advance_e.  The updates are written
+// in terms of the voxel pointer f0 only so that rows of voxels can be
+// walked with a single pointer.  The B and E updates of each stage
+// declare only the coefficients they use.
+
+#define DECLARE_STENCIL()                                                    \
+        field_t                * ALIGNED(128) f = args->f;                   \
+  const grid_t                 *              g = args->g;                   \
+  const int nx = g->nx, ny = g->ny, nz = g->nz;                              \
+  const int sy = nx + 2, sz = sy * ( ny + 2 );                               \
+                                                                             \
+  field_t * ALIGNED(16) f0
+
+#define DECLARE_B_COEFFS()                                                   \
+  const float frac = 0.5;                                                    \
+  const float px   = (nx>1) ? frac*g->cvac*g->dt*g->rdx : 0;                 \
+  const float py   = (ny>1) ? frac*g->cvac*g->dt*g->rdy : 0;                 \
+  const float pz   = (nz>1) ? frac*g->cvac*g->dt*g->rdz : 0
+
+#define DECLARE_E_COEFFS()                                                   \
+  const material_coefficient_t * ALIGNED(128) m = args->p->mc;               \
+  const float damp   = args->p->damp;                                        \
+  const float cj     = g->dt/g->eps0
+
+#define DECLARE_EX_COEFFS()                                                  \
+  const float decayx = m->decayx, drivex = m->drivex;                        \
+  const float py_muz = ((ny>1) ? (1+damp)*g->cvac*g->dt*g->rdy : 0)*m->rmuz; \
+  const float pz_muy = ((nz>1) ? (1+damp)*g->cvac*g->dt*g->rdz : 0)*m->rmuy
+
+#define DECLARE_EY_COEFFS()                                                  \
+  const float decayy = m->decayy, drivey = m->drivey;                        \
+  const float pz_mux = ((nz>1) ? (1+damp)*g->cvac*g->dt*g->rdz : 0)*m->rmux; \
+  const float px_muz = ((nx>1) ? (1+damp)*g->cvac*g->dt*g->rdx : 0)*m->rmuz
+
+#define DECLARE_EZ_COEFFS()                                                  \
+  const float decayz = m->decayz, drivez = m->drivez;                        \
+  const float px_muy = ((nx>1) ? (1+damp)*g->cvac*g->dt*g->rdx : 0)*m->rmuy; \
+  const float py_mux = ((ny>1) ? (1+damp)*g->cvac*g->dt*g->rdy : 0)*m->rmux
+
+#define f(x,y,z) f[ VOXEL( x, y, z, nx, ny, nz ) ]
+
+// See advance_b_pipeline.h for why -fno-unsafe-math-optimizations
+// must be used.
+
+#define UPDATE_CBX() f0->cbx -= ( py*( f0[sy].ez-f0->ez ) - pz*( f0[sz].ey-f0->ey ) )
+#define UPDATE_CBY() f0->cby -= ( pz*( f0[sz].ex-f0->ex ) - px*( f0[1].ez -f0->ez ) )
+#define UPDATE_CBZ() f0->cbz -= ( px*( f0[1].ey -f0->ey ) - py*( f0[sy].ex-f0->ex ) )
+
+#define UPDATE_EX()                                                 \
+  f0->tcax = ( py_muz * ( f0->cbz - f0[-sy].cbz ) -                 \
+               pz_muy * ( f0->cby - f0[-sz].cby ) ) - damp * f0->tcax; \
+  f0->ex   = decayx * f0->ex + drivex * ( f0->tcax - cj * f0->jfx )
+
+#define UPDATE_EY()                                                 \
+  f0->tcay = ( pz_mux * ( f0->cbx - f0[-sz].cbx ) -                 \
+               px_muz * ( f0->cbz - f0[-1].cbz  ) ) - damp * f0->tcay; \
+  f0->ey   = decayy * f0->ey + drivey * ( f0->tcay - cj * f0->jfy )
+
+#define UPDATE_EZ()                                                 \
+  f0->tcaz = ( px_muy * ( f0->cby - f0[-1].cby  ) -                 \
+               py_mux * ( f0->cbx - f0[-sy].cbx ) ) - damp * f0->tcaz; \
+  f0->ez   = decayz * f0->ez + drivez * ( f0->tcaz - cj * f0->jfz )
+
+void
+vacuum_advance_fields_pipeline_scalar( pipeline_args_t * args,
+                                       int pipeline_rank,
+                                       int n_pipeline );
+
+#endif // _vacuum_advance_fields_pipeline_h_
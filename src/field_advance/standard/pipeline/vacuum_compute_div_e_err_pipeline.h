@@ -43,7 +43,7 @@ typedef struct pipeline_args
   if ( x > nx )                             \
   {                                         \
     /**/          y++;               x = 2; \
-    if ( y > ny ) z++; if ( y > ny ) y = 2; \
+    if ( y > ny ) { z++; y = 2; }           \
     INIT_STENCIL();                         \
   }
 
@@ -50,7 +50,7 @@ typedef struct pipeline_args
   if ( x > nx )                                     \
   {                                                 \
     /**/          y++;               x = 1;         \
-    if ( y > ny ) z++; if ( y > ny ) y = 1;         \
+    if ( y > ny ) { z++; y = 1; }                   \
     INIT_STENCIL();                                 \
   }
 
@@ -0,0 +1,168 @@
+#define IN_sfa
+
+#include "sfa_private.h"
+
+// Convolutional pml (Roden and Gedney, 2000) with kappa = 1 and alpha =
+// 0.  In the layer of a face with normal X, the X differences d in the
+// curls are replaced by d + psi where
+//   psi_new = b psi_old + ( b - 1 ) d
+//   b       = exp( -s dt )
+//   s       = s_max u^3
+// s is the pml conductivity over eps0 at the depth u (in units of the
+// layer thickness) into the layer and s_max = 0.8 ( 3 + 1 ) c / dX is
+// the usual near optimal value for a cubic grading.  The difference
+// equations of the vacuum kernels are linear in the curls so the psi
+// terms are applied as corrections after them.  The corrections touch
+// tangential E and normal B on the other faces, so the local boundary
+// conditions are enforced again afterwards.
+
+#define PML_S_MAX(c,rd) ( 0.8f*( 3 + 1 )*(c)*(rd) )
+
+#define f(x,y,z) f[ VOXEL(x,y,z, nx,ny,nz) ]
+
+// psi of voxel (Y,Z) of layer l of a face with normal X
+
+#define PSI(X,Y,Z,l) psi[ Y + ( n##Y + 2 )*( Z + ( n##Z + 2 )*(l) ) ]
+
+void
+pml_advance_b( field_array_t * RESTRICT fa,
+               float frac ) {
+  if( !fa ) ERROR(( "Bad args" ));
+
+  advance_b( fa, frac );
+
+  /**/  field_t   * ALIGNED(128) f   = fa->f;
+  const grid_t    *              g   = fa->g;
+  const sfa_pml_t *              pml = ((sfa_params_t *)fa->params)->pml;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  const int sx = 1, sy = nx+2, sz = sy*(ny+2);
+  const int n_cell = pml->n_cell;
+  const float px = (nx>1) ? frac*g->cvac*g->dt*g->rdx : 0;
+  const float py = (ny>1) ? frac*g->cvac*g->dt*g->rdy : 0;
+  const float pz = (nz>1) ? frac*g->cvac*g->dt*g->rdz : 0;
+  const float sx_dt = PML_S_MAX( g->cvac, g->rdx )*frac*g->dt;
+  const float sy_dt = PML_S_MAX( g->cvac, g->rdy )*frac*g->dt;
+  const float sz_dt = PML_S_MAX( g->cvac, g->rdz )*frac*g->dt;
+  pml_psi_t * ALIGNED(16) psi, * ALIGNED(16) ps;
+  field_t   * ALIGNED(16) f0;
+  float u, a, b;
+  int l, x, y, z;
+
+  // cbY lives on X cells, Y nodes and Z cells.  cbZ lives on X cells,
+  // Y cells and Z nodes.  B layer l is the cell at depth l + 1/2 from
+  // the face.
+
+# define PML_ADVANCE_B(face,i,j,k,X,Y,Z)                                \
+  do {                                                                  \
+    psi = pml->psi[face];                                               \
+    if( !psi ) break;                                                   \
+    for( l=0; l<n_cell; l++ ) {                                         \
+      u = ( n_cell - l - 0.5f )/n_cell;                                 \
+      b = exp( -s##X##_dt*u*u*u );                                      \
+      a = b - 1;                                                        \
+      X = (i+j+k)<0 ? 1+l : n##X-l;                                     \
+      for( Z=1; Z<=n##Z; Z++ )                                          \
+        for( Y=1; Y<=n##Y+1; Y++ ) {                                    \
+          f0 = &f(x,y,z);                                               \
+          ps = &PSI(X,Y,Z,l);                                           \
+          ps->cb1 = b*ps->cb1 + a*( f0[s##X].e##Z - f0->e##Z );         \
+          f0->cb##Y += p##X*ps->cb1;                                    \
+        }                                                               \
+      for( Z=1; Z<=n##Z+1; Z++ )                                        \
+        for( Y=1; Y<=n##Y; Y++ ) {                                      \
+          f0 = &f(x,y,z);                                               \
+          ps = &PSI(X,Y,Z,l);                                           \
+          ps->cb2 = b*ps->cb2 + a*( f0[s##X].e##Y - f0->e##Y );         \
+          f0->cb##Z -= p##X*ps->cb2;                                    \
+        }                                                               \
+    }                                                                   \
+  } while(0)
+
+  PML_ADVANCE_B(0,(-1), 0, 0,x,y,z);
+  PML_ADVANCE_B(1, 0,(-1), 0,y,z,x);
+  PML_ADVANCE_B(2, 0, 0,(-1),z,x,y);
+  PML_ADVANCE_B(3, 1, 0, 0,x,y,z);
+  PML_ADVANCE_B(4, 0, 1, 0,y,z,x);
+  PML_ADVANCE_B(5, 0, 0, 1,z,x,y);
+
+# undef PML_ADVANCE_B
+
+  local_adjust_norm_b( f, g );
+}
+
+void
+pml_advance_e( field_array_t * RESTRICT fa,
+               float frac ) {
+  if( !fa ) ERROR(( "Bad args" ));
+
+  vacuum_advance_e( fa, frac );
+
+  /**/  field_t                * ALIGNED(128) f   = fa->f;
+  const grid_t                 *              g   = fa->g;
+  const sfa_params_t           *              p   = (sfa_params_t *)fa->params;
+  const material_coefficient_t * ALIGNED(128) m   = p->mc;
+  const sfa_pml_t              *              pml = p->pml;
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  const int sx = 1, sy = nx+2, sz = sy*(ny+2);
+  const int n_cell = pml->n_cell;
+  const float drivex = m->drivex, drivey = m->drivey, drivez = m->drivez;
+  const float damp   = p->damp;
+  const float px_muz = ((nx>1) ? (1+damp)*g->cvac*g->dt*g->rdx : 0)*m->rmuz;
+  const float px_muy = ((nx>1) ? (1+damp)*g->cvac*g->dt*g->rdx : 0)*m->rmuy;
+  const float py_mux = ((ny>1) ? (1+damp)*g->cvac*g->dt*g->rdy : 0)*m->rmux;
+  const float py_muz = ((ny>1) ? (1+damp)*g->cvac*g->dt*g->rdy : 0)*m->rmuz;
+  const float pz_muy = ((nz>1) ? (1+damp)*g->cvac*g->dt*g->rdz : 0)*m->rmuy;
+  const float pz_mux = ((nz>1) ? (1+damp)*g->cvac*g->dt*g->rdz : 0)*m->rmux;
+  const float sx_dt  = PML_S_MAX( g->cvac, g->rdx )*g->dt;
+  const float sy_dt  = PML_S_MAX( g->cvac, g->rdy )*g->dt;
+  const float sz_dt  = PML_S_MAX( g->cvac, g->rdz )*g->dt;
+  pml_psi_t * ALIGNED(16) psi, * ALIGNED(16) ps;
+  field_t   * ALIGNED(16) f0;
+  float u, a, b, t;
+  int l, x, y, z;
+
+  // eY lives on X nodes, Y cells and Z nodes.  eZ lives on X nodes, Y
+  // nodes and Z cells.  E layer l is the node at depth l from the face.
+  // The E on the face itself is zeroed by local_adjust_tang_e.
+
+# define PML_ADVANCE_E(face,i,j,k,X,Y,Z)                                \
+  do {                                                                  \
+    psi = pml->psi[face];                                               \
+    if( !psi ) break;                                                   \
+    for( l=0; l<n_cell; l++ ) {                                         \
+      u = (float)( n_cell - l )/n_cell;                                 \
+      b = exp( -s##X##_dt*u*u*u );                                      \
+      a = b - 1;                                                        \
+      X = (i+j+k)<0 ? 1+l : n##X+1-l;                                   \
+      for( Z=1; Z<=n##Z+1; Z++ )                                        \
+        for( Y=1; Y<=n##Y; Y++ ) {                                      \
+          f0 = &f(x,y,z);                                               \
+          ps = &PSI(X,Y,Z,l);                                           \
+          ps->e1 = b*ps->e1 + a*( f0->cb##Z - f0[-s##X].cb##Z );        \
+          t = -p##X##_mu##Z*ps->e1;                                     \
+          f0->tca##Y += t;                                              \
+          f0->e##Y   += drive##Y*t;                                     \
+        }                                                               \
+      for( Z=1; Z<=n##Z; Z++ )                                          \
+        for( Y=1; Y<=n##Y+1; Y++ ) {                                    \
+          f0 = &f(x,y,z);                                               \
+          ps = &PSI(X,Y,Z,l);                                           \
+          ps->e2 = b*ps->e2 + a*( f0->cb##Y - f0[-s##X].cb##Y );        \
+          t = p##X##_mu##Y*ps->e2;                                      \
+          f0->tca##Z += t;                                              \
+          f0->e##Z   += drive##Z*t;                                     \
+        }                                                               \
+    }                                                                   \
+  } while(0)
+
+  PML_ADVANCE_E(0,(-1), 0, 0,x,y,z);
+  PML_ADVANCE_E(1, 0,(-1), 0,y,z,x);
+  PML_ADVANCE_E(2, 0, 0,(-1),z,x,y);
+  PML_ADVANCE_E(3, 1, 0, 0,x,y,z);
+  PML_ADVANCE_E(4, 0, 1, 0,y,z,x);
+  PML_ADVANCE_E(5, 0, 0, 1,z,x,y);
+
+# undef PML_ADVANCE_E
+
+  local_adjust_tang_e( f, g );
+}
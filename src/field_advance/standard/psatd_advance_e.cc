@@ -0,0 +1,116 @@
+#define IN_sfa
+
+#include "sfa_private.h"
+
+#define PSATD_PI 3.14159265358979323846
+
+//----------------------------------------------------------------------------//
+// The spectral solver workspace is made on the first step, and on the
+// first step after a restore, so that it does not need to be
+// checkpointed.
+//----------------------------------------------------------------------------//
+
+static sfa_psatd_t *
+new_sfa_psatd( const grid_t * g )
+{
+  sfa_psatd_t * psatd;
+  double d[3], k, t;
+  int a, j, n;
+
+  MALLOC( psatd, 1 );
+  psatd->n[0] = g->nx; d[0] = g->dx;
+  psatd->n[1] = g->ny; d[1] = g->dy;
+  psatd->n[2] = g->nz; d[2] = g->dz;
+  psatd->n_max = 0;
+
+  for( a = 0; a < 3; a++ )
+  {
+    n = psatd->n[a];
+    if ( n > psatd->n_max ) psatd->n_max = n;
+
+    MALLOC_ALIGNED( psatd->tw[a], n, 128 );
+    MALLOC_ALIGNED( psatd->dp[a], n, 128 );
+    MALLOC_ALIGNED( psatd->dy[a], n, 128 );
+
+    for( j = 0; j < n; j++ )
+    {
+      t = 2*PSATD_PI*j/n;
+      psatd->tw[a][j].re =  cos( t );
+      psatd->tw[a][j].im = -sin( t );
+
+      k = 2*PSATD_PI*( ( 2*j <= n ) ? j : j - n )/( n*d[a] );
+      psatd->dp[a][j].re = -k*sin( 0.5*k*d[a] );
+      psatd->dp[a][j].im =  k*cos( 0.5*k*d[a] );
+      psatd->dy[a][j].re = ( 1 - cos( k*d[a] ) )/d[a];
+      psatd->dy[a][j].im =  sin( k*d[a] )/d[a];
+    }
+  }
+
+  MALLOC_ALIGNED( psatd->c, 9*g->nx*g->ny*g->nz, 128 );
+  MALLOC_ALIGNED( psatd->line, 3*psatd->n_max*( MAX_PIPELINE + 1 ), 128 );
+
+  return psatd;
+}
+
+void
+delete_psatd_field_array( field_array_t * fa )
+{
+  if ( !fa )
+  {
+    return;
+  }
+
+  sfa_psatd_t * psatd = ( (sfa_params_t *) fa->params )->psatd;
+
+  if ( psatd )
+  {
+    for( int a = 0; a < 3; a++ )
+    {
+      FREE_ALIGNED( psatd->tw[a] );
+      FREE_ALIGNED( psatd->dp[a] );
+      FREE_ALIGNED( psatd->dy[a] );
+    }
+    FREE_ALIGNED( psatd->c );
+    FREE_ALIGNED( psatd->line );
+    FREE( psatd );
+  }
+
+  delete_standard_field_array( fa );
+}
+
+// cB is advanced with E by psatd_advance_e.
+
+void
+psatd_advance_b( field_array_t * RESTRICT fa,
+                 float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper psatd_advance_e
+// function.
+//----------------------------------------------------------------------------//
+
+void
+psatd_advance_e( field_array_t * RESTRICT fa,
+                 float frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  sfa_params_t * p = (sfa_params_t *) fa->params;
+
+  if ( !p->psatd )
+  {
+    p->psatd = new_sfa_psatd( fa->g );
+  }
+
+  // Conditionally execute this when more abstractions are available.
+  psatd_advance_e_pipeline( fa, frac );
+}
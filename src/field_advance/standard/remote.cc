@@ -40,6 +40,11 @@
 #define y_FACE_LOOP(y) XYZ_LOOP(1,nx,y,y,1,nz)
 #define z_FACE_LOOP(z) XYZ_LOOP(1,nx,1,ny,z,z)
 
+// x_GHOST_LOOP => Loop over all voxels at plane x, ghosts included
+#define x_GHOST_LOOP(x) XYZ_LOOP(x,x,0,ny+1,0,nz+1)
+#define y_GHOST_LOOP(y) XYZ_LOOP(0,nx+1,y,y,0,nz+1)
+#define z_GHOST_LOOP(z) XYZ_LOOP(0,nx+1,0,ny+1,z,z)
+
 /*****************************************************************************
  * Ghost value communications
  *
@@ -278,6 +283,145 @@ end_remote_ghost_div_b( field_t      * ALIGNED(128) field,
 # undef END_SEND
 }
 
+// Unlike the ghost exchanges above, remote_ghost_e fills the edge and
+// corner ghosts too.  The exchange is thus done one axis at a time over
+// whole planes of voxels, ghosts included.  The domain below sends its
+// last plane of E (the normal E of its last cell and the tangential E
+// of the node before its far face) and the domain above sends the
+// normal E of its first cell.  The cell sizes of the neighboring
+// domains are assumed to be the same.
+
+void
+remote_ghost_e( field_t      * ALIGNED(128) field,
+                const grid_t *              g ) {
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  int size, face, x, y, z;
+  field_t *f;
+  float *p;
+
+# define BEGIN_RECV(i,j,k,X,Y,Z)                                \
+  begin_recv_port(i,j,k,( (i+j+k)<0 ? 1 : 3 )*                  \
+                        (n##Y+2)*(n##Z+2)*sizeof(float),g)
+
+# define BEGIN_SEND(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {              \
+    size = ( (i+j+k)<0 ? 1 : 3 )*(n##Y+2)*(n##Z+2)*sizeof(float); \
+    p = (float *)size_send_port( i, j, k, size, g );            \
+    if( p ) {                                                   \
+      face = (i+j+k)<0 ? 1 : n##X;                              \
+      X##_GHOST_LOOP(face) {                                    \
+        f = &field(x,y,z);                                      \
+        (*(p++)) = f->e##X;                                     \
+        if( (i+j+k)>0 ) {                                       \
+          (*(p++)) = f->e##Y;                                   \
+          (*(p++)) = f->e##Z;                                   \
+        }                                                       \
+      }                                                         \
+      begin_send_port( i, j, k, size, g );                      \
+    }                                                           \
+  } END_PRIMITIVE
+
+# define END_RECV(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {                \
+    p = (float *)end_recv_port(i,j,k,g);                        \
+    if( p ) {                                                   \
+      face = (i+j+k)<0 ? n##X+1 : 0;                            \
+      X##_GHOST_LOOP(face) {                                    \
+        f = &field(x,y,z);                                      \
+        f->e##X = (*(p++));                                     \
+        if( (i+j+k)>0 ) {                                       \
+          f->e##Y = (*(p++));                                   \
+          f->e##Z = (*(p++));                                   \
+        }                                                       \
+      }                                                         \
+    }                                                           \
+  } END_PRIMITIVE
+
+# define END_SEND(i,j,k,X,Y,Z) end_send_port( i, j, k, g )
+
+  // Exchange x-faces
+  BEGIN_RECV((-1), 0, 0,x,y,z);
+  BEGIN_RECV( 1, 0, 0,x,y,z);
+  BEGIN_SEND((-1), 0, 0,x,y,z);
+  BEGIN_SEND( 1, 0, 0,x,y,z);
+  END_RECV((-1), 0, 0,x,y,z);
+  END_RECV( 1, 0, 0,x,y,z);
+  END_SEND((-1), 0, 0,x,y,z);
+  END_SEND( 1, 0, 0,x,y,z);
+
+  // Exchange y-faces
+  BEGIN_RECV( 0,(-1), 0,y,z,x);
+  BEGIN_RECV( 0, 1, 0,y,z,x);
+  BEGIN_SEND( 0,(-1), 0,y,z,x);
+  BEGIN_SEND( 0, 1, 0,y,z,x);
+  END_RECV( 0,(-1), 0,y,z,x);
+  END_RECV( 0, 1, 0,y,z,x);
+  END_SEND( 0,(-1), 0,y,z,x);
+  END_SEND( 0, 1, 0,y,z,x);
+
+  // Exchange z-faces
+  BEGIN_RECV( 0, 0,(-1),z,x,y);
+  BEGIN_RECV( 0, 0, 1,z,x,y);
+  BEGIN_SEND( 0, 0,(-1),z,x,y);
+  BEGIN_SEND( 0, 0, 1,z,x,y);
+  END_RECV( 0, 0,(-1),z,x,y);
+  END_RECV( 0, 0, 1,z,x,y);
+  END_SEND( 0, 0,(-1),z,x,y);
+  END_SEND( 0, 0, 1,z,x,y);
+
+# undef BEGIN_RECV
+# undef BEGIN_SEND
+# undef END_RECV
+# undef END_SEND
+}
+
+// Only the domain above has all the E the extended curl of the normal B
+// on a shared face needs.  Its value is copied to the domain below.
+
+void
+remote_far_norm_b( field_t      * ALIGNED(128) field,
+                   const grid_t *              g ) {
+  const int nx = g->nx, ny = g->ny, nz = g->nz;
+  int size, face, x, y, z;
+  float *p;
+
+# define BEGIN_RECV(i,j,k,X,Y,Z) \
+  begin_recv_port(i,j,k,n##Y*n##Z*sizeof(float),g)
+  BEGIN_RECV((-1), 0, 0,x,y,z);
+  BEGIN_RECV( 0,(-1), 0,y,z,x);
+  BEGIN_RECV( 0, 0,(-1),z,x,y);
+# undef BEGIN_RECV
+
+# define BEGIN_SEND(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {      \
+    size = n##Y*n##Z*sizeof(float);                     \
+    p = (float *)size_send_port( i, j, k, size, g );    \
+    if( p ) {                                           \
+      X##_FACE_LOOP(1) (*(p++)) = field(x,y,z).cb##X;   \
+      begin_send_port( i, j, k, size, g );              \
+    }                                                   \
+  } END_PRIMITIVE
+  BEGIN_SEND((-1), 0, 0,x,y,z);
+  BEGIN_SEND( 0,(-1), 0,y,z,x);
+  BEGIN_SEND( 0, 0,(-1),z,x,y);
+# undef BEGIN_SEND
+
+# define END_RECV(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {        \
+    p = (float *)end_recv_port(i,j,k,g);                \
+    if( p ) {                                           \
+      face = n##X+1;                                    \
+      X##_FACE_LOOP(face) field(x,y,z).cb##X = (*(p++)); \
+    }                                                   \
+  } END_PRIMITIVE
+  END_RECV((-1), 0, 0,x,y,z);
+  END_RECV( 0,(-1), 0,y,z,x);
+  END_RECV( 0, 0,(-1),z,x,y);
+# undef END_RECV
+
+# define END_SEND(i,j,k,X,Y,Z) end_send_port(i,j,k,g)
+  END_SEND((-1), 0, 0,x,y,z);
+  END_SEND( 0,(-1), 0,y,z,x);
+  END_SEND( 0, 0,(-1),z,x,y);
+# undef END_SEND
+}
+
 /*****************************************************************************
  * Synchronization functions
  *
@@ -414,28 +558,20 @@ synchronize_tang_e_norm_b( field_array_t * RESTRICT fa ) {
   return gerr;
 }
 
-void
-synchronize_jf( field_array_t * RESTRICT fa ) {
-  field_t * field, * f;
-  grid_t * RESTRICT g;
-  int size, face, x, y, z, nx, ny, nz;
-  float *p, lw, rw;
-
-  if( !fa ) ERROR(( "Bad args" ));
-  field = fa->f;
-  g     = fa->g;
-
-  local_adjust_jf( field, g );
+// synchronize_jf is split into begin / end pairs so that work that
+// does not touch jf (like the first half advance of B) can be done
+// while the shared currents are in flight.  The exchange is done one
+// axis at a time so that currents on edges shared by more than two
+// domains are summed correctly.  Thus only the x-face exchange is
+// overlapped but all the receives are posted up front.
 
-  nx = g->nx;
-  ny = g->ny;
-  nz = g->nz;
+// Indexing macros for the shared current exchange
 
-# define BEGIN_RECV(i,j,k,X,Y,Z)                                        \
+#define BEGIN_RECV_JF(i,j,k,X,Y,Z)                                      \
   begin_recv_port(i,j,k, ( n##Y*(n##Z+1) +                              \
                            n##Z*(n##Y+1) + 1 )*sizeof(float), g )
 
-# define BEGIN_SEND(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {              \
+#define BEGIN_SEND_JF(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {            \
     size = ( n##Y*(n##Z+1) +                                    \
              n##Z*(n##Y+1) + 1 )*sizeof(float);                 \
     p = (float *)size_send_port( i, j, k, size, g );            \
@@ -448,7 +584,7 @@ synchronize_jf( field_array_t * RESTRICT fa ) {
     }                                                           \
   } END_PRIMITIVE
 
-# define END_RECV(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {                \
+#define END_RECV_JF(i,j,k,X,Y,Z) BEGIN_PRIMITIVE {              \
     p = (float *)end_recv_port(i,j,k,g);                        \
     if( p ) {                                                   \
       rw = (*(p++));                 /* Remote g->d##X */       \
@@ -469,42 +605,88 @@ synchronize_jf( field_array_t * RESTRICT fa ) {
     }                                                           \
   } END_PRIMITIVE
 
-# define END_SEND(i,j,k,X,Y,Z) end_send_port( i, j, k, g )
+#define END_SEND_JF(i,j,k,X,Y,Z) end_send_port( i, j, k, g )
 
-  // Exchange x-faces
-  BEGIN_SEND((-1), 0, 0,x,y,z);
-  BEGIN_SEND( 1, 0, 0,x,y,z);
-  BEGIN_RECV((-1), 0, 0,x,y,z);
-  BEGIN_RECV( 1, 0, 0,x,y,z);
-  END_RECV((-1), 0, 0,x,y,z);
-  END_RECV( 1, 0, 0,x,y,z);
-  END_SEND((-1), 0, 0,x,y,z);
-  END_SEND( 1, 0, 0,x,y,z);
+void
+begin_synchronize_jf( field_array_t * RESTRICT fa ) {
+  field_t * field;
+  grid_t * RESTRICT g;
+  int size, face, x, y, z, nx, ny, nz;
+  float *p;
+
+  if( !fa ) ERROR(( "Bad args" ));
+  field = fa->f;
+  g     = fa->g;
+
+  local_adjust_jf( field, g );
+
+  nx = g->nx;
+  ny = g->ny;
+  nz = g->nz;
+
+  BEGIN_RECV_JF((-1), 0, 0,x,y,z);
+  BEGIN_RECV_JF( 1, 0, 0,x,y,z);
+  BEGIN_RECV_JF( 0,(-1), 0,y,z,x);
+  BEGIN_RECV_JF( 0, 1, 0,y,z,x);
+  BEGIN_RECV_JF( 0, 0,(-1),z,x,y);
+  BEGIN_RECV_JF( 0, 0, 1,z,x,y);
+
+  // Begin exchanging x-faces
+
+  BEGIN_SEND_JF((-1), 0, 0,x,y,z);
+  BEGIN_SEND_JF( 1, 0, 0,x,y,z);
+}
+
+void
+end_synchronize_jf( field_array_t * RESTRICT fa ) {
+  field_t * field, * f;
+  grid_t * RESTRICT g;
+  int size, face, x, y, z, nx, ny, nz;
+  float *p, lw, rw;
+
+  if( !fa ) ERROR(( "Bad args" ));
+  field = fa->f;
+  g     = fa->g;
+
+  nx = g->nx;
+  ny = g->ny;
+  nz = g->nz;
+
+  // Finish exchanging x-faces
+
+  END_RECV_JF((-1), 0, 0,x,y,z);
+  END_RECV_JF( 1, 0, 0,x,y,z);
+  END_SEND_JF((-1), 0, 0,x,y,z);
+  END_SEND_JF( 1, 0, 0,x,y,z);
 
   // Exchange y-faces
-  BEGIN_SEND( 0,(-1), 0,y,z,x);
-  BEGIN_SEND( 0, 1, 0,y,z,x);
-  BEGIN_RECV( 0,(-1), 0,y,z,x);
-  BEGIN_RECV( 0, 1, 0,y,z,x);
-  END_RECV( 0,(-1), 0,y,z,x);
-  END_RECV( 0, 1, 0,y,z,x);
-  END_SEND( 0,(-1), 0,y,z,x);
-  END_SEND( 0, 1, 0,y,z,x);
+
+  BEGIN_SEND_JF( 0,(-1), 0,y,z,x);
+  BEGIN_SEND_JF( 0, 1, 0,y,z,x);
+  END_RECV_JF( 0,(-1), 0,y,z,x);
+  END_RECV_JF( 0, 1, 0,y,z,x);
+  END_SEND_JF( 0,(-1), 0,y,z,x);
+  END_SEND_JF( 0, 1, 0,y,z,x);
 
   // Exchange z-faces
-  BEGIN_SEND( 0, 0,(-1),z,x,y);
-  BEGIN_SEND( 0, 0, 1,z,x,y);
-  BEGIN_RECV( 0, 0,(-1),z,x,y);
-  BEGIN_RECV( 0, 0, 1,z,x,y);
-  END_RECV( 0, 0,(-1),z,x,y);
-  END_RECV( 0, 0, 1,z,x,y);
-  END_SEND( 0, 0,(-1),z,x,y);
-  END_SEND( 0, 0, 1,z,x,y);
 
-# undef BEGIN_RECV
-# undef BEGIN_SEND
-# undef END_RECV
-# undef END_SEND
+  BEGIN_SEND_JF( 0, 0,(-1),z,x,y);
+  BEGIN_SEND_JF( 0, 0, 1,z,x,y);
+  END_RECV_JF( 0, 0,(-1),z,x,y);
+  END_RECV_JF( 0, 0, 1,z,x,y);
+  END_SEND_JF( 0, 0,(-1),z,x,y);
+  END_SEND_JF( 0, 0, 1,z,x,y);
+}
+
+#undef BEGIN_RECV_JF
+#undef BEGIN_SEND_JF
+#undef END_RECV_JF
+#undef END_SEND_JF
+
+void
+synchronize_jf( field_array_t * RESTRICT fa ) {
+  begin_synchronize_jf( fa );
+  end_synchronize_jf( fa );
 }
 
 // Note: synchronize_rho assumes that rhof has _not_ been adjusted at
@@ -13,6 +13,8 @@ static field_advance_kernels_t sfa_kernels = {
   advance_b,
   advance_e,
 
+  advance_fields,
+
   // Diagnostic interfaces
 
   energy_f,
@@ -20,6 +22,7 @@ static field_advance_kernels_t sfa_kernels = {
   // Accumulator interfaces
 
   clear_jf,   synchronize_jf,
+  begin_synchronize_jf, end_synchronize_jf,
   clear_rhof, synchronize_rho,
 
   // Initialize interface
@@ -45,6 +48,255 @@ static field_advance_kernels_t sfa_kernels = {
 
 };
 
+// Kernels of a field array filled by a single material.  These never
+// look at the material ids of the field_t.
+
+static field_advance_kernels_t vacuum_kernels = {
+
+  // Destructor
+
+  delete_standard_field_array,
+
+  // Time stepping interfaces
+
+  advance_b,
+  vacuum_advance_e,
+
+  vacuum_advance_fields,
+
+  // Diagnostic interfaces
+
+  vacuum_energy_f,
+
+  // Accumulator interfaces
+
+  clear_jf,   synchronize_jf,
+  begin_synchronize_jf, end_synchronize_jf,
+  clear_rhof, synchronize_rho,
+
+  // Initialize interface
+
+  vacuum_compute_rhob,
+  vacuum_compute_curl_b,
+
+  // Shared face cleaning interface
+
+  synchronize_tang_e_norm_b,
+  
+  // Electric field divergence cleaning interface
+
+  vacuum_compute_div_e_err,
+  compute_rms_div_e_err,
+  vacuum_clean_div_e,
+
+  // Magnetic field divergence cleaning interface
+
+  compute_div_b_err,
+  compute_rms_div_b_err,
+  clean_div_b
+
+};
+
+// Kernels of a single material field array that keeps E, cB, TCA and
+// jf in SoA planes.  Kernels that work on the field_t array unload the
+// planes first.
+
+static field_advance_kernels_t soa_kernels = {
+
+  // Destructor
+
+  delete_soa_field_array,
+
+  // Time stepping interfaces
+
+  soa_advance_b,
+  soa_advance_e,
+
+  advance_fields,
+
+  // Diagnostic interfaces
+
+  soa_energy_f,
+
+  // Accumulator interfaces
+
+  soa_clear_jf, soa_synchronize_jf,
+  soa_begin_synchronize_jf, soa_end_synchronize_jf,
+  clear_rhof,   synchronize_rho,
+
+  // Initialize interface
+
+  soa_compute_rhob,
+  soa_compute_curl_b,
+
+  // Shared face cleaning interface
+
+  soa_synchronize_tang_e_norm_b,
+  
+  // Electric field divergence cleaning interface
+
+  soa_compute_div_e_err,
+  compute_rms_div_e_err,
+  soa_clean_div_e,
+
+  // Magnetic field divergence cleaning interface
+
+  soa_compute_div_b_err,
+  compute_rms_div_b_err,
+  soa_clean_div_b
+
+};
+
+// Kernels of a single material field array with convolutional pml
+// layers on its pml_fields faces.  These are the vacuum kernels with
+// pml corrections in the field advance.
+
+static field_advance_kernels_t pml_kernels = {
+
+  // Destructor
+
+  delete_pml_field_array,
+
+  // Time stepping interfaces
+
+  pml_advance_b,
+  pml_advance_e,
+
+  advance_fields,
+
+  // Diagnostic interfaces
+
+  vacuum_energy_f,
+
+  // Accumulator interfaces
+
+  clear_jf,   synchronize_jf,
+  begin_synchronize_jf, end_synchronize_jf,
+  clear_rhof, synchronize_rho,
+
+  // Initialize interface
+
+  vacuum_compute_rhob,
+  vacuum_compute_curl_b,
+
+  // Shared face cleaning interface
+
+  synchronize_tang_e_norm_b,
+  
+  // Electric field divergence cleaning interface
+
+  vacuum_compute_div_e_err,
+  compute_rms_div_e_err,
+  vacuum_clean_div_e,
+
+  // Magnetic field divergence cleaning interface
+
+  compute_div_b_err,
+  compute_rms_div_b_err,
+  clean_div_b
+
+};
+
+// Kernels of a single material field array with the Cole-Karkkainen
+// extended curl in advance_b.  advance_b exchanges ghost E, so the
+// shared current exchange is not overlapped with it.
+
+static field_advance_kernels_t ckc_kernels = {
+
+  // Destructor
+
+  delete_standard_field_array,
+
+  // Time stepping interfaces
+
+  ckc_advance_b,
+  vacuum_advance_e,
+
+  advance_fields,
+
+  // Diagnostic interfaces
+
+  vacuum_energy_f,
+
+  // Accumulator interfaces
+
+  clear_jf,   synchronize_jf,
+  synchronize_jf, ckc_end_synchronize_jf,
+  clear_rhof, synchronize_rho,
+
+  // Initialize interface
+
+  vacuum_compute_rhob,
+  vacuum_compute_curl_b,
+
+  // Shared face cleaning interface
+
+  synchronize_tang_e_norm_b,
+  
+  // Electric field divergence cleaning interface
+
+  vacuum_compute_div_e_err,
+  compute_rms_div_e_err,
+  vacuum_clean_div_e,
+
+  // Magnetic field divergence cleaning interface
+
+  compute_div_b_err,
+  compute_rms_div_b_err,
+  clean_div_b
+
+};
+
+// Kernels of a single material vacuum field array advanced by the
+// spectral solver.  advance_b does nothing, so the shared current
+// exchange overlaps nothing.
+
+static field_advance_kernels_t psatd_kernels = {
+
+  // Destructor
+
+  delete_psatd_field_array,
+
+  // Time stepping interfaces
+
+  psatd_advance_b,
+  psatd_advance_e,
+
+  advance_fields,
+
+  // Diagnostic interfaces
+
+  vacuum_energy_f,
+
+  // Accumulator interfaces
+
+  clear_jf,   synchronize_jf,
+  begin_synchronize_jf, end_synchronize_jf,
+  clear_rhof, synchronize_rho,
+
+  // Initialize interface
+
+  vacuum_compute_rhob,
+  vacuum_compute_curl_b,
+
+  // Shared face cleaning interface
+
+  synchronize_tang_e_norm_b,
+  
+  // Electric field divergence cleaning interface
+
+  vacuum_compute_div_e_err,
+  compute_rms_div_e_err,
+  vacuum_clean_div_e,
+
+  // Magnetic field divergence cleaning interface
+
+  compute_div_b_err,
+  compute_rms_div_b_err,
+  clean_div_b
+
+};
+
 static float
 minf( float a, 
       float b )
@@ -52,10 +304,27 @@ minf( float a,
   return a<b ? a : b;
 }
 
+static float
+maxf( float a, 
+      float b )
+{
+  return a>b ? a : b;
+}
+
+// The Courant condition create_sfa_params checks.  The Cole-Karkkainen
+// curl needs c dt < min( dx, dy, dz ) and the spectral solver has none.
+
+enum sfa_courant {
+  yee_courant   = 0,
+  ckc_courant   = 1,
+  psatd_courant = 2
+};
+
 static sfa_params_t *
 create_sfa_params( grid_t * g,
                    const material_t * m_list,
-                   float damp )
+                   float damp,
+                   int courant )
 {
   sfa_params_t * p;
   float ax, ay, az, cg2;
@@ -88,9 +357,16 @@ create_sfa_params( grid_t * g,
       WARNING(("\"%s\" has an imaginary z speed of light (ex)", m->name));
     if( m->epsy*m->mux<0 )
       WARNING(("\"%s\" has an imaginary z speed of light (ey)", m->name));
-    cg2 = ax/minf(m->epsy*m->muz,m->epsz*m->muy) +
-          ay/minf(m->epsz*m->mux,m->epsx*m->muz) +
-          az/minf(m->epsx*m->muy,m->epsy*m->mux);
+    if( courant==psatd_courant )
+      cg2 = 0;
+    else if( courant==ckc_courant )
+      cg2 = maxf( ax/minf(m->epsy*m->muz,m->epsz*m->muy),
+            maxf( ay/minf(m->epsz*m->mux,m->epsx*m->muz),
+                  az/minf(m->epsx*m->muy,m->epsy*m->mux) ) );
+    else
+      cg2 = ax/minf(m->epsy*m->muz,m->epsz*m->muy) +
+            ay/minf(m->epsz*m->mux,m->epsx*m->muz) +
+            az/minf(m->epsx*m->muy,m->epsy*m->mux);
     if( cg2>=1 )
       WARNING(( "\"%s\" Courant condition estimate = %e", m->name, sqrt(cg2) ));
     if( m->zetax!=0 || m->zetay!=0 || m->zetaz!=0 )
@@ -104,6 +380,8 @@ create_sfa_params( grid_t * g,
   MALLOC_ALIGNED( p->mc, n_mc+2, 128 );
   p->n_mc = n_mc;
   p->damp = damp;
+  p->pml  = NULL;
+  p->psatd = NULL;
 
   // Fill up the material coefficient array
   // FIXME: THIS IMPLICITLY ASSUMES MATERIALS ARE NUMBERED CONSECUTIVELY FROM
@@ -193,28 +471,291 @@ new_standard_field_array( grid_t           * RESTRICT g,
                           float                       damp ) {
   field_array_t * fa;
   if( !g || !m_list || damp<0 ) ERROR(( "Bad args" ));
+
+  /* If there is only one material, then this material permeates all
+     space and we can use high performance versions of some kernels. */
+  if( !m_list->next ) return new_vacuum_field_array( g, m_list, damp );
+
+#if defined(VPIC_USE_VACUUM_FIELDS)
+  ERROR(( "Multiple materials are not supported when VPIC is built with "
+          "USE_VACUUM_FIELDS" ));
+#endif
+
   MALLOC( fa, 1 );
   MALLOC_ALIGNED( fa->f, g->nv, 128 );
   CLEAR( fa->f, g->nv );
   fa->g = g;
-  fa->params = create_sfa_params( g, m_list, damp );
+  fa->params = create_sfa_params( g, m_list, damp, yee_courant );
+  fa->soa = NULL;
   fa->kernel[0] = sfa_kernels;
-  if( !m_list->next ) {
-    /* If there is only one material, then this material permeates all
-       space and we can use high performance versions of some kernels. */
-    fa->kernel->advance_e         = vacuum_advance_e;
-    fa->kernel->energy_f          = vacuum_energy_f;
-    fa->kernel->compute_rhob      = vacuum_compute_rhob;
-    fa->kernel->compute_curl_b    = vacuum_compute_curl_b;
-    fa->kernel->compute_div_e_err = vacuum_compute_div_e_err;
-    fa->kernel->clean_div_e       = vacuum_clean_div_e;
+
+  REGISTER_OBJECT( fa, checkpt_standard_field_array,
+                       restore_standard_field_array, NULL );
+  return fa;
+}
+
+field_array_t *
+new_vacuum_field_array( grid_t           * RESTRICT g,
+                        const material_t * RESTRICT m_list,
+                        float                       damp ) {
+  field_array_t * fa;
+  if( !g || !m_list || damp<0 ) ERROR(( "Bad args" ));
+  if( m_list->next ) ERROR(( "Vacuum field arrays take a single material" ));
+  MALLOC( fa, 1 );
+  MALLOC_ALIGNED( fa->f, g->nv, 128 );
+  CLEAR( fa->f, g->nv );
+  fa->g = g;
+  fa->params = create_sfa_params( g, m_list, damp, yee_courant );
+  fa->soa = NULL;
+  fa->kernel[0] = vacuum_kernels;
+
+  REGISTER_OBJECT( fa, checkpt_standard_field_array,
+                       restore_standard_field_array, NULL );
+  return fa;
+}
+
+/*****************************************************************************/
+
+// Point the planes of a SoA field storage into its allocation.
+
+static void
+set_soa_planes( soa_field_t * soa ) {
+  float * p = soa->plane;
+  const int s = soa->stride;
+  soa->ex   = p;  p += s; soa->ey   = p;  p += s; soa->ez   = p;  p += s;
+  soa->cbx  = p;  p += s; soa->cby  = p;  p += s; soa->cbz  = p;  p += s;
+  soa->tcax = p;  p += s; soa->tcay = p;  p += s; soa->tcaz = p;  p += s;
+  soa->jfx  = p;  p += s; soa->jfy  = p;  p += s; soa->jfz  = p;
+}
+
+void
+checkpt_soa_field_array( const field_array_t * fa ) {
+  sfa_params_t * p = (sfa_params_t *)fa->params; 
+  soa_field_t * soa = fa->soa;
+  CHECKPT( fa, 1 );
+  CHECKPT_ALIGNED( fa->f, fa->g->nv, 128 );
+  CHECKPT_PTR( fa->g );
+  CHECKPT( p, 1 );
+  CHECKPT_ALIGNED( p->mc, p->n_mc, 128 );
+  CHECKPT( soa, 1 );
+  CHECKPT_ALIGNED( soa->plane, 12*soa->stride, 128 );
+  checkpt_field_advance_kernels( fa->kernel );
+}
+
+field_array_t *
+restore_soa_field_array( void ) {
+  field_array_t * fa; 
+  sfa_params_t * p;
+  soa_field_t * soa;
+  RESTORE( fa );
+  RESTORE_ALIGNED( fa->f );
+  RESTORE_PTR( fa->g );
+  RESTORE( p );
+  RESTORE_ALIGNED( p->mc );
+  RESTORE( soa );
+  RESTORE_ALIGNED( soa->plane );
+  set_soa_planes( soa );
+  fa->params = p;
+  fa->soa = soa;
+  restore_field_advance_kernels( fa->kernel );
+  return fa;
+}
+
+field_array_t *
+new_soa_field_array( grid_t           * RESTRICT g,
+                     const material_t * RESTRICT m_list,
+                     float                       damp ) {
+  field_array_t * fa;
+  soa_field_t * soa;
+  if( !g || !m_list || damp<0 ) ERROR(( "Bad args" ));
+  if( m_list->next ) ERROR(( "SoA field arrays take a single material" ));
+  MALLOC( fa, 1 );
+  MALLOC_ALIGNED( fa->f, g->nv, 128 );
+  CLEAR( fa->f, g->nv );
+  fa->g = g;
+  fa->params = create_sfa_params( g, m_list, damp, yee_courant );
+
+  MALLOC( soa, 1 );
+  soa->stride = ( g->nv + 31 ) & ~31;
+  MALLOC_ALIGNED( soa->plane, 12*soa->stride, 128 );
+  CLEAR( soa->plane, 12*soa->stride );
+  set_soa_planes( soa );
+  soa->in_f = 1;
+  fa->soa = soa;
+
+  fa->kernel[0] = soa_kernels;
+
+  REGISTER_OBJECT( fa, checkpt_soa_field_array,
+                       restore_soa_field_array, NULL );
+  return fa;
+}
+
+void
+delete_soa_field_array( field_array_t * fa ) {
+  if( !fa ) return;
+  FREE_ALIGNED( fa->soa->plane );
+  FREE( fa->soa );
+  delete_standard_field_array( fa );
+}
+
+/*****************************************************************************/
+
+void
+checkpt_pml_field_array( const field_array_t * fa ) {
+  sfa_params_t * p = (sfa_params_t *)fa->params; 
+  sfa_pml_t * pml = p->pml;
+  CHECKPT( fa, 1 );
+  CHECKPT_ALIGNED( fa->f, fa->g->nv, 128 );
+  CHECKPT_PTR( fa->g );
+  CHECKPT( p, 1 );
+  CHECKPT_ALIGNED( p->mc, p->n_mc, 128 );
+  CHECKPT( pml, 1 );
+  for( int face=0; face<6; face++ )
+    if( pml->psi[face] )
+      CHECKPT_ALIGNED( pml->psi[face], pml->n_psi[face], 128 );
+  checkpt_field_advance_kernels( fa->kernel );
+}
+
+field_array_t *
+restore_pml_field_array( void ) {
+  field_array_t * fa; 
+  sfa_params_t * p;
+  sfa_pml_t * pml;
+  RESTORE( fa );
+  RESTORE_ALIGNED( fa->f );
+  RESTORE_PTR( fa->g );
+  RESTORE( p );
+  RESTORE_ALIGNED( p->mc );
+  RESTORE( pml );
+  for( int face=0; face<6; face++ )
+    if( pml->psi[face] )
+      RESTORE_ALIGNED( pml->psi[face] );
+  p->pml = pml;
+  fa->params = p;
+  restore_field_advance_kernels( fa->kernel );
+  return fa;
+}
+
+field_array_t *
+new_pml_field_array( grid_t           * RESTRICT g,
+                     const material_t * RESTRICT m_list,
+                     float                       damp,
+                     int                         n_cell ) {
+  static const int face_bc[6] = {
+    BOUNDARY(-1, 0, 0), BOUNDARY( 0,-1, 0), BOUNDARY( 0, 0,-1),
+    BOUNDARY( 1, 0, 0), BOUNDARY( 0, 1, 0), BOUNDARY( 0, 0, 1)
+  };
+  field_array_t * fa;
+  sfa_pml_t * pml;
+  int face, n[3];
+  if( !g || !m_list || damp<0 || n_cell<1 ) ERROR(( "Bad args" ));
+  if( m_list->next ) ERROR(( "Pml field arrays take a single material" ));
+  MALLOC( fa, 1 );
+  MALLOC_ALIGNED( fa->f, g->nv, 128 );
+  CLEAR( fa->f, g->nv );
+  fa->g = g;
+  fa->params = create_sfa_params( g, m_list, damp, yee_courant );
+  fa->soa = NULL;
+
+  // A face with normal X has a layer of n_cell cells along X by
+  // ( nY + 2 ) x ( nZ + 2 ) voxels, ghosts included.
+
+  n[0] = g->nx; n[1] = g->ny; n[2] = g->nz;
+  MALLOC( pml, 1 );
+  pml->n_cell = n_cell;
+  for( face=0; face<6; face++ ) {
+    pml->n_psi[face] = 0;
+    pml->psi[face]   = NULL;
+    if( g->bc[ face_bc[face] ]!=pml_fields ) continue;
+    if( n_cell>n[face%3] )
+      ERROR(( "The pml layers (%i cells) do not fit in the local domain "
+              "(%i cells along the normal of face %i)",
+              n_cell, n[face%3], face ));
+    pml->n_psi[face] = n_cell*( n[(face+1)%3] + 2 )*( n[(face+2)%3] + 2 );
+    MALLOC_ALIGNED( pml->psi[face], pml->n_psi[face], 128 );
+    CLEAR( pml->psi[face], pml->n_psi[face] );
   }
+  ((sfa_params_t *)fa->params)->pml = pml;
+
+  fa->kernel[0] = pml_kernels;
+
+  REGISTER_OBJECT( fa, checkpt_pml_field_array,
+                       restore_pml_field_array, NULL );
+  return fa;
+}
+
+void
+delete_pml_field_array( field_array_t * fa ) {
+  if( !fa ) return;
+  sfa_pml_t * pml = ((sfa_params_t *)fa->params)->pml;
+  for( int face=0; face<6; face++ ) FREE_ALIGNED( pml->psi[face] );
+  FREE( pml );
+  delete_standard_field_array( fa );
+}
+
+field_array_t *
+new_ckc_field_array( grid_t           * RESTRICT g,
+                     const material_t * RESTRICT m_list,
+                     float                       damp ) {
+  field_array_t * fa;
+  if( !g || !m_list || damp<0 ) ERROR(( "Bad args" ));
+  if( m_list->next ) ERROR(( "Ckc field arrays take a single material" ));
+  MALLOC( fa, 1 );
+  MALLOC_ALIGNED( fa->f, g->nv, 128 );
+  CLEAR( fa->f, g->nv );
+  fa->g = g;
+  fa->params = create_sfa_params( g, m_list, damp, ckc_courant );
+  fa->soa = NULL;
+  fa->kernel[0] = ckc_kernels;
 
   REGISTER_OBJECT( fa, checkpt_standard_field_array,
                        restore_standard_field_array, NULL );
   return fa;
 }
 
+// The spectral workspace is remade on the first step after a restore.
+
+field_array_t *
+restore_psatd_field_array( void ) {
+  field_array_t * fa = restore_standard_field_array();
+  ((sfa_params_t *)fa->params)->psatd = NULL;
+  return fa;
+}
+
+field_array_t *
+new_psatd_field_array( grid_t           * RESTRICT g,
+                       const material_t * RESTRICT m_list ) {
+  static const int face_bc[6] = {
+    BOUNDARY(-1, 0, 0), BOUNDARY( 0,-1, 0), BOUNDARY( 0, 0,-1),
+    BOUNDARY( 1, 0, 0), BOUNDARY( 0, 1, 0), BOUNDARY( 0, 0, 1)
+  };
+  field_array_t * fa;
+  int face;
+  if( !g || !m_list ) ERROR(( "Bad args" ));
+  if( m_list->next ) ERROR(( "Psatd field arrays take a single material" ));
+  if( m_list->epsx!=1   || m_list->epsy!=1   || m_list->epsz!=1   ||
+      m_list->mux!=1    || m_list->muy!=1    || m_list->muz!=1    ||
+      m_list->sigmax!=0 || m_list->sigmay!=0 || m_list->sigmaz!=0 )
+    ERROR(( "Psatd field arrays only support vacuum" ));
+  for( face=0; face<6; face++ )
+    if( g->bc[ face_bc[face] ]!=world_rank )
+      ERROR(( "Psatd field arrays need a local domain that is periodic "
+              "on itself" ));
+  MALLOC( fa, 1 );
+  MALLOC_ALIGNED( fa->f, g->nv, 128 );
+  CLEAR( fa->f, g->nv );
+  fa->g = g;
+  fa->params = create_sfa_params( g, m_list, 0, psatd_courant );
+  fa->soa = NULL;
+  fa->kernel[0] = psatd_kernels;
+
+  REGISTER_OBJECT( fa, checkpt_standard_field_array,
+                       restore_psatd_field_array, NULL );
+  return fa;
+}
+
+/*****************************************************************************/
+
 void
 delete_standard_field_array( field_array_t * fa ) {
   if( !fa ) return;
@@ -224,6 +765,20 @@ delete_standard_field_array( field_array_t * fa ) {
   FREE( fa );
 }
 
+int
+has_yee_advance_b( const field_array_t * RESTRICT fa ) {
+  if( !fa ) ERROR(( "Bad args" ));
+  return fa->kernel->advance_b==advance_b;
+}
+
+int
+has_standard_synchronize_jf( const field_array_t * RESTRICT fa ) {
+  if( !fa ) ERROR(( "Bad args" ));
+  return fa->kernel->clear_jf==clear_jf &&
+         fa->kernel->begin_synchronize_jf==begin_synchronize_jf &&
+         fa->kernel->end_synchronize_jf==end_synchronize_jf;
+}
+
 /*****************************************************************************/
 
 #define f(x,y,z) f[ VOXEL( x, y, z, nx, ny, nz ) ]
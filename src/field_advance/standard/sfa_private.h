@@ -22,11 +22,55 @@ typedef struct material_coefficient
   float pad[3];                 // For 64-byte alignment and future expansion
 } material_coefficient_t;
 
+// pml_psi holds the convolution memory of the convolutional pml of a
+// face with normal X for one voxel of the layer.  With (X,Y,Z) a
+// cyclic permutation of (x,y,z), e1 and e2 belong to the X
+// derivatives in the updates of eY and eZ and cb1 and cb2 to those in
+// the updates of cbY and cbZ.
+
+typedef struct pml_psi
+{
+  float e1, e2, cb1, cb2;
+} pml_psi_t;
+
+typedef struct sfa_pml
+{
+  int n_cell;          // Thickness of the layers in cells
+  int n_psi[6];        // Number of pml_psi of the layer of each face
+  pml_psi_t * psi[6];  // Layer of each face (NULL if not a pml face)
+} sfa_pml_t;
+
+// sfa_psatd holds the workspace of the spectral field solver.  It is
+// made on the first step and is not checkpointed.  c holds the spectra
+// of E, cB and jf of the nx x ny x nz owned voxels (x fastest, one
+// spectrum after the other) and line the 3 n_max complex of scratch of
+// each pipeline and the host.  For mode j of an axis with n cells of
+// size d and wavenumber k, dp is the staggered spectral derivative
+// i k exp( i k d / 2 ) and dy is the Yee backward difference
+// ( 1 - exp( -i k d ) ) / d.
+
+typedef struct psatd_complex
+{
+  double re, im;
+} psatd_complex_t;
+
+typedef struct sfa_psatd
+{
+  int n[3], n_max;
+  psatd_complex_t * tw[3];  // exp( -2 pi i j / n ) of each axis
+  psatd_complex_t * dp[3];  // Spectral derivative of each axis
+  psatd_complex_t * dy[3];  // Yee backward difference of each axis
+  psatd_complex_t * c;      // Spectra of ex ... cbz and jfx ... jfz
+  psatd_complex_t * line;   // Line scratch
+} sfa_psatd_t;
+
 typedef struct sfa_params
 {
   material_coefficient_t * mc;
   int n_mc;
   float damp;
+  sfa_pml_t * pml;     // Pml layers (NULL if none)
+  sfa_psatd_t * psatd; // Spectral solver workspace (NULL if none)
 } sfa_params_t;
 
 BEGIN_C_DECLS
@@ -82,6 +126,10 @@ void
 advance_e_pipeline( field_array_t * RESTRICT fa,
                     float frac );
 
+void
+advance_e_2d_pipeline( field_array_t * RESTRICT fa,
+                       float frac );
+
 void
 vacuum_advance_e( field_array_t * RESTRICT fa,
                   float frac );
@@ -90,6 +138,43 @@ void
 vacuum_advance_e_pipeline( field_array_t * RESTRICT fa,
                            float frac );
 
+// The 2d pipelines are for local domains with only one cell on some
+// axis.  The interior of the 3d pipelines is empty on those and all of
+// E would be updated serially as exterior fields.
+
+void
+vacuum_advance_e_2d_pipeline( field_array_t * RESTRICT fa,
+                              float frac );
+
+// vacuum_advance_e_exterior updates the tangential E on the surface of
+// the local domain.  The tangential B ghosts must be current.
+
+void
+vacuum_advance_e_exterior( field_array_t * RESTRICT fa );
+
+// In advance_fields.c
+
+// advance_fields does a full field time step:
+//   advance_b( fa, 0.5 ); advance_e( fa, 1 ); advance_b( fa, 0.5 );
+// using the kernels of fa.
+//
+// vacuum_advance_fields does the same for uniform regions in a single
+// cache blocked pass over the voxels.  Each z-slab is half advanced in
+// B, advanced in E and half advanced in B again while it is in cache
+// (a wavefront over z with the second B update one slab behind).  The
+// voxels on the surface of the local domain have their first B update
+// before the wavefront, so that the tangential B ghost exchange of
+// advance_e overlaps with it, and their E and second B updates after.
+
+void
+advance_fields( field_array_t * RESTRICT fa );
+
+void
+vacuum_advance_fields( field_array_t * RESTRICT fa );
+
+void
+vacuum_advance_fields_pipeline( field_array_t * RESTRICT fa );
+
 // In energy_f.c
 
 // This computes 6 components of field energy of the system.  The
@@ -372,6 +457,167 @@ clean_div_b( field_array_t * RESTRICT fa );
 void
 clean_div_b_pipeline( field_array_t * RESTRICT fa );
 
+// In soa.c
+
+// The SoA field array (see new_soa_field_array) keeps E, cB, TCA and
+// jf in planes.  The local and remote boundary functions below work
+// on the field_t array but only touch voxels with at least one index
+// in {0,1,2,n,n+1} (absorbing boundaries read E in layer 2).
+// soa_shell_to_f and soa_shell_from_f copy the requested components
+// of those voxels between the planes and the field_t array so that the
+// boundary functions can be used as is.
+
+enum soa_components {
+  soa_e   = 1,
+  soa_cb  = 2,
+  soa_tca = 4,
+  soa_jf  = 8
+};
+
+void
+soa_shell_to_f( field_array_t * RESTRICT fa,
+                int components );
+
+void
+soa_shell_from_f( field_array_t * RESTRICT fa,
+                  int components );
+
+// soa_has_local_bc returns nonzero if any face of the local domain
+// has the local boundary condition bc.
+
+int
+soa_has_local_bc( const grid_t * g,
+                  int bc );
+
+void
+delete_soa_field_array( field_array_t * RESTRICT fa );
+
+void
+soa_clear_jf( field_array_t * RESTRICT fa );
+
+void
+soa_synchronize_jf( field_array_t * RESTRICT fa );
+
+void
+soa_begin_synchronize_jf( field_array_t * RESTRICT fa );
+
+void
+soa_end_synchronize_jf( field_array_t * RESTRICT fa );
+
+// These unload the planes and call the vacuum kernels.
+
+void
+soa_energy_f( double * RESTRICT en, // 6 elem array
+              const field_array_t * RESTRICT fa );
+
+void
+soa_compute_rhob( field_array_t * RESTRICT fa );
+
+void
+soa_compute_curl_b( field_array_t * RESTRICT fa );
+
+double
+soa_synchronize_tang_e_norm_b( field_array_t * RESTRICT fa );
+
+void
+soa_compute_div_e_err( field_array_t * RESTRICT fa );
+
+void
+soa_clean_div_e( field_array_t * RESTRICT fa );
+
+void
+soa_compute_div_b_err( field_array_t * RESTRICT fa );
+
+void
+soa_clean_div_b( field_array_t * RESTRICT fa );
+
+// In soa_advance_b.c
+
+// soa_advance_b is advance_b on the planes of a SoA field array.
+
+void
+soa_advance_b( field_array_t * RESTRICT fa,
+               float frac );
+
+void
+soa_advance_b_pipeline( field_array_t * RESTRICT fa,
+                        float frac );
+
+// In soa_advance_e.c
+
+// soa_advance_e is vacuum_advance_e on the planes of a SoA field
+// array.
+
+void
+soa_advance_e( field_array_t * RESTRICT fa,
+               float frac );
+
+void
+soa_advance_e_pipeline( field_array_t * RESTRICT fa,
+                        float frac );
+
+// In pml.c
+
+// pml_advance_b and pml_advance_e are advance_b and vacuum_advance_e
+// followed by the convolutional pml corrections in the layers of the
+// local pml faces.
+
+void
+delete_pml_field_array( field_array_t * RESTRICT fa );
+
+void
+pml_advance_b( field_array_t * RESTRICT fa,
+               float frac );
+
+void
+pml_advance_e( field_array_t * RESTRICT fa,
+               float frac );
+
+// In ckc_advance_b.c
+
+// ckc_advance_b is advance_b with the Cole-Karkkainen extended curl.
+// It exchanges ghost E, so the ckc field array does the whole shared
+// current exchange in begin_synchronize_jf and ckc_end_synchronize_jf
+// does nothing.
+
+void
+ckc_advance_b( field_array_t * RESTRICT fa,
+               float frac );
+
+void
+ckc_advance_b_pipeline( field_array_t * RESTRICT fa,
+                        float frac );
+
+void
+ckc_end_synchronize_jf( field_array_t * RESTRICT fa );
+
+// In psatd_advance_e.c
+
+// psatd_advance_e advances E and cB together by frac dt with the
+// pseudo-spectral analytical time domain (PSATD) solution of the
+// vacuum Maxwell equations for a jf constant over the step.  The
+// derivatives are the exact spectral ones staggered like the Yee
+// differences, so there is no numerical dispersion and no Courant
+// limit.  The longitudinal part of jf is corrected so that the
+// spectral divergence of E follows the Yee divergence of jf, which is
+// what the charge conserving accumulation keeps consistent with rho.
+// psatd_advance_b does nothing; B is advanced with E.
+
+void
+delete_psatd_field_array( field_array_t * RESTRICT fa );
+
+void
+psatd_advance_b( field_array_t * RESTRICT fa,
+                 float frac );
+
+void
+psatd_advance_e( field_array_t * RESTRICT fa,
+                 float frac );
+
+void
+psatd_advance_e_pipeline( field_array_t * RESTRICT fa,
+                          float frac );
+
 // Internode functions
 
 // In remote.c
@@ -382,6 +628,12 @@ synchronize_tang_e_norm_b( field_array_t * RESTRICT fa );
 void
 synchronize_jf( field_array_t * RESTRICT fa );
 
+void
+begin_synchronize_jf( field_array_t * RESTRICT fa );
+
+void
+end_synchronize_jf( field_array_t * RESTRICT fa );
+
 void
 synchronize_rho( field_array_t * RESTRICT fa );
 
@@ -399,6 +651,14 @@ void
 local_ghost_div_b( field_t * ALIGNED(128) f,
                    const grid_t * g );
 
+// local_ghost_e sets all the ghost E just outside the local faces,
+// edges and corners included.  The far faces have no ghost nodes, so
+// only the normal E is set there.
+
+void
+local_ghost_e( field_t * ALIGNED(128) f,
+               const grid_t * g );
+
 void
 local_adjust_tang_e( field_t * ALIGNED(128) f,
                      const grid_t * g );
@@ -449,6 +709,19 @@ void
 end_remote_ghost_div_b( field_t * ALIGNED(128) f,
                         const grid_t * g );
 
+// remote_ghost_e fills all the ghost E from the neighboring domains,
+// edges and corners included.  remote_far_norm_b copies the normal B
+// on the first faces of the domains above to the far faces of the
+// domains below.
+
+void
+remote_ghost_e( field_t * ALIGNED(128) f,
+                const grid_t * g );
+
+void
+remote_far_norm_b( field_t * ALIGNED(128) f,
+                   const grid_t * g );
+
 END_C_DECLS
 
 #endif // _sfa_private_h_
@@ -0,0 +1,295 @@
+#define IN_sfa
+
+#include "sfa_private.h"
+
+// Copy components of the n voxels starting at voxel v between the
+// planes and the field_t array.
+
+static void
+copy_to_f( field_t           * RESTRICT ALIGNED(128) f,
+           const soa_field_t * RESTRICT              soa,
+           int v,
+           int n,
+           int components )
+{
+  const int v1 = v + n;
+  int i;
+
+# define COPY_PLANE(c) for( i = v; i < v1; i++ ) f[i].c = soa->c[i]
+
+  if ( components & soa_e )
+  {
+    COPY_PLANE( ex ); COPY_PLANE( ey ); COPY_PLANE( ez );
+  }
+  if ( components & soa_cb )
+  {
+    COPY_PLANE( cbx ); COPY_PLANE( cby ); COPY_PLANE( cbz );
+  }
+  if ( components & soa_tca )
+  {
+    COPY_PLANE( tcax ); COPY_PLANE( tcay ); COPY_PLANE( tcaz );
+  }
+  if ( components & soa_jf )
+  {
+    COPY_PLANE( jfx ); COPY_PLANE( jfy ); COPY_PLANE( jfz );
+  }
+
+# undef COPY_PLANE
+}
+
+static void
+copy_from_f( soa_field_t   * RESTRICT              soa,
+             const field_t * RESTRICT ALIGNED(128) f,
+             int v,
+             int n,
+             int components )
+{
+  const int v1 = v + n;
+  int i;
+
+# define COPY_PLANE(c) for( i = v; i < v1; i++ ) soa->c[i] = f[i].c
+
+  if ( components & soa_e )
+  {
+    COPY_PLANE( ex ); COPY_PLANE( ey ); COPY_PLANE( ez );
+  }
+  if ( components & soa_cb )
+  {
+    COPY_PLANE( cbx ); COPY_PLANE( cby ); COPY_PLANE( cbz );
+  }
+  if ( components & soa_tca )
+  {
+    COPY_PLANE( tcax ); COPY_PLANE( tcay ); COPY_PLANE( tcaz );
+  }
+  if ( components & soa_jf )
+  {
+    COPY_PLANE( jfx ); COPY_PLANE( jfy ); COPY_PLANE( jfz );
+  }
+
+# undef COPY_PLANE
+}
+
+#define ALL_COMPONENTS ( soa_e | soa_cb | soa_tca | soa_jf )
+
+void
+load_soa_field_array( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  if ( !fa->soa || !fa->soa->in_f )
+  {
+    return;
+  }
+
+  copy_from_f( fa->soa, fa->f, 0, fa->g->nv, ALL_COMPONENTS );
+
+  fa->soa->in_f = 0;
+}
+
+void
+unload_soa_field_array( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  if ( !fa->soa || fa->soa->in_f )
+  {
+    return;
+  }
+
+  copy_to_f( fa->f, fa->soa, 0, fa->g->nv, ALL_COMPONENTS );
+
+  fa->soa->in_f = 1;
+}
+
+// The shell is every voxel with at least one index in {0,1,2,n,n+1}.
+// Rows with y or z in the shell are copied whole; the other rows only
+// have x = 0, 1, 2, nx and nx+1 in the shell.
+
+#define SHELL_LOOP( COPY_ROW )                                          \
+  const int nx = fa->g->nx, ny = fa->g->ny, nz = fa->g->nz;             \
+  int y, z, v;                                                          \
+                                                                        \
+  for( z = 0; z <= nz+1; z++ )                                          \
+  {                                                                     \
+    for( y = 0; y <= ny+1; y++ )                                        \
+    {                                                                   \
+      v = VOXEL( 0, y, z, nx, ny, nz );                                 \
+                                                                        \
+      if ( z <= 2 || z >= nz || y <= 2 || y >= ny )                     \
+      {                                                                 \
+        COPY_ROW( v, nx+2 );                                            \
+      }                                                                 \
+      else                                                              \
+      {                                                                 \
+        COPY_ROW( v,      3 );                                          \
+        COPY_ROW( v + nx, 2 );                                          \
+      }                                                                 \
+    }                                                                   \
+  }
+
+void
+soa_shell_to_f( field_array_t * RESTRICT fa,
+                int components )
+{
+# define COPY_ROW( v, n ) copy_to_f( fa->f, fa->soa, (v), (n), components )
+
+  SHELL_LOOP( COPY_ROW );
+
+# undef COPY_ROW
+}
+
+void
+soa_shell_from_f( field_array_t * RESTRICT fa,
+                  int components )
+{
+# define COPY_ROW( v, n ) copy_from_f( fa->soa, fa->f, (v), (n), components )
+
+  SHELL_LOOP( COPY_ROW );
+
+# undef COPY_ROW
+}
+
+int
+soa_has_local_bc( const grid_t * g,
+                  int bc )
+{
+  return g->bc[ BOUNDARY( -1,  0,  0 ) ] == bc ||
+         g->bc[ BOUNDARY(  0, -1,  0 ) ] == bc ||
+         g->bc[ BOUNDARY(  0,  0, -1 ) ] == bc ||
+         g->bc[ BOUNDARY(  1,  0,  0 ) ] == bc ||
+         g->bc[ BOUNDARY(  0,  1,  0 ) ] == bc ||
+         g->bc[ BOUNDARY(  0,  0,  1 ) ] == bc;
+}
+
+//----------------------------------------------------------------------------//
+// Accumulator interface
+//----------------------------------------------------------------------------//
+
+void
+soa_clear_jf( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  load_soa_field_array( fa );
+
+  soa_field_t * RESTRICT soa = fa->soa;
+
+  const int nv = fa->g->nv;
+
+  for( int v = 0; v < nv; v++ ) soa->jfx[v] = 0;
+  for( int v = 0; v < nv; v++ ) soa->jfy[v] = 0;
+  for( int v = 0; v < nv; v++ ) soa->jfz[v] = 0;
+}
+
+void
+soa_synchronize_jf( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  load_soa_field_array( fa );
+
+  soa_shell_to_f( fa, soa_jf );
+
+  synchronize_jf( fa );
+
+  soa_shell_from_f( fa, soa_jf );
+}
+
+// The shared currents are exchanged from the field_t array so work that
+// only touches the planes can be done in between.
+
+void
+soa_begin_synchronize_jf( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  load_soa_field_array( fa );
+
+  soa_shell_to_f( fa, soa_jf );
+
+  begin_synchronize_jf( fa );
+}
+
+void
+soa_end_synchronize_jf( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  end_synchronize_jf( fa );
+
+  soa_shell_from_f( fa, soa_jf );
+}
+
+//----------------------------------------------------------------------------//
+// Kernels that are only called for diagnostics, at initialization or
+// every few steps work on the field_t array.
+//----------------------------------------------------------------------------//
+
+void
+soa_energy_f( double * RESTRICT en,
+              const field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  // Where E and cB live is not part of the observable state of fa.
+  unload_soa_field_array( (field_array_t *) fa );
+
+  vacuum_energy_f( en, fa );
+}
+
+#define SOA_WRAPPER( name, kernel )             \
+void                                            \
+soa_##name( field_array_t * RESTRICT fa )       \
+{                                               \
+  if ( !fa )                                    \
+  {                                             \
+    ERROR( ( "Bad args" ) );                    \
+  }                                             \
+                                                \
+  unload_soa_field_array( fa );                 \
+                                                \
+  kernel( fa );                                 \
+}
+
+SOA_WRAPPER( compute_rhob,      vacuum_compute_rhob      )
+SOA_WRAPPER( compute_curl_b,    vacuum_compute_curl_b    )
+SOA_WRAPPER( compute_div_e_err, vacuum_compute_div_e_err )
+SOA_WRAPPER( clean_div_e,       vacuum_clean_div_e       )
+SOA_WRAPPER( compute_div_b_err, compute_div_b_err        )
+SOA_WRAPPER( clean_div_b,       clean_div_b              )
+
+#undef SOA_WRAPPER
+
+double
+soa_synchronize_tang_e_norm_b( field_array_t * RESTRICT fa )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  unload_soa_field_array( fa );
+
+  return synchronize_tang_e_norm_b( fa );
+}
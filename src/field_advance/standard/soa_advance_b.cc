@@ -0,0 +1,20 @@
+#define IN_sfa
+
+#include "sfa_private.h"
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper soa_advance_b function.
+//----------------------------------------------------------------------------//
+
+void
+soa_advance_b( field_array_t * RESTRICT fa,
+               float _frac )
+{
+  if ( !fa )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  // Conditionally execute this when more abstractions are available.
+  soa_advance_b_pipeline( fa, _frac );
+}
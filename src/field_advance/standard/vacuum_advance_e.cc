@@ -21,5 +21,12 @@ vacuum_advance_e( field_array_t * RESTRICT fa,
   }
 
   // Conditionally execute this when more abstractions are available.
-  vacuum_advance_e_pipeline( fa, frac );
+  if ( fa->g->nx == 1 || fa->g->ny == 1 || fa->g->nz == 1 )
+  {
+    vacuum_advance_e_2d_pipeline( fa, frac );
+  }
+  else
+  {
+    vacuum_advance_e_pipeline( fa, frac );
+  }
 }
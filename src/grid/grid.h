@@ -24,10 +24,16 @@ enum grid_enums {
   symmetric_fields      = -2, // B_tang = 0, B_norm = 0
   pmc_fields            = -3, // B_tang = 0, B_norm floats
   absorb_fields         = -4, // Gamma = 0
+  pml_fields            = -5, // Perfectly matched layer backed by a pec
 
   // Phase 3 boundary conditions
   reflect_particles = -1, // Cell boundary should reflect particles
-  absorb_particles  = -2  // Cell boundary should absorb particles
+  absorb_particles  = -2, // Cell boundary should absorb particles
+
+  // Voxel orderings for sorting particles (see set_voxel_order)
+  voxel_order   = 0, // Sort particles in voxel index order
+  morton_order  = 1, // Sort particles along a Morton (Z-order) curve
+  hilbert_order = 2  // Sort particles along a Hilbert curve
 
   // Symmetry in the field boundary conditions refers to image charge
   // sign
@@ -67,6 +73,12 @@ enum grid_enums {
   // divergence errors on them. They assume that the ghost div b is
   // zero and force the surface div e on them to be zero. This means
   // ghost norm e can be set to any value on absorbing boundaries.
+  //
+  // Note: Pml boundaries are anti-symmetric boundaries as far as the
+  // boundary itself is concerned. The absorption happens in the
+  // layer of cells next to them and needs a field array with pml
+  // kernels (see new_pml_field_array). With other field arrays, they
+  // act as a pec.
 
 };
 
@@ -98,6 +110,10 @@ typedef struct grid {
                             // boundary conditions to apply at domain edge
                             // 0 ... nproc-1 ... comm boundary condition
                             // <0 ... locally applied boundary condition
+  int   corner_exchange;    // Nonzero if boundary_p sends particles
+                            // straight to the face, edge or corner
+                            // neighbour where they stop (the edge and
+                            // corner boundaries must be joined)
 
   // Phase 3 grid data structures
   // NOTE: VOXEL INDEXING LIMITS NUMBER OF VOXELS TO 2^31 (INCLUDING
@@ -125,6 +141,15 @@ typedef struct grid {
                           //   rangeh = range[rank+1]-1.
                           // Note: rangeh-rangel <~ 2^26
 
+  int * ALIGNED(128) sfc; // (0:local_num_voxel-1) indexed array giving
+                          // the sort key of the voxel with local index
+                          // "lidx".  Particles are sorted by the key of
+                          // their voxel and species partitions are
+                          // indexed by key.  The keys are a permutation
+                          // of the local voxel indices.  See
+                          // set_voxel_order.
+  int sfc_type;           // Voxel ordering used to compute sfc
+
   // Nearest neighbor communications ports
   mp_t * mp;
 
@@ -151,6 +176,17 @@ typedef struct grid {
 // instructions (none of the branches below are actual branches in
 // assembly).
 
+// Given a grid, return the largest sort key held by a non-ghost voxel.
+// Non-ghost voxels always have keys on [VOXEL(1,1,1),SFC_KEY_MAX(g)].
+// With voxel_order, the keys are the voxel indices.  Otherwise, the keys
+// of the non-ghost voxels are contiguous and those of the ghost voxels
+// follow.
+
+#define SFC_KEY_MAX(g)                                                  \
+  ( (g)->sfc_type==voxel_order ?                                        \
+    VOXEL((g)->nx,(g)->ny,(g)->nz, (g)->nx,(g)->ny,(g)->nz) :           \
+    VOXEL(1,1,1, (g)->nx,(g)->ny,(g)->nz) + (g)->nx*(g)->ny*(g)->nz - 1 )
+
 #define NEXT_VOXEL(v,x,y,z, xl,xh, yl,yh, zl,zh, nx,ny,nz) \
   (v)++;                                                   \
   (x)++;                                                   \
@@ -185,6 +221,22 @@ set_fbc( grid_t *g, int bound, int fbc );
 void
 set_pbc( grid_t *g, int bound, int pbc );
 
+// Set the order in which the voxels of the local domain are visited when
+// sorting particles.  Morton and Hilbert orders keep particles in voxels
+// that are close in all three directions close in the particle list.  This
+// should be called before particles are loaded.
+
+void
+set_voxel_order( grid_t *g, int order );
+
+// Turn on the edge and corner particle exchange.  The edge and corner
+// neighbors must be joined already and every joined neighbor must have
+// the same local resolution as this domain.  Everybody must call this
+// in parallel.
+
+void
+set_corner_exchange( grid_t *g );
+
 // In partition.c
 
 // g->{n,d}{x,y,z} is _coherent_ on all nodes in the domain after
@@ -240,6 +292,14 @@ partition_metal_box( grid_t *g,
                      int gnx, int gny, int gnz,
                      int gpx, int gpy, int gpz );
 
+// Join the edge and corner neighbors of a domain partitioned by the
+// above (with the same decomposition) for the edge and corner particle
+// exchange.
+
+void
+partition_join_corners( grid_t *g,
+                        int gpx, int gpy, int gpz );
+
 // In grid_comm.c
 
 // FIXME: SHOULD TAKE A RAW PORT INDEX INSTEAD OF A PORT COORDS
@@ -13,6 +13,134 @@
 #define LOCAL_CELL_ID(x,y,z)  VOXEL(x,y,z, lnx,lny,lnz)
 #define REMOTE_CELL_ID(x,y,z) VOXEL(x,y,z, rnx,rny,rnz)
 
+// Compute the position of the point (x,y,z) on [0,2^bits)^3 along a
+// Morton (Z-order) curve by interleaving the coordinate bits.
+
+static uint64_t
+morton_key( uint32_t x, uint32_t y, uint32_t z, int bits ) {
+  uint64_t key = 0;
+  int b;
+  for( b=bits-1; b>=0; b-- )
+    key = ( key << 3 ) | ( ( x >> b ) & 1 ) << 2
+                       | ( ( y >> b ) & 1 ) << 1
+                       | ( ( z >> b ) & 1 );
+  return key;
+}
+
+// Compute the position of the point (x,y,z) on [0,2^bits)^3 along a
+// Hilbert curve.  This converts the coordinates into the "transposed"
+// Hilbert index in place (J. Skilling, "Programming the Hilbert curve",
+// AIP Conf. Proc. 707, 381 (2004)) and then interleaves the bits of the
+// transposed index.
+
+static uint64_t
+hilbert_key( uint32_t x, uint32_t y, uint32_t z, int bits ) {
+  uint32_t X[3], M, P, Q, t;
+  int i;
+
+  X[0] = x; X[1] = y; X[2] = z;
+  M = 1u << ( bits-1 );
+
+  // Inverse undo excess work
+  for( Q=M; Q>1; Q>>=1 ) {
+    P = Q-1;
+    for( i=0; i<3; i++ )
+      if( X[i] & Q ) X[0] ^= P;
+      else {
+        t = ( X[0] ^ X[i] ) & P;
+        X[0] ^= t;
+        X[i] ^= t;
+      }
+  }
+
+  // Gray encode
+  for( i=1; i<3; i++ ) X[i] ^= X[i-1];
+  t = 0;
+  for( Q=M; Q>1; Q>>=1 ) if( X[2] & Q ) t ^= Q-1;
+  for( i=0; i<3; i++ ) X[i] ^= t;
+
+  return morton_key( X[0], X[1], X[2], bits );
+}
+
+typedef struct sfc_entry {
+  uint64_t key;
+  int v;
+} sfc_entry_t;
+
+static int
+compare_sfc_entry( const void * _a, const void * _b ) {
+  const sfc_entry_t * a = (const sfc_entry_t *)_a;
+  const sfc_entry_t * b = (const sfc_entry_t *)_b;
+  return ( a->key > b->key ) - ( a->key < b->key );
+}
+
+// Compute the voxel sort keys for the grid's current voxel ordering.
+// For voxel_order, the key of a voxel is its index.  Otherwise, the
+// non-ghost voxels are ranked along the curve and given the keys
+// VOXEL(1,1,1)+rank.  Ghost voxels before VOXEL(1,1,1) keep their index
+// and the remaining ghost voxels take the keys after the non-ghost ones
+// in voxel index order.  The curve covers the smallest power of two cube
+// containing the local domain.
+
+static void
+build_sfc( grid_t * g ) {
+  const int lnx = g->nx, lny = g->ny, lnz = g->nz;
+  sfc_entry_t * entry;
+  int x, y, z, v, vl, n, key, bits;
+
+  FREE_ALIGNED( g->sfc );
+  MALLOC_ALIGNED( g->sfc, g->nv, 128 );
+
+  if( g->sfc_type==voxel_order ) {
+    for( v=0; v<g->nv; v++ ) g->sfc[v] = v;
+    return;
+  }
+
+  for( bits=1; (1<<bits)<lnx || (1<<bits)<lny || (1<<bits)<lnz; bits++ );
+
+  MALLOC( entry, lnx*lny*lnz );
+
+  n = 0;
+  for( z=1; z<=lnz; z++ )
+    for( y=1; y<=lny; y++ )
+      for( x=1; x<=lnx; x++ ) {
+        entry[n].key = g->sfc_type==morton_order ?
+          morton_key(  x-1, y-1, z-1, bits ) :
+          hilbert_key( x-1, y-1, z-1, bits );
+        entry[n].v   = LOCAL_CELL_ID(x,y,z);
+        n++;
+      }
+
+  qsort( entry, n, sizeof(sfc_entry_t), compare_sfc_entry );
+
+  vl = LOCAL_CELL_ID(1,1,1);
+  for( v=0; v<vl; v++ ) g->sfc[v] = v;
+  for( key=0; key<n; key++ ) g->sfc[ entry[key].v ] = vl + key;
+  key = vl + n;
+  for( z=0; z<=lnz+1; z++ )
+    for( y=0; y<=lny+1; y++ )
+      for( x=0; x<=lnx+1; x++ ) {
+        v = LOCAL_CELL_ID(x,y,z);
+        if( v>=vl && ( x==0 || x==lnx+1 ||
+                       y==0 || y==lny+1 ||
+                       z==0 || z==lnz+1 ) ) g->sfc[v] = key++;
+      }
+
+  FREE( entry );
+}
+
+// Tell the mp which rank each port of the grid is connected to.
+
+static void
+connect_ports( grid_t * g ) {
+  int rank[27], b;
+  for( b=0; b<27; b++ ) {
+    rank[b] = g->bc[b];
+    if( b==BOUNDARY(0,0,0) || rank[b]<0 || rank[b]>=world_size ) rank[b] = -1;
+  }
+  mp_connect_ports( g->mp, rank );
+}
+
 // Everybody must size their local grid in parallel
 
 void
@@ -35,6 +163,7 @@ size_grid( grid_t * g,
       for( i=-1; i<=1; i++ ) 
         g->bc[ BOUNDARY(i,j,k) ] = pec_fields;
   g->bc[ BOUNDARY(0,0,0) ] = world_rank;
+  connect_ports( g );
 
   // Setup phase 3 data structures.  This is an ugly kludge to
   // interface phase 2 and phase 3 data structures
@@ -85,34 +214,9 @@ size_grid( grid_t * g,
         }
       }
 
-# if 0
-  // Setup the space filling curve
-  // FIXME: THIS IS A CRUDE HACK UNTIL A GOOD SFC CAN BE WRITTEN
-  // CURRENT SFC IS GOOD FOR THREADING WITH POWER-OF-TWO NUMBER OF THREADS.
-  // UP TO AND INCLUDING 8 THREADS.
-
-  FREE_ALIGNED( g->sfc );
-  MALLOC_ALIGNED( g->sfc, g->nv, 128 );
+  // Setup the space filling curve used to order voxels for sorting.
 
-  do {
-    int off;
-    int ox, oy, oz;
-    int nx, ny, nz;
-    int nx1 = (lnx+2)/2,   ny1 = (lny+2)/2,   nz1 = (lnz+2)/2;
-    int nx0 = (lnx+2)-nx1, ny0 = (lny+2)-ny1, nz0 = (lnz+2)-nz1;
-
-    for( z=0; z<=lnz+1; z++ )
-      for( y=0; y<=lny+1; y++ )
-        for( x=0; x<=lnx+1; x++ ) {
-          i = LOCAL_CELL_ID(x,y,z);
-          off = 0;
-          ox=x; nx=nx0; if(ox>=nx) ox-=nx, off+=nx,                 nx=nx1;
-          oy=y; ny=ny0; if(oy>=ny) oy-=ny, off+=ny*(lnx+2),         ny=ny1;
-          oz=z; nz=nz0; if(oz>=nz) oz-=nz, off+=nz*(lnx+2)*(lny+2), nz=nz1;
-          g->sfc[i] = off + ox + nx*( oy + ny*oz );
-        }
-  } while(0);
-# endif
+  build_sfc( g );
 }
 
 void
@@ -126,6 +230,7 @@ join_grid( grid_t * g,
 
   // Join phase 2 data structures
   g->bc[boundary] = rank;
+  connect_ports( g );
 
   // Join phase 3 data structures
   lnx = g->nx;
@@ -171,10 +276,12 @@ set_fbc( grid_t * g,
 
   if( !g || boundary<0 || boundary>=27 || boundary==BOUNDARY(0,0,0) ||
       ( fbc!=anti_symmetric_fields && fbc!=symmetric_fields &&
-        fbc!=pmc_fields            && fbc!=absorb_fields    ) )
+        fbc!=pmc_fields            && fbc!=absorb_fields    &&
+        fbc!=pml_fields ) )
     ERROR(( "Bad args" ));
 
   g->bc[boundary] = fbc;
+  connect_ports( g );
 }
 
 void
@@ -210,3 +317,47 @@ set_pbc( grid_t * g,
 # undef SET_PBC
 }
 
+void
+set_voxel_order( grid_t * g,
+                 int order ) {
+
+  if( !g || ( order!=voxel_order  &&
+              order!=morton_order &&
+              order!=hilbert_order ) )
+    ERROR(( "Bad args" ));
+
+  g->sfc_type = order;
+
+  // If the grid has not been sized yet, size_grid will build the keys.
+  if( g->nv ) build_sfc( g );
+}
+
+void
+set_corner_exchange( grid_t * g ) {
+  int n[3], * gn, b, rank;
+
+  if( !g || !g->nv ) ERROR(( "Bad args" ));
+
+  // The sender routes the particles through its neighbors' voxels
+  // using its own resolution.
+
+  n[0] = g->nx;
+  n[1] = g->ny;
+  n[2] = g->nz;
+  MALLOC( gn, 3*world_size );
+  mp_allgather_i( n, gn, 3 );
+
+  for( b=0; b<27; b++ ) {
+    rank = g->bc[b];
+    if( b==BOUNDARY(0,0,0) || rank<0 || rank>=world_size ) continue;
+    if( gn[3*rank+0]!=n[0] || gn[3*rank+1]!=n[1] || gn[3*rank+2]!=n[2] )
+      ERROR(( "The edge and corner exchange needs neighbors with the "
+              "same local resolution (%ix%ix%i here, %ix%ix%i on rank %i)",
+              n[0], n[1], n[2],
+              gn[3*rank+0], gn[3*rank+1], gn[3*rank+2], rank ));
+  }
+
+  FREE( gn );
+
+  g->corner_exchange = 1;
+}
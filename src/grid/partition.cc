@@ -25,9 +25,12 @@
 #define INDEX_TO_RANK(ix,iy,iz,rank) do {            \
     int _ix = (ix), _iy = (iy), _iz = (iz);          \
     /* Wrap processor index periodically */          \
-    while(_ix>=gpx) _ix-=gpx; while(_ix<0) _ix+=gpx; \
-    while(_iy>=gpy) _iy-=gpy; while(_iy<0) _iy+=gpy; \
-    while(_iz>=gpz) _iz-=gpz; while(_iz<0) _iz+=gpz; \
+    while(_ix>=gpx) _ix-=gpx;                        \
+    while(_ix<0)    _ix+=gpx;                        \
+    while(_iy>=gpy) _iy-=gpy;                        \
+    while(_iy<0)    _iy+=gpy;                        \
+    while(_iz>=gpz) _iz-=gpz;                        \
+    while(_iz<0)    _iz+=gpz;                        \
     /* Compute the rank */                           \
     (rank) = _ix + gpx*( _iy + gpy*_iz );            \
   } while(0)
@@ -89,6 +92,29 @@ partition_periodic_box( grid_t * g,
   INDEX_TO_RANK(px,  py,  pz+1,rank); join_grid(g,BOUNDARY( 0, 0, 1),rank);
 }
 
+void
+partition_join_corners( grid_t * g,
+                        int gpx, int gpy, int gpz ) {
+  int rank, px, py, pz, i, j, k;
+
+  if( !g ) ERROR(( "NULL grid" ));
+
+  if( gpx<1 || gpy<1 || gpz<1 || gpx*gpy*gpz!=world_size )
+    ERROR(( "Bad domain decompostion (%ix%ix%i)", gpx, gpy, gpz ));
+
+  RANK_TO_INDEX( world_rank, px,py,pz );
+
+  // The edge and corner neighbors are only used by the edge and corner
+  // particle exchange.  This only sets their bc.
+  for( k=-1; k<=1; k++ )
+    for( j=-1; j<=1; j++ )
+      for( i=-1; i<=1; i++ )
+        if( i*i+j*j+k*k>1 ) {
+          INDEX_TO_RANK(px+i,py+j,pz+k,rank);
+          join_grid(g,BOUNDARY(i,j,k),rank);
+        }
+}
+
 void
 partition_absorbing_box( grid_t * g,
                          double gx0, double gy0, double gz0,
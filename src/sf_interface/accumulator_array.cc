@@ -8,7 +8,9 @@
  *
  */
 
-#include "sf_interface.h"
+#define IN_sf_interface
+
+#include "sf_interface_private.h"
 
 static int
 aa_n_pipeline(void)
@@ -28,6 +30,38 @@ aa_n_pipeline(void)
   return n; // max( {serial,thread}.n_pipeline )
 }
 
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+
+// Pipeline particle ranges are contiguous in a sorted particle array.
+// So, the voxel ranges they cover overlap by at most one voxel and the
+// tile accumulators need at most nv + n_pipeline voxels plus a halo on
+// each side of each tile.  The tile accumulators are scratch and are
+// not checkpointed.
+
+static void
+alloc_accumulator_tiles( accumulator_array_t * aa )
+{
+  int n_pipeline = aa_n_pipeline();
+
+  aa->n_tile = aa->g->nv +
+               n_pipeline * ( 2 * ACCUMULATOR_TILE_HALO( aa->g ) + 1 );
+
+  MALLOC_ALIGNED( aa->tile, aa->n_tile, 128 );
+}
+
+#endif
+
+void
+set_accumulator_pushed( accumulator_array_t * aa,
+                        int everywhere )
+{
+  for( int r = 0; r < aa->n_pipeline; r++ )
+  {
+    aa->pushed[ 2*r     ] = everywhere ? 0              : aa->g->nv;
+    aa->pushed[ 2*r + 1 ] = everywhere ? aa->g->nv - 1 : -1;
+  }
+}
+
 void
 checkpt_accumulator_array( const accumulator_array_t * aa )
 {
@@ -51,12 +85,26 @@ restore_accumulator_array( void )
 
   RESTORE_PTR( aa->g );
 
+  // The restored pipeline accumulators are cleared before they are used
+  // again.
+
+  MALLOC( aa->pushed, 2 * aa->n_pipeline + 2 );
+
+  set_accumulator_pushed( aa, 1 );
+
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+  alloc_accumulator_tiles( aa );
+#else
+  aa->tile   = NULL;
+  aa->n_tile = 0;
+
   if ( aa->n_pipeline != aa_n_pipeline() )
   {
     ERROR( ( "Number of accumulators restored is not the same as the number of "
              "accumulators checkpointed.  Did you change the number of threads "
              "per process between checkpt and restore?" ) );
   }
+#endif
 
   return aa;
 }
@@ -73,12 +121,23 @@ new_accumulator_array( grid_t * g )
 
   MALLOC( aa, 1 );
 
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+  aa->n_pipeline = 0;
+#else
   aa->n_pipeline = aa_n_pipeline();
+#endif
 
   aa->stride     = POW2_CEIL( g->nv, 2 );
 
   aa->g          = g;
 
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+  alloc_accumulator_tiles( aa );
+#else
+  aa->tile       = NULL;
+  aa->n_tile     = 0;
+#endif
+
   MALLOC_ALIGNED( aa->a,
 		  (size_t) ( aa->n_pipeline + 1 ) * (size_t) aa->stride,
 		  128 );
@@ -86,6 +145,10 @@ new_accumulator_array( grid_t * g )
   CLEAR( aa->a,
 	 (size_t) ( aa->n_pipeline + 1 ) * (size_t) aa->stride );
 
+  MALLOC( aa->pushed, 2 * aa->n_pipeline + 2 );
+
+  set_accumulator_pushed( aa, 0 );
+
   REGISTER_OBJECT( aa,
 		   checkpt_accumulator_array,
 		   restore_accumulator_array,
@@ -104,7 +167,80 @@ delete_accumulator_array( accumulator_array_t * aa )
 
   UNREGISTER_OBJECT( aa );
 
+  FREE_ALIGNED( aa->tile );
+
+  FREE( aa->pushed );
+
   FREE_ALIGNED( aa->a );
 
   FREE( aa );
 }
+
+// The particles pushed into pipeline accumulator r+1 were in voxels
+// pushed[2*r]:pushed[2*r+1].  A particle that crosses at most one z
+// face in a push accumulates into its own z-plane and the z-planes next
+// to it (the push kernels mark the whole array as pushed into when a
+// particle can cross more).  If the local domain is periodic in z,
+// particles in the first and last z-planes can also wrap around into
+// the last and first z-planes.  Moves that wrap in x or y stay in the
+// z-plane.  Returns the (up to three) voxel ranges of pipeline
+// accumulator r+1 that may be nonzero in v[0:5].  Empty ranges are
+// reversed.
+
+void
+touched_accumulator_voxels( const accumulator_array_t * aa,
+                            int r,
+                            int * v )
+{
+  const grid_t * g = aa->g;
+
+  const int sz = g->sz;
+  const int vl = aa->pushed[ 2*r     ];
+  const int vh = aa->pushed[ 2*r + 1 ];
+
+  int64_t nn;
+
+  v[0] = 0, v[1] = -1;
+  v[2] = 0, v[3] = -1;
+  v[4] = 0, v[5] = -1;
+
+  if ( vl > vh ) return;
+
+  v[0] = ( vl / sz - 1 ) * sz;
+  v[1] = ( vh / sz + 2 ) * sz - 1;
+
+  if ( v[0] < 0         ) v[0] = 0;
+  if ( v[1] > g->nv - 1 ) v[1] = g->nv - 1;
+
+  nn = g->neighbor[ 6 * VOXEL( 1, 1, g->nz, g->nx, g->ny, g->nz ) + 5 ];
+
+  if ( nn >= g->rangel && nn <= g->rangeh )
+  {
+    if ( vl / sz <= 1     ) v[2] = g->nz*sz, v[3] = ( g->nz + 1 )*sz - 1;
+    if ( vh / sz >= g->nz ) v[4] = sz,       v[5] = 2*sz - 1;
+  }
+}
+
+// Returns nonzero if some pipeline accumulator is known to be zero on
+// some of the voxels reduce_accumulator_array reduces.
+
+int
+sparse_accumulator_array( const accumulator_array_t * aa )
+{
+  const grid_t * g = aa->g;
+
+  int v[6];
+
+  for( int r = 0; r < aa->n_pipeline; r++ )
+  {
+    touched_accumulator_voxels( aa, r, v );
+
+    if ( v[0] > VOXEL( 1,     1,     1,     g->nx, g->ny, g->nz ) ||
+         v[1] < VOXEL( g->nx, g->ny, g->nz, g->nx, g->ny, g->nz ) )
+    {
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -16,7 +16,17 @@ clear_accumulator_array( accumulator_array_t * RESTRICT aa )
   }
 
   // Conditionally execute this when more abstractions are available.
-  clear_accumulator_array_pipeline( aa );
+  if ( sparse_accumulator_array( aa ) )
+  {
+    clear_accumulator_array_sparse_pipeline( aa );
+  }
+
+  else
+  {
+    clear_accumulator_array_pipeline( aa );
+  }
+
+  set_accumulator_pushed( aa, 0 );
 }
 
 
@@ -7,6 +7,7 @@ checkpt_interpolator_array( const interpolator_array_t * ia )
 {
   CHECKPT( ia, 1 );
   CHECKPT_ALIGNED( ia->i, ia->g->nv, 128 );
+  if( ia->h ) CHECKPT_ALIGNED( ia->h, ia->g->nv, 128 );
   CHECKPT_PTR( ia->g );
 }
 
@@ -16,6 +17,7 @@ restore_interpolator_array( void )
   interpolator_array_t * ia;
   RESTORE( ia );
   RESTORE_ALIGNED( ia->i );
+  if( ia->h ) RESTORE_ALIGNED( ia->h );
   RESTORE_PTR( ia->g );
   return ia;
 }
@@ -29,6 +31,7 @@ new_interpolator_array( grid_t * g )
   MALLOC_ALIGNED( ia->i, g->nv, 128 );
   CLEAR( ia->i, g->nv );
   ia->g = g;
+  ia->h = NULL;
   REGISTER_OBJECT( ia, checkpt_interpolator_array, restore_interpolator_array,
                    NULL );
   return ia;
@@ -40,9 +43,23 @@ delete_interpolator_array( interpolator_array_t * ia )
   if( !ia ) return;
   UNREGISTER_OBJECT( ia );
   FREE_ALIGNED( ia->i );
+  FREE_ALIGNED( ia->h );
   FREE( ia );
 }
 
+void
+set_interpolator_array_bf16( interpolator_array_t * RESTRICT ia,
+                             int bf16 )
+{
+  if( !ia ) ERROR(( "Bad args" ));
+  if( bf16 && !ia->h ) {
+    MALLOC_ALIGNED( ia->h, ia->g->nv, 128 );
+    CLEAR( ia->h, ia->g->nv );
+  } else if( !bf16 ) {
+    FREE_ALIGNED( ia->h );
+  }
+}
+
 //----------------------------------------------------------------------------//
 // Top level function to select and call the proper load_interpolator_array
 // function.
@@ -59,6 +76,16 @@ load_interpolator_array( interpolator_array_t * RESTRICT ia,
     ERROR( ( "Bad args" ) );
   }
 
+  // Field arrays with SoA field storage are read from the planes when
+  // these are current.
+
+  if ( fa->soa && !fa->soa->in_f )
+  {
+    load_interpolator_array_soa_pipeline( ia, fa );
+
+    return;
+  }
+
   // Conditionally execute this when more abstractions are available.
   load_interpolator_array_pipeline( ia, fa );
 
@@ -131,3 +158,37 @@ load_interpolator_array( interpolator_array_t * RESTRICT ia,
   }
 # endif
 }
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper
+// advance_b_load_interpolator_array function.
+//----------------------------------------------------------------------------//
+
+void
+advance_b_load_interpolator_array( interpolator_array_t * RESTRICT ia,
+                                   field_array_t * RESTRICT fa,
+                                   float frac )
+{
+  if ( !ia              ||
+       !fa              ||
+       ia->g != fa->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  // The fused sweep gives each pipeline whole z slabs.  Other field
+  // arrays and domains too thin to keep the pipelines busy do the two
+  // passes.
+
+  if ( !has_yee_advance_b( fa ) || fa->g->nz < N_PIPELINE )
+  {
+    fa->kernel->advance_b( fa, frac );
+
+    load_interpolator_array( ia, fa );
+
+    return;
+  }
+
+  // Conditionally execute this when more abstractions are available.
+  advance_b_load_interpolator_array_pipeline( ia, fa, frac );
+}
@@ -0,0 +1,309 @@
+#define IN_sf_interface
+
+// The fused pipeline does the same floating point operations as
+// advance_b_pipeline_scalar, local_adjust_norm_b and
+// load_interpolator_pipeline_scalar so the results do not change in
+// scalar builds.  There are no explicit v4, v8 or v16 versions.
+
+#include "sf_interface_pipeline.h"
+
+#include "../sf_interface_private.h"
+
+#include "../../util/pipelines/pipelines_exec.h"
+
+#define fi(x,y,z) fi[ VOXEL( x, y, z, nx, ny, nz ) ]
+#define  f(x,y,z)  f[ VOXEL( x, y, z, nx, ny, nz ) ]
+
+// See advance_b_pipeline.h about the parenthesis under -ffast-math.
+
+#define UPDATE_CBX() f0->cbx -= ( py*( fy->ez-f0->ez ) - pz*( fz->ey-f0->ey ) )
+#define UPDATE_CBY() f0->cby -= ( pz*( fz->ex-f0->ex ) - px*( fx->ez-f0->ez ) )
+#define UPDATE_CBZ() f0->cbz -= ( px*( fx->ey-f0->ey ) - py*( fy->ex-f0->ex ) )
+
+// Advance the cB of the z slab z.  This is the cbx and cby of the
+// slab, including the far x and y faces, and the cbz of the z faces
+// below the voxels of the slab.  The last slab also does the far z
+// face.  Then the normal cB on the local symmetric faces is zeroed.
+
+static void
+advance_b_slab( const advance_b_load_interpolator_pipeline_args_t * args,
+                int z )
+{
+  field_t * ALIGNED(128) f = args->f;
+
+  field_t * ALIGNED(16) f0;
+  field_t * ALIGNED(16) fx, * ALIGNED(16) fy, * ALIGNED(16) fz;
+
+  int x, y;
+
+  const int nx = args->nx;
+  const int ny = args->ny;
+  const int nz = args->nz;
+
+  const float px = args->px;
+  const float py = args->py;
+  const float pz = args->pz;
+
+  const int sym = args->sym;
+
+  for( y = 1; y <= ny; y++ )
+  {
+    f0 = &f( 1,        y,        z        );
+    fx = &f( 1+(nx>1), y,        z        );
+    fy = &f( 1,        y+(ny>1), z        );
+    fz = &f( 1,        y,        z+(nz>1) );
+
+    for( x = 1; x <= nx; x++ )
+    {
+      UPDATE_CBX();
+      UPDATE_CBY();
+      UPDATE_CBZ();
+
+      f0++; fx++; fy++; fz++;
+    }
+
+    // Far x face of the row
+
+    f0 = &f( nx+1, y,   z   );
+    fy = &f( nx+1, y+1, z   );
+    fz = &f( nx+1, y,   z+1 );
+
+    UPDATE_CBX();
+  }
+
+  // Far y face of the slab
+
+  f0 = &f( 1, ny+1, z   );
+  fx = &f( 2, ny+1, z   );
+  fz = &f( 1, ny+1, z+1 );
+
+  for( x = 1; x <= nx; x++ )
+  {
+    UPDATE_CBY();
+
+    f0++; fx++; fz++;
+  }
+
+  // Far z face
+
+  if ( z == nz )
+  {
+    for( y = 1; y <= ny; y++ )
+    {
+      f0 = &f( 1, y,   nz+1 );
+      fx = &f( 2, y,   nz+1 );
+      fy = &f( 1, y+1, nz+1 );
+
+      for( x = 1; x <= nx; x++ )
+      {
+        UPDATE_CBZ();
+
+        f0++; fx++; fy++;
+      }
+    }
+  }
+
+  // Local symmetric faces
+
+  if ( sym & 1  ) for( y = 1; y <= ny; y++ ) f( 1,    y, z ).cbx = 0;
+  if ( sym & 8  ) for( y = 1; y <= ny; y++ ) f( nx+1, y, z ).cbx = 0;
+  if ( sym & 2  ) for( x = 1; x <= nx; x++ ) f( x, 1,    z ).cby = 0;
+  if ( sym & 16 ) for( x = 1; x <= nx; x++ ) f( x, ny+1, z ).cby = 0;
+
+  if ( ( sym & 4 ) && z == 1 )
+  {
+    for( y = 1; y <= ny; y++ )
+      for( x = 1; x <= nx; x++ )
+        f( x, y, 1 ).cbz = 0;
+  }
+
+  if ( ( sym & 32 ) && z == nz )
+  {
+    for( y = 1; y <= ny; y++ )
+      for( x = 1; x <= nx; x++ )
+        f( x, y, nz+1 ).cbz = 0;
+  }
+}
+
+// Load the interpolators of the z slab z.  cB of the slab and cbz of
+// the slab above must be finished.
+
+static void
+load_interpolator_slab( const advance_b_load_interpolator_pipeline_args_t * args,
+                        int z )
+{
+  interpolator_t      * ALIGNED(128) fi = args->fi;
+  interpolator_bf16_t * ALIGNED(128) fh = args->fh;
+  const field_t       * ALIGNED(128) f  = args->f;
+
+  interpolator_t * ALIGNED(16) pi;
+
+  const field_t  * ALIGNED(16) pf0;
+  const field_t  * ALIGNED(16) pfx,  * ALIGNED(16) pfy,  * ALIGNED(16) pfz;
+  const field_t  * ALIGNED(16) pfyz, * ALIGNED(16) pfzx, * ALIGNED(16) pfxy;
+
+  int x, y;
+
+  const int nx = args->nx;
+  const int ny = args->ny;
+
+  const float fourth = 0.25;
+  const float half   = 0.50;
+
+  float w0, w1, w2, w3;
+
+  for( y = 1; y <= ny; y++ )
+  {
+    pi   = &fi( 1, y,   z   );
+    pf0  =  &f( 1, y,   z   );
+    pfx  =  &f( 2, y,   z   );
+    pfy  =  &f( 1, y+1, z   );
+    pfz  =  &f( 1, y,   z+1 );
+    pfyz =  &f( 1, y+1, z+1 );
+    pfzx =  &f( 2, y,   z+1 );
+    pfxy =  &f( 2, y+1, z   );
+
+    for( x = 1; x <= nx; x++ )
+    {
+      // ex interpolation coefficients
+      w0 = pf0 ->ex;
+      w1 = pfy ->ex;
+      w2 = pfz ->ex;
+      w3 = pfyz->ex;
+
+      pi->ex       = fourth * ( ( w3 + w0 ) + ( w1 + w2 ) );
+      pi->dexdy    = fourth * ( ( w3 - w0 ) + ( w1 - w2 ) );
+      pi->dexdz    = fourth * ( ( w3 - w0 ) - ( w1 - w2 ) );
+      pi->d2exdydz = fourth * ( ( w3 + w0 ) - ( w1 + w2 ) );
+
+      // ey interpolation coefficients
+      w0 = pf0 ->ey;
+      w1 = pfz ->ey;
+      w2 = pfx ->ey;
+      w3 = pfzx->ey;
+
+      pi->ey       = fourth * ( ( w3 + w0 ) + ( w1 + w2 ) );
+      pi->deydz    = fourth * ( ( w3 - w0 ) + ( w1 - w2 ) );
+      pi->deydx    = fourth * ( ( w3 - w0 ) - ( w1 - w2 ) );
+      pi->d2eydzdx = fourth * ( ( w3 + w0 ) - ( w1 + w2 ) );
+
+      // ez interpolation coefficients
+      w0 = pf0 ->ez;
+      w1 = pfx ->ez;
+      w2 = pfy ->ez;
+      w3 = pfxy->ez;
+
+      pi->ez       = fourth * ( ( w3 + w0 ) + ( w1 + w2 ) );
+      pi->dezdx    = fourth * ( ( w3 - w0 ) + ( w1 - w2 ) );
+      pi->dezdy    = fourth * ( ( w3 - w0 ) - ( w1 - w2 ) );
+      pi->d2ezdxdy = fourth * ( ( w3 + w0 ) - ( w1 + w2 ) );
+
+      // bx interpolation coefficients
+      w0 = pf0->cbx;
+      w1 = pfx->cbx;
+
+      pi->cbx    = half * ( w1 + w0 );
+      pi->dcbxdx = half * ( w1 - w0 );
+
+      // by interpolation coefficients
+      w0 = pf0->cby;
+      w1 = pfy->cby;
+
+      pi->cby    = half * ( w1 + w0 );
+      pi->dcbydy = half * ( w1 - w0 );
+
+      // bz interpolation coefficients
+      w0 = pf0->cbz;
+      w1 = pfz->cbz;
+
+      pi->cbz    = half * ( w1 + w0 );
+      pi->dcbzdz = half * ( w1 - w0 );
+
+      if ( fh ) store_interpolator_bf16( fh + ( pi - fi ), pi );
+
+      pi++; pf0++; pfx++; pfy++; pfz++; pfyz++; pfzx++; pfxy++;
+    }
+  }
+}
+
+void
+advance_b_load_interpolator_pipeline_scalar( advance_b_load_interpolator_pipeline_args_t * args,
+                                             int pipeline_rank,
+                                             int n_pipeline )
+{
+  int z, z0, n_slab;
+
+  // Process the z slabs assigned to this pipeline
+
+  if ( pipeline_rank == n_pipeline ) return; // No straggler cleanup needed
+
+  DISTRIBUTE( args->nz, 1, pipeline_rank, n_pipeline, z0, n_slab );
+
+  if ( !n_slab ) return;
+
+  z0++;
+
+  if ( args->stage == 0 )
+  {
+    // Load each slab one slab behind the advance, when the cbz above
+    // it is finished.
+
+    for( z = z0; z < z0 + n_slab; z++ )
+    {
+      advance_b_slab( args, z );
+
+      if ( z > z0 ) load_interpolator_slab( args, z-1 );
+    }
+  }
+  else
+  {
+    load_interpolator_slab( args, z0 + n_slab - 1 );
+  }
+}
+
+void
+advance_b_load_interpolator_array_pipeline( interpolator_array_t * RESTRICT ia,
+                                            field_array_t * RESTRICT fa,
+                                            float frac )
+{
+  DECLARE_ALIGNED_ARRAY( advance_b_load_interpolator_pipeline_args_t, 128, args, 1 );
+
+  if ( !ia              ||
+       !fa              ||
+       ia->g != fa->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  const grid_t * g = fa->g;
+
+  args->fi = ia->i;
+  args->fh = ia->h;
+  args->f  = fa->f;
+  args->nx = g->nx;
+  args->ny = g->ny;
+  args->nz = g->nz;
+  args->px = ( g->nx > 1 ) ? frac*g->cvac*g->dt*g->rdx : 0;
+  args->py = ( g->ny > 1 ) ? frac*g->cvac*g->dt*g->rdy : 0;
+  args->pz = ( g->nz > 1 ) ? frac*g->cvac*g->dt*g->rdz : 0;
+
+  args->sym = 0;
+  if ( g->bc[ BOUNDARY( -1,  0,  0 ) ] == symmetric_fields ) args->sym |= 1;
+  if ( g->bc[ BOUNDARY(  0, -1,  0 ) ] == symmetric_fields ) args->sym |= 2;
+  if ( g->bc[ BOUNDARY(  0,  0, -1 ) ] == symmetric_fields ) args->sym |= 4;
+  if ( g->bc[ BOUNDARY(  1,  0,  0 ) ] == symmetric_fields ) args->sym |= 8;
+  if ( g->bc[ BOUNDARY(  0,  1,  0 ) ] == symmetric_fields ) args->sym |= 16;
+  if ( g->bc[ BOUNDARY(  0,  0,  1 ) ] == symmetric_fields ) args->sym |= 32;
+
+  args->stage = 0;
+
+  EXEC_PIPELINES( advance_b_load_interpolator, args, 0 );
+
+  WAIT_PIPELINES();
+
+  args->stage = 1;
+
+  EXEC_PIPELINES( advance_b_load_interpolator, args, 0 );
+
+  WAIT_PIPELINES();
+}
@@ -22,8 +22,9 @@ load_interpolator_pipeline_scalar( load_interpolator_pipeline_args_t * args,
                                    int pipeline_rank,
                                    int n_pipeline )
 {
-  interpolator_t * ALIGNED(128) fi = args->fi;
-  const field_t  * ALIGNED(128) f  = args->f;
+  interpolator_t      * ALIGNED(128) fi = args->fi;
+  interpolator_bf16_t * ALIGNED(128) fh = args->fh;
+  const field_t       * ALIGNED(128) f  = args->f;
 
   interpolator_t * ALIGNED(16) pi;
 
@@ -120,6 +121,8 @@ load_interpolator_pipeline_scalar( load_interpolator_pipeline_args_t * args,
     pi->cbz    = half * ( w1 + w0 );
     pi->dcbzdz = half * ( w1 - w0 );
 
+    if ( fh ) store_interpolator_bf16( fh + ( pi - fi ), pi );
+
     pi++; pf0++; pfx++; pfy++; pfz++; pfyz++; pfzx++; pfxy++;
 
     x++;
@@ -143,8 +146,9 @@ load_interpolator_pipeline_v4( load_interpolator_pipeline_args_t * args,
                                int pipeline_rank,
                                int n_pipeline )
 {
-  interpolator_t * ALIGNED(128) fi = args->fi;
-  const field_t  * ALIGNED(128) f  = args->f;
+  interpolator_t      * ALIGNED(128) fi = args->fi;
+  interpolator_bf16_t * ALIGNED(128) fh = args->fh;
+  const field_t       * ALIGNED(128) f  = args->f;
 
   interpolator_t * ALIGNED(16) pi;
 
@@ -236,6 +240,8 @@ load_interpolator_pipeline_v4( load_interpolator_pipeline_args_t * args,
 
     store_4x1( half * ( w1 + w0 ), &pi->cbz ); // Note: Padding after bz coeff.
 
+    if ( fh ) store_interpolator_bf16( fh + ( pi - fi ), pi );
+
     pi++; pf0++; pfx++; pfy++; pfz++; pfyz++; pfzx++; pfxy++;
 
     x++;
@@ -342,6 +348,7 @@ load_interpolator_array_pipeline( interpolator_array_t * RESTRICT ia,
 # endif
 
   args->fi = ia->i;
+  args->fh = ia->h;
   args->f  = fa->f;
   args->nb = ia->g->neighbor;
   args->nx = ia->g->nx;
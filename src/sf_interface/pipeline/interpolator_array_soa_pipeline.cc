@@ -0,0 +1,148 @@
+#define IN_sf_interface
+
+// The SoA pipeline works on rows along x.  The field planes are unit
+// stride so the row loops are vectorized by the compiler and there are
+// no explicit v4, v8 or v16 versions.
+
+#include "sf_interface_pipeline.h"
+
+#include "../sf_interface_private.h"
+
+#include "../../util/pipelines/pipelines_exec.h"
+
+void
+load_interpolator_soa_pipeline_scalar( load_interpolator_soa_pipeline_args_t * args,
+                                       int pipeline_rank,
+                                       int n_pipeline )
+{
+  interpolator_t      * RESTRICT ALIGNED(128) fi  = args->fi;
+  interpolator_bf16_t * RESTRICT ALIGNED(128) fh  = args->fh;
+  const soa_field_t   *                       soa = args->soa;
+
+  const float * RESTRICT ALIGNED(128) ex  = soa->ex;
+  const float * RESTRICT ALIGNED(128) ey  = soa->ey;
+  const float * RESTRICT ALIGNED(128) ez  = soa->ez;
+  const float * RESTRICT ALIGNED(128) cbx = soa->cbx;
+  const float * RESTRICT ALIGNED(128) cby = soa->cby;
+  const float * RESTRICT ALIGNED(128) cbz = soa->cbz;
+
+  interpolator_t * ALIGNED(16) pi;
+
+  int i, v, y, z, r, n_row;
+
+  const int nx = args->nx;
+  const int ny = args->ny;
+  const int nz = args->nz;
+
+  const int sy = nx + 2;
+  const int sz = sy * ( ny + 2 );
+
+  const float fourth = 0.25;
+  const float half   = 0.50;
+
+  float w0, w1, w2, w3;
+
+  // Process the rows assigned to this pipeline.  Rows are y = 1:ny,
+  // z = 1:nz and the host gets none.
+
+  DISTRIBUTE( ny*nz, 1, pipeline_rank, n_pipeline, r, n_row );
+
+  for( ; n_row; n_row--, r++ )
+  {
+    y = r%ny + 1;
+    z = r/ny + 1;
+    v = VOXEL( 1, y, z, nx, ny, nz );
+
+    for( i = v; i < v + nx; i++ )
+    {
+      pi = fi + i;
+
+      // ex interpolation coefficients
+      w0 = ex[i      ];
+      w1 = ex[i+sy   ];
+      w2 = ex[i   +sz];
+      w3 = ex[i+sy+sz];
+
+      pi->ex       = fourth * ( ( w3 + w0 ) + ( w1 + w2 ) );
+      pi->dexdy    = fourth * ( ( w3 - w0 ) + ( w1 - w2 ) );
+      pi->dexdz    = fourth * ( ( w3 - w0 ) - ( w1 - w2 ) );
+      pi->d2exdydz = fourth * ( ( w3 + w0 ) - ( w1 + w2 ) );
+
+      // ey interpolation coefficients
+      w0 = ey[i     ];
+      w1 = ey[i+sz  ];
+      w2 = ey[i   +1];
+      w3 = ey[i+sz+1];
+
+      pi->ey       = fourth * ( ( w3 + w0 ) + ( w1 + w2 ) );
+      pi->deydz    = fourth * ( ( w3 - w0 ) + ( w1 - w2 ) );
+      pi->deydx    = fourth * ( ( w3 - w0 ) - ( w1 - w2 ) );
+      pi->d2eydzdx = fourth * ( ( w3 + w0 ) - ( w1 + w2 ) );
+
+      // ez interpolation coefficients
+      w0 = ez[i     ];
+      w1 = ez[i+1   ];
+      w2 = ez[i  +sy];
+      w3 = ez[i+1+sy];
+
+      pi->ez       = fourth * ( ( w3 + w0 ) + ( w1 + w2 ) );
+      pi->dezdx    = fourth * ( ( w3 - w0 ) + ( w1 - w2 ) );
+      pi->dezdy    = fourth * ( ( w3 - w0 ) - ( w1 - w2 ) );
+      pi->d2ezdxdy = fourth * ( ( w3 + w0 ) - ( w1 + w2 ) );
+
+      // bx interpolation coefficients
+      w0 = cbx[i  ];
+      w1 = cbx[i+1];
+
+      pi->cbx    = half * ( w1 + w0 );
+      pi->dcbxdx = half * ( w1 - w0 );
+
+      // by interpolation coefficients
+      w0 = cby[i   ];
+      w1 = cby[i+sy];
+
+      pi->cby    = half * ( w1 + w0 );
+      pi->dcbydy = half * ( w1 - w0 );
+
+      // bz interpolation coefficients
+      w0 = cbz[i   ];
+      w1 = cbz[i+sz];
+
+      pi->cbz    = half * ( w1 + w0 );
+      pi->dcbzdz = half * ( w1 - w0 );
+    }
+
+    // Round the row to bf16 outside the vectorized loop.
+
+    if ( fh )
+    {
+      for( i = v; i < v + nx; i++ ) store_interpolator_bf16( fh + i, fi + i );
+    }
+  }
+}
+
+void
+load_interpolator_array_soa_pipeline( interpolator_array_t * RESTRICT ia,
+                                      const field_array_t * RESTRICT fa )
+{
+  DECLARE_ALIGNED_ARRAY( load_interpolator_soa_pipeline_args_t, 128, args, 1 );
+
+  if ( !ia              ||
+       !fa              ||
+       !fa->soa         ||
+       ia->g != fa->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  args->fi  = ia->i;
+  args->fh  = ia->h;
+  args->soa = fa->soa;
+  args->nx  = ia->g->nx;
+  args->ny  = ia->g->ny;
+  args->nz  = ia->g->nz;
+
+  EXEC_PIPELINES( load_interpolator_soa, args, 0 );
+
+  WAIT_PIPELINES();
+}
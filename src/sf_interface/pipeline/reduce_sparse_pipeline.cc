@@ -0,0 +1,176 @@
+#define IN_sf_interface
+
+#include "sf_interface_pipeline.h"
+
+#include "../sf_interface_private.h"
+
+#include "../../util/pipelines/pipelines_exec.h"
+
+// Blocks are assigned to the pipelines whole and the host gets none.
+// The accumulators are sums starting from +0 so they are never -0 and
+// adding a pipeline accumulator that is zero on a block does not change
+// anything.  A block with one nonzero pipeline accumulator is the host
+// accumulator plus it in any order of the horizontal reduction.  There
+// are no explicit v4, v8 or v16 versions.
+
+void
+reduce_sparse_pipeline_scalar( reduce_sparse_pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline )
+{
+  DECLARE_ALIGNED_ARRAY( reduce_pipeline_args_t, 128, block, 1 );
+
+  const int nfloats = sizeof( accumulator_t ) / sizeof( float );
+  const int nr      = args->n_array - 1;
+  const int sr      = args->s_array * nfloats;
+  const int vn      = args->v0 + args->n - 1;
+
+  int b, n_b, v, v1, r, rt, nt, k, n;
+
+  DISTRIBUTE( ( args->n + accumulators_sparse_n_voxel - 1 ) /
+              accumulators_sparse_n_voxel,
+              1, pipeline_rank, n_pipeline, b, n_b );
+
+  for( ; n_b; n_b--, b++ )
+  {
+    v  = args->v0 + b * accumulators_sparse_n_voxel;
+    v1 = v + accumulators_sparse_n_voxel - 1;
+    if ( v1 > vn ) v1 = vn;
+
+    nt = 0;
+    rt = 0;
+
+    for( r = 0; r < nr; r++ )
+    {
+      if ( accumulator_block_touched( args->touched + 6*r, v, v1 ) )
+      {
+        nt++;
+        rt = r;
+      }
+    }
+
+    if ( nt == 0 ) continue;
+
+    n = ( v1 - v + 1 ) * nfloats;
+
+    if ( nt == 1 )
+    {
+      /**/  float * RESTRICT ALIGNED(16) a = (float *) ( args->a + v );
+      const float * RESTRICT ALIGNED(16) c = a + ( rt + 1 ) * sr;
+
+      for( k = 0; k < n; k++ ) a[k] += c[k];
+    }
+
+    else
+    {
+      block->a       = (float *) ( args->a + v );
+      block->n       = n;
+      block->n_array = args->n_array;
+      block->s_array = sr;
+      block->n_block = 1;
+
+      reduce_array_pipeline_scalar( block, 0, 1 );
+    }
+  }
+}
+
+void
+clear_sparse_pipeline_scalar( reduce_sparse_pipeline_args_t * args,
+                              int pipeline_rank,
+                              int n_pipeline )
+{
+  const int nr = args->n_array - 1;
+  const int vn = args->v0 + args->n - 1;
+
+  int b, n_b, v, v1, r;
+
+  DISTRIBUTE( ( args->n + accumulators_sparse_n_voxel - 1 ) /
+              accumulators_sparse_n_voxel,
+              1, pipeline_rank, n_pipeline, b, n_b );
+
+  for( ; n_b; n_b--, b++ )
+  {
+    v  = args->v0 + b * accumulators_sparse_n_voxel;
+    v1 = v + accumulators_sparse_n_voxel - 1;
+    if ( v1 > vn ) v1 = vn;
+
+    CLEAR( args->a + v, v1 - v + 1 );
+
+    for( r = 0; r < nr; r++ )
+    {
+      if ( accumulator_block_touched( args->touched + 6*r, v, v1 ) )
+      {
+        CLEAR( args->a + ( r + 1 ) * args->s_array + v, v1 - v + 1 );
+      }
+    }
+  }
+}
+
+#define VOX( x, y, z ) VOXEL( x, y, z, aa->g->nx, aa->g->ny, aa->g->nz )
+
+// Set up the arguments of the sparse pipelines.  The voxels are the
+// same as those of reduce_accumulator_array_pipeline.
+
+static void
+setup_sparse_args( reduce_sparse_pipeline_args_t * args,
+                   int * touched,
+                   const accumulator_array_t * aa )
+{
+  int i0, na;
+
+  i0 = ( VOX( 1, 1, 1 ) / 2 ) * 2; // Round i0 down to even for 128 byte align.
+
+  na = ( ( ( VOX( aa->g->nx, aa->g->ny, aa->g->nz ) - i0 + 1 ) + 1 ) / 2 ) * 2;
+
+  for( int r = 0; r < aa->n_pipeline; r++ )
+  {
+    touched_accumulator_voxels( aa, r, touched + 6*r );
+  }
+
+  args->a       = aa->a;
+  args->touched = touched;
+  args->v0      = i0;
+  args->n       = na;
+  args->n_array = aa->n_pipeline + 1;
+  args->s_array = aa->stride;
+}
+
+#undef VOX
+
+void
+reduce_accumulator_array_sparse_pipeline( accumulator_array_t * RESTRICT aa )
+{
+  DECLARE_ALIGNED_ARRAY( reduce_sparse_pipeline_args_t, 128, args, 1 );
+
+  DECLARE_ALIGNED_ARRAY( int, 16, touched, 6 * MAX_PIPELINE );
+
+  if ( ! aa || aa->n_pipeline > MAX_PIPELINE )
+  {
+    ERROR( ( "Bad args." ) );
+  }
+
+  setup_sparse_args( args, touched, aa );
+
+  EXEC_PIPELINES( reduce_sparse, args, 0 );
+
+  WAIT_PIPELINES();
+}
+
+void
+clear_accumulator_array_sparse_pipeline( accumulator_array_t * RESTRICT aa )
+{
+  DECLARE_ALIGNED_ARRAY( reduce_sparse_pipeline_args_t, 128, args, 1 );
+
+  DECLARE_ALIGNED_ARRAY( int, 16, touched, 6 * MAX_PIPELINE );
+
+  if ( ! aa || aa->n_pipeline > MAX_PIPELINE )
+  {
+    ERROR( ( "Bad args." ) );
+  }
+
+  setup_sparse_args( args, touched, aa );
+
+  EXEC_PIPELINES( clear_sparse, args, 0 );
+
+  WAIT_PIPELINES();
+}
@@ -12,14 +12,15 @@
 
 typedef struct load_interpolator_pipeline_args
 {
-  MEM_PTR( interpolator_t, 128 ) fi;
-  MEM_PTR( const field_t,  128 ) f;
-  MEM_PTR( const int64_t,  128 ) nb;
+  MEM_PTR( interpolator_t,      128 ) fi;
+  MEM_PTR( interpolator_bf16_t, 128 ) fh; // BF16 copy (NULL if none)
+  MEM_PTR( const field_t,       128 ) f;
+  MEM_PTR( const int64_t,       128 ) nb;
   int nx;
   int ny;
   int nz;
 
-  PAD_STRUCT( 3*SIZEOF_MEM_PTR + 3*sizeof(int) )
+  PAD_STRUCT( 4*SIZEOF_MEM_PTR + 3*sizeof(int) )
 
 } load_interpolator_pipeline_args_t;
 
@@ -33,6 +34,56 @@ load_interpolator_pipeline_v4( load_interpolator_pipeline_args_t * args,
                                int pipeline_rank,
                                int n_pipeline );
 
+// The SoA versions read the fields from the planes of a soa_field_t.
+
+typedef struct load_interpolator_soa_pipeline_args
+{
+  MEM_PTR( interpolator_t,      128 ) fi;
+  MEM_PTR( interpolator_bf16_t, 128 ) fh;  // BF16 copy (NULL if none)
+  MEM_PTR( const soa_field_t,   128 ) soa;
+  int nx;
+  int ny;
+  int nz;
+
+  PAD_STRUCT( 3*SIZEOF_MEM_PTR + 3*sizeof(int) )
+
+} load_interpolator_soa_pipeline_args_t;
+
+void
+load_interpolator_soa_pipeline_scalar( load_interpolator_soa_pipeline_args_t * args,
+                                       int pipeline_rank,
+                                       int n_pipeline );
+
+// The fused versions do the final advance_b of a field array with the
+// Yee advance_b and load the interpolators of each z slab as its cB is
+// finished.  They are run in two stages.  The first advances the slabs
+// of each pipeline and loads all but its last slab, which needs cbz of
+// the first slab of the next pipeline.  The second loads the last slab.
+
+typedef struct advance_b_load_interpolator_pipeline_args
+{
+  MEM_PTR( interpolator_t,      128 ) fi;
+  MEM_PTR( interpolator_bf16_t, 128 ) fh; // BF16 copy (NULL if none)
+  MEM_PTR( field_t,             128 ) f;
+  int nx;
+  int ny;
+  int nz;
+  float px;                              // x-axis advance_b coefficient
+  float py;                              // y-axis advance_b coefficient
+  float pz;                              // z-axis advance_b coefficient
+  int sym;                               // Local symmetric faces (bit f
+                                         // for face f of -x,-y,-z,+x,+y,+z)
+  int stage;
+
+  PAD_STRUCT( 3*SIZEOF_MEM_PTR + 5*sizeof(int) + 3*sizeof(float) )
+
+} advance_b_load_interpolator_pipeline_args_t;
+
+void
+advance_b_load_interpolator_pipeline_scalar( advance_b_load_interpolator_pipeline_args_t * args,
+                                             int pipeline_rank,
+                                             int n_pipeline );
+
 ///////////////////////////////////////////////////////////////////////////////
 
 typedef struct unload_accumulator_pipeline_args
@@ -55,6 +106,56 @@ unload_accumulator_pipeline_scalar( unload_accumulator_pipeline_args_t * args,
                                     int pipeline_rank,
                                     int n_pipeline );
 
+typedef struct unload_accumulator_soa_pipeline_args
+{
+  MEM_PTR( soa_field_t, 128 ) soa;       // Reduce accumulators to these planes
+  MEM_PTR( const accumulator_t, 128 ) a; // Accumulator array to reduce
+  int nx;                                // Local domain x-resolution
+  int ny;                                // Local domain y-resolution
+  int nz;                                // Local domain z-resolution
+  float cx;                              // x-axis coupling constant
+  float cy;                              // y-axis coupling constant
+  float cz;                              // z-axis coupling constant
+
+  PAD_STRUCT( 2*SIZEOF_MEM_PTR + 3*sizeof(int) + 3*sizeof(float) )
+
+} unload_accumulator_soa_pipeline_args_t;
+
+void
+unload_accumulator_soa_pipeline_scalar( unload_accumulator_soa_pipeline_args_t * args,
+                                        int pipeline_rank,
+                                        int n_pipeline );
+
+// The fused version writes jf of the rows y = 1:ny+1, z = 1:nz+1
+// instead of adding to it, applies the local boundary adjustment of
+// local_adjust_jf to each row and packs the ends of each row into the
+// x-face sends of synchronize_jf.  The host clears the ghost jf the
+// rows do not cover.
+
+typedef struct unload_accumulator_sync_pipeline_args
+{
+  MEM_PTR( field_t, 128 ) f;             // Unload accumulators to this
+  MEM_PTR( const accumulator_t, 128 ) a; // Accumulator array to unload
+  MEM_PTR( float, 16 ) sx0;              // -x face send (NULL if none)
+  MEM_PTR( float, 16 ) sx1;              // +x face send (NULL if none)
+  int nx;                                // Local domain x-resolution
+  int ny;                                // Local domain y-resolution
+  int nz;                                // Local domain z-resolution
+  float cx;                              // x-axis coupling constant
+  float cy;                              // y-axis coupling constant
+  float cz;                              // z-axis coupling constant
+  float w[6];                            // Tangential jf scale of the
+                                         // -x,-y,-z,+x,+y,+z faces
+
+  PAD_STRUCT( 4*SIZEOF_MEM_PTR + 3*sizeof(int) + 9*sizeof(float) )
+
+} unload_accumulator_sync_pipeline_args_t;
+
+void
+unload_accumulator_sync_pipeline_scalar( unload_accumulator_sync_pipeline_args_t * args,
+                                         int pipeline_rank,
+                                         int n_pipeline );
+
 ///////////////////////////////////////////////////////////////////////////////
 // clear_array_pipeline interface
 
@@ -81,6 +182,48 @@ clear_array_pipeline_scalar( reduce_pipeline_args_t * args,
                              int pipeline_rank,
                              int n_pipeline );
 
+// The sparse versions work on blocks of accumulators_sparse_n_voxel
+// voxels and skip the pipeline accumulators that are zero on a block
+// (see touched_accumulator_voxels).  Blocks with one nonzero pipeline
+// accumulator are reduced by adding it and blocks with more by the
+// horizontal reduction, so the results are the same.  The clear also
+// clears the host accumulator.
+
+enum { accumulators_sparse_n_voxel = 64 };
+
+typedef struct reduce_sparse_pipeline_args
+{
+  MEM_PTR( accumulator_t, 128 ) a;   // Host accumulator array
+  MEM_PTR( const int, 16 ) touched;  // Voxel ranges touched[6*r:6*r+5]
+  /**/                               // of pipeline accumulator r+1
+  /**/                               // may be nonzero
+  int v0;                            // First voxel to reduce
+  int n;                             // Number of voxels to reduce
+  int n_array;                       // Number of pipeline arrays
+  int s_array;                       // Stride between each array
+
+  PAD_STRUCT( 2*SIZEOF_MEM_PTR + 4*sizeof(int) )
+
+} reduce_sparse_pipeline_args_t;
+
+// Returns nonzero if voxels v:v1 are in one of the three voxel ranges
+// of touched.
+
+static inline int
+accumulator_block_touched( const int * touched,
+                           int v,
+                           int v1 )
+{
+  return ( touched[0] <= v1 && touched[1] >= v ) ||
+         ( touched[2] <= v1 && touched[3] >= v ) ||
+         ( touched[4] <= v1 && touched[5] >= v );
+}
+
+void
+clear_sparse_pipeline_scalar( reduce_sparse_pipeline_args_t * args,
+                              int pipeline_rank,
+                              int n_pipeline );
+
 ///////////////////////////////////////////////////////////////////////////////
 // reduce_array_pipeline interface
 
@@ -89,6 +232,11 @@ reduce_array_pipeline_scalar( reduce_pipeline_args_t * args,
                               int pipeline_rank,
                               int n_pipeline );
 
+void
+reduce_sparse_pipeline_scalar( reduce_sparse_pipeline_args_t * args,
+                               int pipeline_rank,
+                               int n_pipeline );
+
 void
 reduce_array_pipeline_v4( reduce_pipeline_args_t * args,
                           int pipeline_rank,
@@ -81,6 +81,193 @@ unload_accumulator_pipeline_scalar( unload_accumulator_pipeline_args_t * args,
 
 }
 
+// The SoA version works on rows along x.  The jf planes are unit
+// stride so the row loops are vectorized by the compiler.
+
+void
+unload_accumulator_soa_pipeline_scalar( unload_accumulator_soa_pipeline_args_t * args,
+                                        int pipeline_rank,
+                                        int n_pipeline )
+{
+  const soa_field_t * soa = args->soa;
+
+  float * RESTRICT ALIGNED(128) jfx = soa->jfx;
+  float * RESTRICT ALIGNED(128) jfy = soa->jfy;
+  float * RESTRICT ALIGNED(128) jfz = soa->jfz;
+
+  const accumulator_t * RESTRICT ALIGNED(128) a = args->a;
+
+  int i, v, y, z, r, n_row;
+
+  const int nx = args->nx;
+  const int ny = args->ny;
+  const int nz = args->nz;
+
+  const int sy = nx + 2;
+  const int sz = sy * ( ny + 2 );
+
+  const float cx = args->cx;
+  const float cy = args->cy;
+  const float cz = args->cz;
+
+  // Process the rows assigned to this pipeline.  Rows are y = 1:ny+1,
+  // z = 1:nz+1 and the host gets none.
+
+  DISTRIBUTE( (ny+1)*(nz+1), 1, pipeline_rank, n_pipeline, r, n_row );
+
+  for( ; n_row; n_row--, r++ )
+  {
+    y = r%(ny+1) + 1;
+    z = r/(ny+1) + 1;
+    v = VOXEL( 1, y, z, nx, ny, nz );
+
+    for( i = v; i <= v + nx; i++ )
+    {
+      jfx[i] += cx * ( a[i     ].jx[0] + a[i-sy   ].jx[1] +
+                       a[i-sz  ].jx[2] + a[i-sy-sz].jx[3] );
+      jfy[i] += cy * ( a[i     ].jy[0] + a[i-sz   ].jy[1] +
+                       a[i-1   ].jy[2] + a[i-sz-1 ].jy[3] );
+      jfz[i] += cz * ( a[i     ].jz[0] + a[i-1    ].jz[1] +
+                       a[i-sy  ].jz[2] + a[i-1-sy ].jz[3] );
+    }
+  }
+}
+
+// The fused version works on rows along x like the SoA version.  Each
+// row is written, then the tangential jf of the row on local faces is
+// scaled as in local_adjust_jf (the scales of an edge on several local
+// faces multiply and a zero scale zeros the edge) and then the ends of
+// the row are copied into the x-face sends.  The send layout is that of
+// begin_synchronize_jf: g->dx, then jfy of the face for y = 1:ny,
+// z = 1:nz+1, then jfz of the face for y = 1:ny+1, z = 1:nz.
+
+#define ADJUST_JF(v,s) if ( (s) != 1 ) (v) = ( (s) == 0 ) ? 0 : (s)*(v)
+
+void
+unload_accumulator_sync_pipeline_scalar( unload_accumulator_sync_pipeline_args_t * args,
+                                         int pipeline_rank,
+                                         int n_pipeline )
+{
+  field_t             * ALIGNED(128) f = args->f;
+  const accumulator_t * ALIGNED(128) a = args->a;
+
+  const accumulator_t * ALIGNED(16) a0;
+  const accumulator_t * ALIGNED(16) ax,  * ALIGNED(16) ay,  * ALIGNED(16) az;
+  const accumulator_t * ALIGNED(16) ayz, * ALIGNED(16) azx, * ALIGNED(16) axy;
+
+  field_t * ALIGNED(16) f0;
+
+  float * ALIGNED(16) sx0 = args->sx0;
+  float * ALIGNED(16) sx1 = args->sx1;
+
+  int x, y, z, r, n_row;
+
+  float sy, sz;
+
+  const int nx = args->nx;
+  const int ny = args->ny;
+  const int nz = args->nz;
+
+  const float cx = args->cx;
+  const float cy = args->cy;
+  const float cz = args->cz;
+
+  const float * w = args->w;
+
+  if ( pipeline_rank == n_pipeline )
+  {
+    // Clear the ghost jf of the z = 0 plane and of the y = 0 rows.  The
+    // pipelines clear the x = 0 voxel of their rows.
+
+    for( y = 0; y <= ny+1; y++ )
+    {
+      for( x = 0; x <= nx+1; x++ )
+      {
+        f0 = &f( x, y, 0 );
+        f0->jfx = 0, f0->jfy = 0, f0->jfz = 0;
+      }
+    }
+
+    for( z = 1; z <= nz+1; z++ )
+    {
+      for( x = 0; x <= nx+1; x++ )
+      {
+        f0 = &f( x, 0, z );
+        f0->jfx = 0, f0->jfy = 0, f0->jfz = 0;
+      }
+    }
+
+    return;
+  }
+
+  // Process the rows assigned to this pipeline.  Rows are y = 1:ny+1,
+  // z = 1:nz+1.
+
+  DISTRIBUTE( (ny+1)*(nz+1), 1, pipeline_rank, n_pipeline, r, n_row );
+
+  for( ; n_row; n_row--, r++ )
+  {
+    y = r%(ny+1) + 1;
+    z = r/(ny+1) + 1;
+
+    f0  = &f( 0,   y,   z   );
+    f0->jfx = 0, f0->jfy = 0, f0->jfz = 0;
+
+    f0  = &f( 1,   y,   z   );
+    a0  = &a( 1,   y,   z   );
+    ax  = &a( 0,   y,   z   );
+    ay  = &a( 1,   y-1, z   );
+    az  = &a( 1,   y,   z-1 );
+    ayz = &a( 1,   y-1, z-1 );
+    azx = &a( 0,   y,   z-1 );
+    axy = &a( 0,   y-1, z   );
+
+    for( x = 1; x <= nx+1; x++ )
+    {
+      f0->jfx = cx * ( a0->jx[0] + ay->jx[1] + az->jx[2] + ayz->jx[3] );
+      f0->jfy = cy * ( a0->jy[0] + az->jy[1] + ax->jy[2] + azx->jy[3] );
+      f0->jfz = cz * ( a0->jz[0] + ax->jz[1] + ay->jz[2] + axy->jz[3] );
+
+      f0++; a0++; ax++; ay++; az++; ayz++; azx++; axy++;
+    }
+
+    // Local boundary adjustment.  jfx is adjusted for x = 1:nx, jfy for
+    // y = 1:ny and jfz for z = 1:nz.
+
+    sy = ( y == 1 ) ? w[1] : ( ( y == ny+1 ) ? w[4] : 1 );
+    sz = ( z == 1 ) ? w[2] : ( ( z == nz+1 ) ? w[5] : 1 );
+
+    if ( sy*sz != 1 )
+      for( x = 1; x <= nx; x++ ) ADJUST_JF( f( x, y, z ).jfx, sy*sz );
+
+    if ( y <= ny )
+    {
+      if ( sz != 1 )
+        for( x = 1; x <= nx+1; x++ ) ADJUST_JF( f( x, y, z ).jfy, sz );
+
+      ADJUST_JF( f( 1,    y, z ).jfy, w[0] );
+      ADJUST_JF( f( nx+1, y, z ).jfy, w[3] );
+
+      if ( sx0 ) sx0[ 1 + ( z-1 )*ny + ( y-1 ) ] = f( 1,    y, z ).jfy;
+      if ( sx1 ) sx1[ 1 + ( z-1 )*ny + ( y-1 ) ] = f( nx+1, y, z ).jfy;
+    }
+
+    if ( z <= nz )
+    {
+      if ( sy != 1 )
+        for( x = 1; x <= nx+1; x++ ) ADJUST_JF( f( x, y, z ).jfz, sy );
+
+      ADJUST_JF( f( 1,    y, z ).jfz, w[0] );
+      ADJUST_JF( f( nx+1, y, z ).jfz, w[3] );
+
+      if ( sx0 ) sx0[ 1 + ny*(nz+1) + ( z-1 )*(ny+1) + ( y-1 ) ] = f( 1,    y, z ).jfz;
+      if ( sx1 ) sx1[ 1 + ny*(nz+1) + ( z-1 )*(ny+1) + ( y-1 ) ] = f( nx+1, y, z ).jfz;
+    }
+  }
+}
+
+#undef ADJUST_JF
+
 #if defined(V4_ACCELERATION) && defined(HAS_V4_PIPELINE)
 
 #error "V4 version not hooked up yet."
@@ -142,3 +329,130 @@ unload_accumulator_array_pipeline( field_array_t * RESTRICT fa,
 
   WAIT_PIPELINES();
 }
+
+void
+unload_accumulator_array_soa_pipeline( field_array_t * RESTRICT fa,
+                                       const accumulator_array_t * RESTRICT aa )
+{
+  unload_accumulator_soa_pipeline_args_t args[1];
+
+  if ( !fa              ||
+       !fa->soa         ||
+       !aa              ||
+       fa->g != aa->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  args->soa = fa->soa;
+  args->a   = aa->a;
+
+  args->nx  = fa->g->nx;
+  args->ny  = fa->g->ny;
+  args->nz  = fa->g->nz;
+
+  args->cx  = 0.25 * fa->g->rdy * fa->g->rdz / fa->g->dt;
+  args->cy  = 0.25 * fa->g->rdz * fa->g->rdx / fa->g->dt;
+  args->cz  = 0.25 * fa->g->rdx * fa->g->rdy / fa->g->dt;
+
+  EXEC_PIPELINES( unload_accumulator_soa, args, 0 );
+
+  WAIT_PIPELINES();
+}
+
+void
+unload_accumulator_array_begin_synchronize_jf_pipeline( field_array_t * RESTRICT fa,
+                                                        const accumulator_array_t * RESTRICT aa )
+{
+  DECLARE_ALIGNED_ARRAY( unload_accumulator_sync_pipeline_args_t, 128, args, 1 );
+
+  static const int boundary[6] = { BOUNDARY( -1,  0,  0 ),
+                                   BOUNDARY(  0, -1,  0 ),
+                                   BOUNDARY(  0,  0, -1 ),
+                                   BOUNDARY(  1,  0,  0 ),
+                                   BOUNDARY(  0,  1,  0 ),
+                                   BOUNDARY(  0,  0,  1 ) };
+
+  int bc, face, size, nx, ny, nz;
+
+  if ( !fa              ||
+       !aa              ||
+       fa->g != aa->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  const grid_t * g = fa->g;
+
+  nx = g->nx;
+  ny = g->ny;
+  nz = g->nz;
+
+  // Tangential jf scales of local_adjust_jf
+
+  for( face = 0; face < 6; face++ )
+  {
+    bc = g->bc[ boundary[face] ];
+
+    if ( bc >= 0 && bc < world_size )
+    {
+      args->w[face] = 1;
+      continue;
+    }
+
+    switch( bc )
+    {
+      case anti_symmetric_fields: case pml_fields:
+        args->w[face] = 0;
+        break;
+      case symmetric_fields: case pmc_fields: case absorb_fields:
+        args->w[face] = 2;
+        break;
+      default:
+        ERROR( ( "Bad boundary condition encountered." ) );
+        break;
+    }
+  }
+
+  // Post the receives of all the faces and get the x-face sends (see
+  // begin_synchronize_jf).
+
+# define SIZE_JF(X,Y,Z) ( ( n##Y*(n##Z+1) + n##Z*(n##Y+1) + 1 )*sizeof(float) )
+
+  begin_recv_port( -1,  0,  0, SIZE_JF(x,y,z), g );
+  begin_recv_port(  1,  0,  0, SIZE_JF(x,y,z), g );
+  begin_recv_port(  0, -1,  0, SIZE_JF(y,z,x), g );
+  begin_recv_port(  0,  1,  0, SIZE_JF(y,z,x), g );
+  begin_recv_port(  0,  0, -1, SIZE_JF(z,x,y), g );
+  begin_recv_port(  0,  0,  1, SIZE_JF(z,x,y), g );
+
+  size = SIZE_JF(x,y,z);
+
+# undef SIZE_JF
+
+  args->sx0 = (float *) size_send_port( -1, 0, 0, size, g );
+  args->sx1 = (float *) size_send_port(  1, 0, 0, size, g );
+
+  if ( args->sx0 ) args->sx0[0] = g->dx;
+  if ( args->sx1 ) args->sx1[0] = g->dx;
+
+  args->f  = fa->f;
+  args->a  = aa->a;
+
+  args->nx = nx;
+  args->ny = ny;
+  args->nz = nz;
+
+  args->cx = 0.25 * g->rdy * g->rdz / g->dt;
+  args->cy = 0.25 * g->rdz * g->rdx / g->dt;
+  args->cz = 0.25 * g->rdx * g->rdy / g->dt;
+
+  EXEC_PIPELINES( unload_accumulator_sync, args, 0 );
+
+  WAIT_PIPELINES();
+
+  // Begin exchanging x-faces
+
+  if ( args->sx0 ) begin_send_port( -1, 0, 0, size, g );
+  if ( args->sx1 ) begin_send_port(  1, 0, 0, size, g );
+}
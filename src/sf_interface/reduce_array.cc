@@ -15,8 +15,49 @@ reduce_accumulator_array( accumulator_array_t * RESTRICT aa )
     ERROR( ( "Bad args" ) );
   }
 
+  // With tiled accumulation, advance_p flushes directly into the host
+  // accumulator and there are no pipeline accumulators to reduce.
+  if ( aa->n_pipeline == 0 )
+  {
+    return;
+  }
+
   // Conditionally execute this when more abstractions are available.
-  reduce_accumulator_array_pipeline( aa );
+  if ( sparse_accumulator_array( aa ) )
+  {
+    reduce_accumulator_array_sparse_pipeline( aa );
+  }
+
+  else
+  {
+    reduce_accumulator_array_pipeline( aa );
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Add a scaled host accumulator to another.  This is cheap compared to the
+// particle push that fills b, so it is done by the host alone.
+//----------------------------------------------------------------------------//
+
+void
+add_accumulator_array( accumulator_array_t       * RESTRICT aa,
+                       const accumulator_array_t * RESTRICT ab,
+                       float scale )
+{
+  if ( !aa || !ab || aa->g != ab->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  /**/  float * RESTRICT ALIGNED(16) a = (float *) aa->a;
+  const float * RESTRICT ALIGNED(16) b = (const float *) ab->a;
+
+  const int n = aa->g->nv * ( sizeof( accumulator_t ) / sizeof( float ) );
+
+  for( int k = 0; k < n; k++ )
+  {
+    a[k] += scale * b[k];
+  }
 }
 
 
@@ -73,12 +73,68 @@ typedef struct interpolator
   // float _pad3[8];  // More padding to get 64-byte align, make conditional
 } interpolator_t;
 
+// An interpolator_bf16 holds the coefficients of an interpolator in
+// bfloat16 (the upper 16 bits of a float, rounded to nearest even).
+// This keeps the range of a float with about 3 significant digits.  It
+// is one 64-byte cache line, half or less of an interpolator_t on
+// vector builds, so the particle push gathers less per particle.
+
+typedef struct interpolator_bf16
+{
+  uint16_t ex, dexdy, dexdz, d2exdydz;
+  uint16_t ey, deydz, deydx, d2eydzdx;
+  uint16_t ez, dezdx, dezdy, d2ezdxdy;
+  uint16_t cbx, dcbxdx;
+  uint16_t cby, dcbydy;
+  uint16_t cbz, dcbzdz;
+  uint16_t _pad1[14];
+} interpolator_bf16_t;
+
 typedef struct interpolator_array
 {
   interpolator_t * ALIGNED(128) i;
   grid_t * g;
+  interpolator_bf16_t * ALIGNED(128) h; // BF16 copy of i (NULL if none)
 } interpolator_array_t;
 
+// Round the coefficients of fi to bf16.  fi is read as bytes so that it
+// may have just been written by vector stores.
+
+static inline void
+store_interpolator_bf16( interpolator_bf16_t  * RESTRICT h,
+                         const interpolator_t * RESTRICT fi )
+{
+  uint16_t * RESTRICT c = (uint16_t *) h;
+  uint32_t u[18];
+  int j;
+
+  memcpy( u, fi, sizeof(u) );
+
+  for( j = 0; j < 18; j++ )
+  {
+    if ( ( u[j] & 0x7fffffff ) > 0x7f800000 )   // Keep NaNs NaNs
+      c[j] = ( u[j] >> 16 ) | 0x40;
+    else
+      c[j] = ( u[j] + 0x7fff + ( ( u[j] >> 16 ) & 1 ) ) >> 16;
+  }
+}
+
+// Expand the coefficients of h into fi.  Only the coefficients of fi are
+// written.
+
+static inline void
+load_interpolator_bf16( interpolator_t            * RESTRICT fi,
+                        const interpolator_bf16_t * RESTRICT h )
+{
+  const uint16_t * RESTRICT c = (const uint16_t *) h;
+  uint32_t u[18];
+  int j;
+
+  for( j = 0; j < 18; j++ ) u[j] = (uint32_t) c[j] << 16;
+
+  memcpy( fi, u, sizeof(u) );
+}
+
 BEGIN_C_DECLS
 
 // In interpolator_array.cc
@@ -89,6 +145,15 @@ new_interpolator_array( grid_t * g );
 void
 delete_interpolator_array( interpolator_array_t * ALIGNED(128) ia );
 
+// set_interpolator_array_bf16 turns the BF16 copy of the interpolators
+// on or off.  When on, load_interpolator_array also fills the copy and
+// advance_p pushes the particles with it.  The other particle kernels
+// still use the full precision interpolators.
+
+void
+set_interpolator_array_bf16( interpolator_array_t * RESTRICT ia,
+                             int                             bf16 );
+
 // Going into load_interpolator, the field array f contains the
 // current information such that the fields can be interpolated to
 // particles within the local domain.  Load interpolate computes the
@@ -100,6 +165,21 @@ void
 load_interpolator_array( /**/  interpolator_array_t * RESTRICT ia,
                          const field_array_t        * RESTRICT fa );
 
+// advance_b_load_interpolator_array does fa->kernel->advance_b( fa,
+// frac ) followed by load_interpolator_array( ia, fa ).  For field
+// arrays with the Yee advance_b (see has_yee_advance_b) the
+// interpolators of each z slab are loaded as soon as its cB is
+// finished, which saves a pass over the field array.  The fused sweep
+// does the arithmetic of the scalar advance_b and load_interpolator
+// pipelines, so the results are the same in scalar builds.  The v4, v8
+// and v16 advance_b pipelines use fused multiply adds, so in vector
+// builds cB can differ from advance_b in the last bit.
+
+void
+advance_b_load_interpolator_array( interpolator_array_t * RESTRICT ia,
+                                   field_array_t        * RESTRICT fa,
+                                   float                           frac );
+
 END_C_DECLS
 
 /*****************************************************************************/
@@ -111,6 +191,13 @@ END_C_DECLS
 // processor.  a(:,:,:,1:n_pipeline) are the accumulators used by
 // pipelines during operations.  Like the interpolator, accumulators
 // on the surface of the local domain are not used.
+//
+// When built with VPIC_USE_TILED_ACCUMULATORS, only a(:,:,:,0) is
+// allocated (n_pipeline is 0).  Instead, pipelines accumulate into
+// small tile accumulators that cover the voxels of the particles they
+// push plus a one voxel halo.  The tile accumulators are carved out of
+// a single scratch allocation of n_tile accumulators and are flushed
+// into a(:,:,:,0) at the end of advance_p.  See advance_p_pipeline.cc.
 
 typedef struct accumulator
 {
@@ -127,9 +214,25 @@ typedef struct accumulator_array
   accumulator_t * ALIGNED(128) a;
   int n_pipeline; // Number of pipelines supported by this accumulator
   int stride;     // Stride be each pipeline's accumulator array
+  accumulator_t * ALIGNED(128) tile; // Tile accumulator scratch
+  int n_tile;     // Number of accumulators in the tile scratch
+  int * pushed;   // Particles pushed into pipeline accumulator r+1 since
+  /**/            // the last clear were in voxels
+  /**/            // pushed[2*r]:pushed[2*r+1] (empty if reversed)
   grid_t * g;
 } accumulator_array_t;
 
+// A particle that starts a time step in voxel v can only deposit
+// current into voxels v-ACCUMULATOR_TILE_HALO(g):v+ACCUMULATOR_TILE_HALO(g)
+// (the Courant condition limits particles to crossing at most one
+// face on each axis per time step, and wrapping around a periodic
+// x or y boundary of the local domain stays within a z-plane).  Tile
+// accumulators are padded by this many voxels on each side.  Moves
+// that wrap around a periodic z boundary are left to the host.
+
+#define ACCUMULATOR_TILE_HALO( g ) \
+  ( 2 * ( (g)->nx + 2 ) * ( (g)->ny + 2 ) )
+
 BEGIN_C_DECLS
 
 // In accumulator_array.cc
@@ -153,11 +256,22 @@ clear_accumulator_array( accumulator_array_t * RESTRICT a );
 // cores have each accumulated values to their personal
 // accumulators.  This reduces the pipeline accumulators into the host
 // accumulator with a pipelined horizontal reduction (a deterministic
-// reduction).
+// reduction).  Blocks of voxels that at most one pipeline accumulated
+// into are reduced by adding only that pipeline's accumulator.  With
+// sorted particles, that is most of them.  The result is the same.
 
 void
 reduce_accumulator_array( accumulator_array_t * RESTRICT a );
 
+// This adds scale times the host accumulator of b into the host
+// accumulator of a.  It is used to add the held currents of subcycled
+// species (see species_advance.h).
+
+void
+add_accumulator_array( accumulator_array_t       * RESTRICT a,
+                       const accumulator_array_t * RESTRICT b,
+                       float scale );
+
 // In unload_accumulator.cc
 
 // Going into unload_accumulator, the accumulator contains 4 times the
@@ -173,6 +287,20 @@ void
 unload_accumulator_array( /**/  field_array_t       * RESTRICT fa, 
                           const accumulator_array_t * RESTRICT aa );
 
+// unload_accumulator_array_begin_synchronize_jf does
+// fa->kernel->clear_jf( fa ), unload_accumulator_array( fa, aa ) and
+// fa->kernel->begin_synchronize_jf( fa ).  The caller finishes the
+// exchange with fa->kernel->end_synchronize_jf( fa ).  For field
+// arrays with the standard current exchange (see
+// has_standard_synchronize_jf) the currents are written instead of
+// added to a cleared jf and the local boundary adjustment and the
+// packing of the x-face sends are done as each row is unloaded, which
+// saves two passes over the field array.  The results are the same.
+
+void
+unload_accumulator_array_begin_synchronize_jf( /**/  field_array_t       * RESTRICT fa,
+                                               const accumulator_array_t * RESTRICT aa );
+
 END_C_DECLS
 
 /*****************************************************************************/
@@ -14,15 +14,57 @@ void
 load_interpolator_array_pipeline( interpolator_array_t * RESTRICT ia,
                                   const field_array_t * RESTRICT fa );
 
+// Loads the interpolators from the planes of a field array with SoA
+// field storage (see new_soa_field_array).  The planes must be current.
+
+void
+load_interpolator_array_soa_pipeline( interpolator_array_t * RESTRICT ia,
+                                      const field_array_t * RESTRICT fa );
+
+// Does the final advance_b of a field array with the Yee advance_b and
+// loads the interpolators in the same sweep (see
+// advance_b_load_interpolator_array).
+
+void
+advance_b_load_interpolator_array_pipeline( interpolator_array_t * RESTRICT ia,
+                                            field_array_t * RESTRICT fa,
+                                            float frac );
+
 ///////////////////////////////////////////////////////////////////////////////
 // clear_accumulators_pipeline interface
 
+// Marks the pipeline accumulators as pushed into everywhere (restored)
+// or nowhere (cleared).
+
+void
+set_accumulator_pushed( accumulator_array_t * aa,
+                        int everywhere );
+
+// Finds the voxels of pipeline accumulator r+1 that may be nonzero
+// from the voxels pushed into it.  See accumulator_array.cc.
+
+void
+touched_accumulator_voxels( const accumulator_array_t * aa,
+                            int r,
+                            int * v );
+
+// Returns nonzero if the sparse pipelines would skip anything.
+
+int
+sparse_accumulator_array( const accumulator_array_t * aa );
+
 void
 clear_accumulator_array_pipeline( accumulator_array_t * RESTRICT aa );
 
+void
+clear_accumulator_array_sparse_pipeline( accumulator_array_t * RESTRICT aa );
+
 void
 reduce_accumulator_array_pipeline( accumulator_array_t * RESTRICT aa );
 
+void
+reduce_accumulator_array_sparse_pipeline( accumulator_array_t * RESTRICT aa );
+
 ///////////////////////////////////////////////////////////////////////////////
 // clear_hydro_pipeline interface
 
@@ -38,4 +80,19 @@ void
 unload_accumulator_array_pipeline( field_array_t * RESTRICT fa,
                                    const accumulator_array_t * RESTRICT aa );
 
+// Unloads the accumulators into the jf planes of a field array with SoA
+// field storage.  The planes must be current.
+
+void
+unload_accumulator_array_soa_pipeline( field_array_t * RESTRICT fa,
+                                       const accumulator_array_t * RESTRICT aa );
+
+// Unloads the accumulators into jf of a field array with the standard
+// current exchange and begins the exchange (see
+// unload_accumulator_array_begin_synchronize_jf).
+
+void
+unload_accumulator_array_begin_synchronize_jf_pipeline( field_array_t * RESTRICT fa,
+                                                        const accumulator_array_t * RESTRICT aa );
+
 #endif // _sf_interface_private_h_
@@ -18,6 +18,48 @@ unload_accumulator_array( field_array_t * RESTRICT fa,
     ERROR( ( "Bad args" ) );
   }
 
+  // Field arrays with SoA field storage take the current in the planes.
+
+  if ( fa->soa )
+  {
+    load_soa_field_array( fa );
+
+    unload_accumulator_array_soa_pipeline( fa, aa );
+
+    return;
+  }
+
   // Conditionally execute this when more abstractions are available.
   unload_accumulator_array_pipeline( fa, aa );
 }
+
+//----------------------------------------------------------------------------//
+// Top level function to select and call the proper
+// unload_accumulator_array_begin_synchronize_jf function.
+//----------------------------------------------------------------------------//
+
+void
+unload_accumulator_array_begin_synchronize_jf( field_array_t * RESTRICT fa,
+                                               const accumulator_array_t * RESTRICT aa )
+{
+  if ( !fa              ||
+       !aa              ||
+       fa->g != aa->g )
+  {
+    ERROR( ( "Bad args" ) );
+  }
+
+  if ( !has_standard_synchronize_jf( fa ) )
+  {
+    fa->kernel->clear_jf( fa );
+
+    unload_accumulator_array( fa, aa );
+
+    fa->kernel->begin_synchronize_jf( fa );
+
+    return;
+  }
+
+  // Conditionally execute this when more abstractions are available.
+  unload_accumulator_array_begin_synchronize_jf_pipeline( fa, aa );
+}
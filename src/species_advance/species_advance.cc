@@ -18,12 +18,14 @@ checkpt_species( const species_t * sp )
   CHECKPT( sp, 1 );
   CHECKPT_STR( sp->name );
   checkpt_data( sp->p,
-                sp->np    *sizeof(particle_t),
-                sp->max_np*sizeof(particle_t), 1, 1, 128 );
+                PARTICLE_BLOCKS(sp->np    )*sizeof(particle_block_t),
+                PARTICLE_BLOCKS(sp->max_np)*sizeof(particle_block_t),
+                1, 1, 128 );
   checkpt_data( sp->pm,
                 sp->nm    *sizeof(particle_mover_t),
                 sp->max_nm*sizeof(particle_mover_t), 1, 1, 128 );
   CHECKPT_ALIGNED( sp->partition, sp->g->nv+1, 128 );
+  CHECKPT_PTR( sp->held );
   CHECKPT_PTR( sp->g );
   CHECKPT_PTR( sp->next );
 }
@@ -34,9 +36,13 @@ restore_species( void )
   species_t * sp;
   RESTORE( sp );
   RESTORE_STR( sp->name );
-  sp->p  = (particle_t *)      restore_data();
+  sp->p  = (particle_block_t *)restore_data();
   sp->pm = (particle_mover_t *)restore_data();
   RESTORE_ALIGNED( sp->partition );
+  RESTORE_PTR( sp->held );
+  sp->moved     = NULL; // Rebuilt by the next push
+  sp->max_moved = 0;
+  sp->moved_np  = -1;
   RESTORE_PTR( sp->g );
   RESTORE_PTR( sp->next );
   return sp;
@@ -46,6 +52,8 @@ void
 delete_species( species_t * sp )
 {
   UNREGISTER_OBJECT( sp );
+  delete_accumulator_array( sp->held );
+  FREE_ALIGNED( sp->moved );
   FREE_ALIGNED( sp->partition );
   FREE_ALIGNED( sp->pm );
   FREE_ALIGNED( sp->p );
@@ -135,7 +143,7 @@ species( const char * name,
   sp->q = q;
   sp->m = m;
 
-  MALLOC_ALIGNED( sp->p, max_local_np, 128 );
+  MALLOC_ALIGNED( sp->p, PARTICLE_BLOCKS(max_local_np), 128 );
   sp->max_np = max_local_np;
 
   MALLOC_ALIGNED( sp->pm, max_local_nm, 128 );
@@ -144,6 +152,7 @@ species( const char * name,
   sp->last_sorted       = INT64_MIN;
   sp->sort_interval     = sort_interval;
   sp->sort_out_of_place = sort_out_of_place;
+  sp->moved_np          = -1;
   MALLOC_ALIGNED( sp->partition, g->nv+1, 128 );
 
   sp->g = g;   
@@ -18,7 +18,152 @@
 // Choose between using AoSoA or AoS data layout for the particles.
 //----------------------------------------------------------------------------//
 
+#if defined(VPIC_USE_AOSOA_P)
+#include "species_advance_aosoa.h"
+#else
 #include "species_advance_aos.h"
+#endif
+
+typedef int32_t species_id; // Must be 32-bit wide for particle_injector_t
+
+// WARNING: FUNCTIONS THAT USE A PARTICLE_MOVER ASSUME THAT EVERYBODY
+// WHO USES THAT PARTICLE MOVER WILL HAVE ACCESS TO PARTICLE ARRAY
+
+typedef struct particle_mover {
+  float dispx, dispy, dispz; // Displacement of particle
+  int32_t i;                 // Index of the particle to move
+} particle_mover_t;
+
+// NOTE: THE LAYOUT OF A PARTICLE_INJECTOR _MUST_ BE COMPATIBLE WITH
+// THE CONCATENATION OF A PARTICLE_T AND A PARTICLE_MOVER!
+
+typedef struct particle_injector {
+  float dx, dy, dz;          // Particle position in cell coords (on [-1,1])
+  int32_t i;                 // Index of cell containing the particle
+  float ux, uy, uz;          // Particle normalized momentum
+  float w;                   // Particle weight (number of physical particles)
+  float dispx, dispy, dispz; // Displacement of particle
+  species_id sp_id;          // Species of particle
+} particle_injector_t;
+
+typedef struct species {
+  char * name;                        // Species name
+  float q;                            // Species particle charge
+  float m;                            // Species particle rest mass
+
+  int np, max_np;                     // Number and max local particles
+  particle_block_t * ALIGNED(128) p;  // Array of particle blocks for the
+                                      // species.  Holds max_np particles
+                                      // (rounded up to a whole block, see
+                                      // PARTICLE_BLOCKS).  Access with
+                                      // P_ELEM and friends.
+
+  int nm, max_nm;                     // Number and max local movers in use
+  particle_mover_t * ALIGNED(128) pm; // Particle movers
+
+  int64_t last_sorted;                // Step when the particles were last
+                                      // sorted.
+  int sort_interval;                  // How often to sort the species
+                                      // (AUTO_SORT_INTERVAL: when due)
+  int sort_out_of_place;              // Sort method
+  int sort_in_place;                  // Have the thread parallel sort
+                                      // sort in place (see below)
+  int sort_fused;                     // Have the push record moved
+                                      // particles for the next sort (see
+                                      // below)
+  unsigned char * ALIGNED(128) moved; // Bitmap of the particles that
+                                      // changed voxel in the last push
+  int max_moved;                      // Number of bits in moved
+  int moved_np;                       // Particles past this may have been
+                                      // changed since the last push (-1:
+                                      // moved is not valid)
+  double sort_cost;                   // Time taken by the last sort
+  double push_cost;                   // Least push time per particle
+                                      // seen since the last sort
+  double push_excess;                 // Push time lost to disorder since
+                                      // the last sort
+  int pusher;                         // Particle pusher (see below)
+  int subcycle;                       // Push every subcycle steps with a
+                                      // subcycle*dt time step (<=1: every
+                                      // step).  See below.
+  accumulator_array_t * held;         // Current accumulated by the last
+                                      // push of a subcycled species
+  int * ALIGNED(128) partition;       // Static array indexed 0:
+  /**/                                // (nx+2)*(ny+2)*(nz+2).  Each value
+  /**/                                // corresponds to the associated particle
+  /**/                                // array index of the first particle in
+  /**/                                // the cell.  Array is allocated and
+  /**/                                // values computed in sort_p.  Purpose is
+  /**/                                // for implementing collision models
+  /**/                                // This is given in terms of the
+  /**/                                // underlying's grids space filling
+  /**/                                // curve indexing.  Thus, immediately
+  /**/                                // after a sort, the particles
+  /**/                                //   sp->partition[g->sfc[i]  ]:
+  /**/                                //   sp->partition[g->sfc[i]+1]-1
+  /**/                                // of sp->p are all the particles in
+  /**/                                // voxel with local index i, while:
+  /**/                                //   sp->partition[ j   ]:
+  /**/                                //   sp->partition[ j+1 ]-1
+  /**/                                // are all the particles in voxel
+  /**/                                // with space filling curve index j.
+  /**/                                // Note: g->sfc[i]=i unless a voxel
+  /**/                                // order was set with set_voxel_order.
+
+  grid_t * g;                         // Underlying grid
+  species_id id;                      // Unique identifier for a species
+  struct species *next;               // Next species in the list
+} species_t;
+
+// A species defined with a sort_interval of AUTO_SORT_INTERVAL is sorted
+// when sort_p_due says so instead of at a fixed interval.
+
+#define AUTO_SORT_INTERVAL (-1)
+
+// The thread parallel sort sorts every species out of place with a spare
+// particle array (as does the legacy sort for species defined with
+// sort_out_of_place).  A species that sets sp->sort_in_place is instead
+// sorted in place by the thread parallel sort.  That needs no particle
+// storage beyond the particle array but is not stable and never
+// incremental.
+
+// A species that is sorted out of place every step can set sp->sort_fused.
+// Its push then marks the particles that leave their voxel in sp->moved
+// and the next sort merges only those (and the particles boundary_p or
+// particle injection added at the end of the particle array) instead of
+// reading every particle to find them.  This assumes that the particles
+// are only changed by the push, boundary_p and the particle injection
+// functions between the sort and the next one.
+
+// Particle pushers.  A species is pushed with the Boris pusher unless an
+// input deck sets sp->pusher to another one.  The Vay and Higuera-Cary
+// pushers give the correct E x B drift for ultra-relativistic particles
+// (Boris does not when E + v x B ~ 0) and thus allow larger time steps.
+
+enum species_enums {
+  boris_pusher        = 0, // Boris rotation (default)
+  vay_pusher          = 1, // Vay (2008)
+  higuera_cary_pusher = 2  // Higuera and Cary (2017)
+};
+
+// Particle subcycling.  A species with sp->subcycle = N > 1 is pushed
+// only on steps 1, N+1, 2N+1, ... with a time step of N*dt.  advance_p
+// and boundary_p accumulate the current of such a push into the
+// species' held accumulator array and 1/N of it is added to the current
+// on each of the N steps of the cycle (so charge is still conserved).
+// The particle positions of the species are consistent with the fields
+// at the end of steps that are multiples of N (so divergence cleaning with
+// an interval that is a multiple of N sees them consistent; in
+// user_diagnostics, that is when step()%N==1).  The particle functions
+// that center momenta (center_p, uncenter_p, energy_p, hydro_p) use the
+// species time step SPECIES_DT.
+
+#define SPECIES_SUBCYCLE( sp ) ( (sp)->subcycle > 1 ? (sp)->subcycle : 1 )
+
+#define SPECIES_DT( sp ) ( (sp)->g->dt * (float)SPECIES_SUBCYCLE( sp ) )
+
+#define SPECIES_PUSH_STEP( sp ) \
+  ( (sp)->g->step % SPECIES_SUBCYCLE( sp ) == 1 % SPECIES_SUBCYCLE( sp ) )
 
 //----------------------------------------------------------------------------//
 // Declare methods.
@@ -68,6 +213,20 @@ sort_p( species_t * RESTRICT sp );
 void
 sort_p_pipeline( species_t * sp );
 
+// Returns the fraction of a sample of the particles that are no longer in
+// the partition of their voxel computed by the last sort.
+
+double
+sort_p_disorder( const species_t * RESTRICT sp );
+
+// Returns non-zero if the push time lost to particle disorder since the
+// last sort (as measured by advance_p) exceeds the time taken by the last
+// sort (as measured by sort_p) and the particles are measurably out of
+// order.  A species that was never sorted is always due.
+
+int
+sort_p_due( const species_t * RESTRICT sp );
+
 // In advance_p.cc
 
 void
@@ -150,7 +309,7 @@ accumulate_hydro_p_pipeline( hydro_array_t * RESTRICT ha,
 // In move_p.cc
 
 int
-move_p( particle_t       * ALIGNED(128) p0,    // Particle array
+move_p( particle_block_t * ALIGNED(128) p0,    // Particle array
         particle_mover_t * ALIGNED(16)  m,     // Particle mover to apply
         accumulator_t    * ALIGNED(128) a0,    // Accumulator to use
         const grid_t     *              g,     // Grid parameters
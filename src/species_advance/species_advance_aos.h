@@ -12,8 +12,6 @@
 #ifndef _species_advance_aos_h_
 #define _species_advance_aos_h_
 
-typedef int32_t species_id; // Must be 32-bit wide for particle_injector_t
-
 // FIXME: Eventually particle_t (definitely) and their other formats
 // (maybe) should be opaque and specific to a particular
 // species_advance implementation
@@ -31,66 +29,48 @@ typedef struct particle {
   float w;          // Particle weight (number of physical particles)
 } particle_t;
 
-// WARNING: FUNCTIONS THAT USE A PARTICLE_MOVER ASSUME THAT EVERYBODY
-// WHO USES THAT PARTICLE MOVER WILL HAVE ACCESS TO PARTICLE ARRAY
-
-typedef struct particle_mover {
-  float dispx, dispy, dispz; // Displacement of particle
-  int32_t i;                 // Index of the particle to move
-} particle_mover_t;
-
-// NOTE: THE LAYOUT OF A PARTICLE_INJECTOR _MUST_ BE COMPATIBLE WITH
-// THE CONCATENATION OF A PARTICLE_T AND A PARTICLE_MOVER!
-
-typedef struct particle_injector {
-  float dx, dy, dz;          // Particle position in cell coords (on [-1,1])
-  int32_t i;                 // Index of cell containing the particle
-  float ux, uy, uz;          // Particle normalized momentum
-  float w;                   // Particle weight (number of physical particles)
-  float dispx, dispy, dispz; // Displacement of particle
-  species_id sp_id;          // Species of particle
-} particle_injector_t;
-
-typedef struct species {
-  char * name;                        // Species name
-  float q;                            // Species particle charge
-  float m;                            // Species particle rest mass
-
-  int np, max_np;                     // Number and max local particles
-  particle_t * ALIGNED(128) p;        // Array of particles for the species
-
-  int nm, max_nm;                     // Number and max local movers in use
-  particle_mover_t * ALIGNED(128) pm; // Particle movers
-
-  int64_t last_sorted;                // Step when the particles were last
-                                      // sorted.
-  int sort_interval;                  // How often to sort the species
-  int sort_out_of_place;              // Sort method
-  int * ALIGNED(128) partition;       // Static array indexed 0:
-  /**/                                // (nx+2)*(ny+2)*(nz+2).  Each value
-  /**/                                // corresponds to the associated particle
-  /**/                                // array index of the first particle in
-  /**/                                // the cell.  Array is allocated and
-  /**/                                // values computed in sort_p.  Purpose is
-  /**/                                // for implementing collision models
-  /**/                                // This is given in terms of the
-  /**/                                // underlying's grids space filling
-  /**/                                // curve indexing.  Thus, immediately
-  /**/                                // after a sort:
-  /**/                                //   sp->p[sp->partition[g->sfc[i]  ]:
-  /**/                                //         sp->partition[g->sfc[i]+1]-1]
-  /**/                                // are all the particles in voxel
-  /**/                                // with local index i, while:
-  /**/                                //   sp->p[ sp->partition[ j   ]:
-  /**/                                //          sp->partition[ j+1 ] ]
-  /**/                                // are all the particles in voxel
-  /**/                                // with space filling curve index j.
-  /**/                                // Note: SFC NOT IN USE RIGHT NOW THUS
-  /**/                                // g->sfc[i]=i ABOVE.
-
-  grid_t * g;                         // Underlying grid
-  species_id id;                      // Unique identifier for a species
-  struct species *next;               // Next species in the list
-} species_t;
+//----------------------------------------------------------------------------//
+// Layout neutral particle access.  Code that has to work with either particle
+// layout should go through these rather than dereferencing sp->p directly.
+// With the AoS layout, a particle block is simply a single particle.
+//----------------------------------------------------------------------------//
+
+#define PARTICLE_BLOCK_SIZE 1
+
+// Unit of particle storage (the type of sp->p).
+
+typedef particle_t particle_block_t;
+
+// Number of particle blocks needed to store n particles.
+
+#define PARTICLE_BLOCKS( n ) (n)
+
+// Element f (dx, dy, dz, i, ux, uy, uz or w) of particle n in array p.
+// Consecutive elements of a particle are PARTICLE_BLOCK_SIZE apart, so
+// (&P_ELEM(p,n,dx))[axis*PARTICLE_BLOCK_SIZE] is the axis'th position.
+
+#define P_ELEM( p, n, f ) ( (p)[n].f )
+
+// Gather particle n of p into the particle_t r and scatter it back.
+
+#define LOAD_PARTICLE( r, p, n )  (r) = (p)[n]
+
+#define STORE_PARTICLE( p, n, r ) (p)[n] = (r)
+
+// Copy particle ns of ps into particle nd of pd.
+
+#define COPY_PARTICLE( pd, nd, ps, ns ) (pd)[nd] = (ps)[ns]
+
+// Pointer to a particle_t holding particle n of p, for passing to routines
+// that take individual particles (accumulate_rhob, boundary handlers, ...).
+// With the AoS layout this points into p directly and the scratch record r
+// declared by DECLARE_PARTICLE_RECORD is not needed.  Changes made through
+// the pointer are only guaranteed to reach p after FLUSH_PARTICLE_RECORD.
+
+#define DECLARE_PARTICLE_RECORD( r )
+
+#define PARTICLE_RECORD( r, p, n ) ( (p) + (n) )
+
+#define FLUSH_PARTICLE_RECORD( p, n, r )
 
 #endif // _species_advance_aos_h_
@@ -0,0 +1,111 @@
+/*
+ * Written by:
+ *   Kevin J. Bowers, Ph.D.
+ *   Plasma Physics Group (X-1)
+ *   Applied Physics Division
+ *   Los Alamos National Lab
+ * March/April 2004 - Original version (data structures based on earlier
+ *                    V4PIC versions)
+ *
+ */
+
+#ifndef _species_advance_aosoa_h_
+#define _species_advance_aosoa_h_
+
+// In the AoSoA layout, particles are stored in blocks of
+// PARTICLE_BLOCK_SIZE particles.  Within a block, each particle element
+// is stored contiguously such that a block of particles can be loaded
+// into SIMD registers without any transposes.  PARTICLE_BLOCK_SIZE must
+// be a power of two and a multiple of the widest SIMD vector in use.
+
+#define PARTICLE_BLOCK_SIZE 16
+
+// A particle_t is still used as the exchange format for individual
+// particles (e.g. boundary handlers, collision models, particle
+// injectors, dumps).  It is never used for particle storage.
+
+typedef struct particle {
+  float dx, dy, dz; // Particle position in cell coordinates (on [-1,1])
+  int32_t i;        // Voxel containing the particle.  Note that
+  /**/              // particles awaiting processing by boundary_p
+  /**/              // have actually set this to 8*voxel + face where
+  /**/              // face is the index of the face they interacted
+  /**/              // with (on 0:5).  This limits the local number of
+  /**/              // voxels to 2^28 but emitter handling already
+  /**/              // has a stricter limit on this (2^26).
+  float ux, uy, uz; // Particle normalized momentum
+  float w;          // Particle weight (number of physical particles)
+} particle_t;
+
+// Unit of particle storage (the type of sp->p).
+
+typedef struct particle_block {
+  float   dx[PARTICLE_BLOCK_SIZE]; // Particle positions in cell coordinates
+  float   dy[PARTICLE_BLOCK_SIZE];
+  float   dz[PARTICLE_BLOCK_SIZE];
+  int32_t  i[PARTICLE_BLOCK_SIZE]; // Voxels containing the particles
+  float   ux[PARTICLE_BLOCK_SIZE]; // Particle normalized momenta
+  float   uy[PARTICLE_BLOCK_SIZE];
+  float   uz[PARTICLE_BLOCK_SIZE];
+  float    w[PARTICLE_BLOCK_SIZE]; // Particle weights
+} particle_block_t;
+
+//----------------------------------------------------------------------------//
+// Layout neutral particle access.  See species_advance_aos.h.
+//----------------------------------------------------------------------------//
+
+#define PARTICLE_BLOCKS( n ) \
+  ( ( (n) + PARTICLE_BLOCK_SIZE - 1 ) / PARTICLE_BLOCK_SIZE )
+
+#define P_ELEM( p, n, f ) \
+  ( (p)[ (n) / PARTICLE_BLOCK_SIZE ].f[ (n) % PARTICLE_BLOCK_SIZE ] )
+
+#define LOAD_PARTICLE( r, p, n ) do { \
+    (r).dx = P_ELEM( p, n, dx );      \
+    (r).dy = P_ELEM( p, n, dy );      \
+    (r).dz = P_ELEM( p, n, dz );      \
+    (r).i  = P_ELEM( p, n, i  );      \
+    (r).ux = P_ELEM( p, n, ux );      \
+    (r).uy = P_ELEM( p, n, uy );      \
+    (r).uz = P_ELEM( p, n, uz );      \
+    (r).w  = P_ELEM( p, n, w  );      \
+  } while(0)
+
+#define STORE_PARTICLE( p, n, r ) do { \
+    P_ELEM( p, n, dx ) = (r).dx;       \
+    P_ELEM( p, n, dy ) = (r).dy;       \
+    P_ELEM( p, n, dz ) = (r).dz;       \
+    P_ELEM( p, n, i  ) = (r).i;        \
+    P_ELEM( p, n, ux ) = (r).ux;       \
+    P_ELEM( p, n, uy ) = (r).uy;       \
+    P_ELEM( p, n, uz ) = (r).uz;       \
+    P_ELEM( p, n, w  ) = (r).w;        \
+  } while(0)
+
+#define COPY_PARTICLE( pd, nd, ps, ns ) do {     \
+    P_ELEM( pd, nd, dx ) = P_ELEM( ps, ns, dx ); \
+    P_ELEM( pd, nd, dy ) = P_ELEM( ps, ns, dy ); \
+    P_ELEM( pd, nd, dz ) = P_ELEM( ps, ns, dz ); \
+    P_ELEM( pd, nd, i  ) = P_ELEM( ps, ns, i  ); \
+    P_ELEM( pd, nd, ux ) = P_ELEM( ps, ns, ux ); \
+    P_ELEM( pd, nd, uy ) = P_ELEM( ps, ns, uy ); \
+    P_ELEM( pd, nd, uz ) = P_ELEM( ps, ns, uz ); \
+    P_ELEM( pd, nd, w  ) = P_ELEM( ps, ns, w  ); \
+  } while(0)
+
+#define DECLARE_PARTICLE_RECORD( r ) particle_t ALIGNED(32) r
+
+#define PARTICLE_RECORD( r, p, n ) load_particle_record( &(r), p, n )
+
+#define FLUSH_PARTICLE_RECORD( p, n, r ) STORE_PARTICLE( p, n, r )
+
+static inline particle_t *
+load_particle_record( particle_t             * RESTRICT r,
+                      const particle_block_t * RESTRICT p,
+                      int                               n )
+{
+  LOAD_PARTICLE( *r, p, n );
+  return r;
+}
+
+#endif // _species_advance_aosoa_h_
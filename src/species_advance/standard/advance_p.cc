@@ -5,7 +5,10 @@
 //----------------------------------------------------------------------------//
 // Top level function to select and call particle advance function using the
 // desired particle advance abstraction.  Currently, the only abstraction
-// available is the pipeline abstraction.
+// available is the pipeline abstraction.  For AUTO_SORT_INTERVAL species,
+// the push is timed to estimate the push time lost to particle disorder
+// (see sort_p_due).  Subcycled species accumulate into their held
+// accumulator array instead of aa (see species_advance.h).
 //----------------------------------------------------------------------------//
 
 void
@@ -13,7 +16,45 @@ advance_p( species_t * RESTRICT sp,
            accumulator_array_t * RESTRICT aa,
            const interpolator_array_t * RESTRICT ia )
 {
+  if ( ! sp )
+  {
+    ERROR( ( "Bad args." ) );
+  }
+
+  const int np = sp->np;
+
+  if ( sp->subcycle > 1 )
+  {
+    if ( ! sp->held )
+    {
+      sp->held = new_accumulator_array( sp->g );
+    }
+
+    clear_accumulator_array( sp->held );
+
+    aa = sp->held;
+  }
+
+  double t = wallclock();
+
   // Once more options are available, this should be conditionally executed
   // based on user choice.
   advance_p_pipeline( sp, aa, ia );
+
+  if ( sp->sort_interval == AUTO_SORT_INTERVAL && np > 0 )
+  {
+    t = ( wallclock() - t ) / np;
+
+    if ( sp->push_cost == 0 || t < sp->push_cost )
+    {
+      sp->push_cost = t;
+    }
+
+    sp->push_excess += ( t - sp->push_cost ) * np;
+  }
+
+  if ( aa == sp->held )
+  {
+    reduce_accumulator_array( aa );
+  }
 }
@@ -21,14 +21,16 @@
 // Note: changes here likely need to be reflected in SPE accelerated
 // version as well.
 
-#if defined(V4_ACCELERATION)
+#if defined(V4_ACCELERATION) && !defined(VPIC_USE_AOSOA_P)
 
-// High performance variant based on SPE accelerated version
+// High performance variant based on SPE accelerated version.  This
+// variant loads a whole particle with a single 4-vector load and thus
+// requires the AoS particle layout.
 
 using namespace v4;
 
 int
-move_p( particle_t       * RESTRICT ALIGNED(128) p,
+move_p( particle_block_t * RESTRICT ALIGNED(128) p,
         particle_mover_t * RESTRICT ALIGNED(16)  pm,
         accumulator_t    * RESTRICT ALIGNED(128) a,
         const grid_t     *                       g,
@@ -213,7 +215,7 @@ move_p( particle_t       * RESTRICT ALIGNED(128) p,
 #else
 
 int
-move_p( particle_t       * ALIGNED(128) p0,
+move_p( particle_block_t * ALIGNED(128) p0,
         particle_mover_t * ALIGNED(16)  pm,
         accumulator_t    * ALIGNED(128) a0,
         const grid_t     *              g,
@@ -226,15 +228,15 @@ move_p( particle_t       * ALIGNED(128) p0,
   int axis, face;
   int64_t neighbor;
   float * a;
-  particle_t * ALIGNED(32) p = p0 + pm->i;
+  const int32_t n = pm->i;
 
-  q = qsp * p->w;
+  q = qsp * P_ELEM( p0, n, w );
 
   for( ;; )
   {
-    s_midx = p->dx;
-    s_midy = p->dy;
-    s_midz = p->dz;
+    s_midx = P_ELEM( p0, n, dx );
+    s_midy = P_ELEM( p0, n, dy );
+    s_midz = P_ELEM( p0, n, dz );
 
     s_dispx = pm->dispx;
     s_dispy = pm->dispy;
@@ -276,7 +278,7 @@ move_p( particle_t       * ALIGNED(128) p0,
     // current quadrant in a time-step
     v5 = q * s_dispx * s_dispy * s_dispz * ( 1.0 / 3.0 );
 
-    a  = (float *) ( a0 + p->i );
+    a  = (float *) ( a0 + P_ELEM( p0, n, i ) );
 
     #define accumulate_j(X,Y,Z)                                       \
     v4  = q*s_disp##X;    /* v2 = q ux                            */  \
@@ -310,9 +312,9 @@ move_p( particle_t       * ALIGNED(128) p0,
     pm->dispz -= s_dispz;
 
     // Compute the new particle offset.
-    p->dx += s_dispx + s_dispx;
-    p->dy += s_dispy + s_dispy;
-    p->dz += s_dispz + s_dispz;
+    P_ELEM( p0, n, dx ) += s_dispx + s_dispx;
+    P_ELEM( p0, n, dy ) += s_dispy + s_dispy;
+    P_ELEM( p0, n, dz ) += s_dispz + s_dispz;
 
     // If an end streak, return success (should be ~50% of the time). This
     // is the case where the particle moves to a voxel located within the
@@ -332,8 +334,8 @@ move_p( particle_t       * ALIGNED(128) p0,
 
     v0 = s_dir[axis];
 
-    ( &( p->dx ) )[axis] = v0; // Avoid roundoff fiascos--put the particle
-                               // _exactly_ on the boundary.
+    // Avoid roundoff fiascos--put the particle _exactly_ on the boundary.
+    ( &P_ELEM( p0, n, dx ) )[axis*PARTICLE_BLOCK_SIZE] = v0;
 
     face = axis;
 
@@ -342,14 +344,15 @@ move_p( particle_t       * ALIGNED(128) p0,
       face += 3;
     }
 
-    neighbor = g->neighbor[ 6 * p->i + face ];
+    neighbor = g->neighbor[ 6 * P_ELEM( p0, n, i ) + face ];
 
     if ( UNLIKELY( neighbor == reflect_particles ) )
     {
       // Hit a reflecting boundary condition.  Reflect the particle
       // momentum and remaining displacement and keep moving the
       // particle.
-      ( &( p->ux     ) )[axis] = - ( &( p->ux     ) )[axis];
+      ( &P_ELEM( p0, n, ux ) )[axis*PARTICLE_BLOCK_SIZE] =
+        - ( &P_ELEM( p0, n, ux ) )[axis*PARTICLE_BLOCK_SIZE];
       ( &( pm->dispx ) )[axis] = - ( &( pm->dispx ) )[axis];
 
       continue;
@@ -361,7 +364,7 @@ move_p( particle_t       * ALIGNED(128) p0,
       // Cannot handle the boundary condition here.  Save the updated
       // particle position, face it hit and update the remaining
       // displacement in the particle mover.
-      p->i = 8 * p->i + face;
+      P_ELEM( p0, n, i ) = 8 * P_ELEM( p0, n, i ) + face;
 
       return 1; // Return "mover still in use"
     }
@@ -369,9 +372,12 @@ move_p( particle_t       * ALIGNED(128) p0,
     // Crossed into a normal voxel.  Update the voxel index, convert the
     // particle coordinate system and keep moving the particle.
 
-    p->i = neighbor - g->rangel; // Compute local index of neighbor
-    /**/                         // Note: neighbor - g->rangel < 2^31 / 6
-    ( &( p->dx ) )[axis] = - v0; // Convert coordinate system
+    // Compute local index of neighbor
+    // Note: neighbor - g->rangel < 2^31 / 6
+    P_ELEM( p0, n, i ) = neighbor - g->rangel;
+
+    // Convert coordinate system
+    ( &P_ELEM( p0, n, dx ) )[axis*PARTICLE_BLOCK_SIZE] = - v0;
   }
 
   return 0; // Return "mover not in use"
@@ -22,12 +22,15 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
                            int pipeline_rank,
                            int n_pipeline )
 {
-  particle_t           * ALIGNED(128) p0 = args->p0;
+  particle_block_t     * ALIGNED(128) p0 = args->p0;
   accumulator_t        * ALIGNED(128) a0 = args->a0;
   const interpolator_t * ALIGNED(128) f0 = args->f0;
   const grid_t *                      g  = args->g;
 
-  particle_t           * ALIGNED(32)  p;
+  const interpolator_bf16_t * ALIGNED(128) fh = args->fh;
+
+  unsigned char * moved = args->moved;  // Particles that changed voxel
+
   particle_mover_t     * ALIGNED(16)  pm;
   const interpolator_t * ALIGNED(16)  f;
   float                * ALIGNED(16)  a;
@@ -40,21 +43,26 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
   const float one            = 1.0;
   const float one_third      = 1.0/3.0;
   const float two_fifteenths = 2.0/15.0;
+  const float one_half       = 0.5;
+  const float four           = 4.0;
+  const int   pusher         = args->pusher;
 
   float dx, dy, dz, ux, uy, uz, q;
   float hax, hay, haz, cbx, cby, cbz;
   float v0, v1, v2, v3, v4, v5;
   int   ii;
 
-  int itmp, n, nm, max_nm;
+  int ip, itmp, n, nm, nd, max_nm, sl, sh, vl, vh;
 
   DECLARE_ALIGNED_ARRAY( particle_mover_t, 16, local_pm, 1 );
 
+  DECLARE_ALIGNED_ARRAY( interpolator_t, 16, local_f, 1 );
+
   // Determine which quads of particles quads this pipeline processes.
 
   DISTRIBUTE( args->np, 16, pipeline_rank, n_pipeline, itmp, n );
 
-  p = args->p0 + itmp;
+  ip = itmp;
 
   // Determine which movers are reserved for this pipeline.
   // Movers (16 bytes) should be reserved for pipelines in at least
@@ -84,17 +92,54 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
           POW2_CEIL( (args->nx+2)*(args->ny+2)*(args->nz+2), 2 );
   }
 
+  // Particles in voxels outside [sl,sh] that leave their voxel are not
+  // moved by this pipeline.  Their movers are deferred to the caller
+  // and are stored at the end of this pipeline's movers.
+
+  nd = 0;
+  sl = 0;
+  sh = g->nv - 1;
+
+  // Voxels of the particles pushed.  See reduce_accumulator_array.
+
+  vl = g->nv;
+  vh = -1;
+
+  // With tiled accumulation, the work assignment of this pipeline was
+  // set up by the caller.
+
+  if ( args->tile )
+  {
+    ip     = args->tile[ pipeline_rank ].i0;
+    n      = args->tile[ pipeline_rank ].n;
+    a0     = args->tile[ pipeline_rank ].a0;
+    pm     = args->tile[ pipeline_rank ].pm;
+    max_nm = args->tile[ pipeline_rank ].max_nm;
+    sl     = args->tile[ pipeline_rank ].sl;
+    sh     = args->tile[ pipeline_rank ].sh;
+  }
+
   // Process particles for this pipeline.
 
-  for( ; n; n--, p++ )
+  for( ; n; n--, ip++ )
   {
-    dx   = p->dx;                             // Load position
-    dy   = p->dy;
-    dz   = p->dz;
-    ii   = p->i;
+    dx   = P_ELEM( p0, ip, dx );              // Load position
+    dy   = P_ELEM( p0, ip, dy );
+    dz   = P_ELEM( p0, ip, dz );
+    ii   = P_ELEM( p0, ip, i  );
+
+    if ( ii < vl ) vl = ii;                   // Track pushed voxels
+    if ( ii > vh ) vh = ii;
 
     f    = f0 + ii;                           // Interpolate E
 
+    if ( fh )
+    {
+      load_interpolator_bf16( local_f, fh + ii );
+
+      f  = local_f;
+    }
+
     hax  = qdt_2mc*(    ( f->ex    + dy*f->dexdy    ) +
                      dz*( f->dexdz + dy*f->d2exdydz ) );
 
@@ -108,39 +153,102 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
     cby  = f->cby + dy*f->dcbydy;
     cbz  = f->cbz + dz*f->dcbzdz;
 
-    ux   = p->ux;                             // Load momentum
-    uy   = p->uy;
-    uz   = p->uz;
-    q    = p->w;
+    ux   = P_ELEM( p0, ip, ux );              // Load momentum
+    uy   = P_ELEM( p0, ip, uy );
+    uz   = P_ELEM( p0, ip, uz );
+    q    = P_ELEM( p0, ip, w  );
 
-    ux  += hax;                               // Half advance E
-    uy  += hay;
-    uz  += haz;
+    if ( pusher == boris_pusher )
+    {
+      ux  += hax;                             // Half advance E
+      uy  += hay;
+      uz  += haz;
 
-    v0   = qdt_2mc / sqrtf( one + ( ux*ux + ( uy*uy + uz*uz ) ) );
+      v0   = qdt_2mc / sqrtf( one + ( ux*ux + ( uy*uy + uz*uz ) ) );
 
                                               // Boris - scalars
-    v1   = cbx*cbx + ( cby*cby + cbz*cbz );
-    v2   = ( v0*v0 ) * v1;
-    v3   = v0 * ( one + v2 * ( one_third + v2 * two_fifteenths ) );
-    v4   = v3 / ( one + v1 * ( v3 * v3 ) );
-    v4  += v4;
+      v1   = cbx*cbx + ( cby*cby + cbz*cbz );
+      v2   = ( v0*v0 ) * v1;
+      v3   = v0 * ( one + v2 * ( one_third + v2 * two_fifteenths ) );
+      v4   = v3 / ( one + v1 * ( v3 * v3 ) );
+      v4  += v4;
+
+      v0   = ux + v3*( uy*cbz - uz*cby );     // Boris - uprime
+      v1   = uy + v3*( uz*cbx - ux*cbz );
+      v2   = uz + v3*( ux*cby - uy*cbx );
+
+      ux  += v4*( v1*cbz - v2*cby );          // Boris - rotation
+      uy  += v4*( v2*cbx - v0*cbz );
+      uz  += v4*( v0*cby - v1*cbx );
+
+      ux  += hax;                             // Half advance E
+      uy  += hay;
+      uz  += haz;
+    }
+
+    else if ( pusher == higuera_cary_pusher )
+    {
+      ux  += hax;                             // Half advance E
+      uy  += hay;
+      uz  += haz;
+
+      cbx *= qdt_2mc;                         // HC - tau
+      cby *= qdt_2mc;
+      cbz *= qdt_2mc;
+
+      v4   = cbx*cbx + ( cby*cby + cbz*cbz ); // HC - gamma at time step
+      v5   = ux*cbx + ( uy*cby + uz*cbz );
+      v0   = one + ( ux*ux + ( uy*uy + uz*uz ) ) - v4;
+      v0   = one / sqrtf( one_half*( v0 + sqrtf( v0*v0 + four*( v4 + v5*v5 ) ) ) );
 
-    v0   = ux + v3*( uy*cbz - uz*cby );       // Boris - uprime
-    v1   = uy + v3*( uz*cbx - ux*cbz );
-    v2   = uz + v3*( ux*cby - uy*cbx );
+      cbx *= v0;                              // HC - t
+      cby *= v0;
+      cbz *= v0;
 
-    ux  += v4*( v1*cbz - v2*cby );            // Boris - rotation
-    uy  += v4*( v2*cbx - v0*cbz );
-    uz  += v4*( v0*cby - v1*cbx );
+      v4   = one / ( one + ( cbx*cbx + ( cby*cby + cbz*cbz ) ) );
+      v5   = ux*cbx + ( uy*cby + uz*cbz );
 
-    ux  += hax;                               // Half advance E
-    uy  += hay;
-    uz  += haz;
+      v0   = v4*( ux + v5*cbx + ( uy*cbz - uz*cby ) ); // HC - uplus
+      v1   = v4*( uy + v5*cby + ( uz*cbx - ux*cbz ) );
+      v2   = v4*( uz + v5*cbz + ( ux*cby - uy*cbx ) );
 
-    p->ux = ux;                               // Store momentum
-    p->uy = uy;
-    p->uz = uz;
+      ux   = v0 + hax + ( v1*cbz - v2*cby ); // HC - rotation, half advance E
+      uy   = v1 + hay + ( v2*cbx - v0*cbz );
+      uz   = v2 + haz + ( v0*cby - v1*cbx );
+    }
+
+    else // vay_pusher
+    {
+      cbx *= qdt_2mc;                         // Vay - tau
+      cby *= qdt_2mc;
+      cbz *= qdt_2mc;
+
+      v0   = one / sqrtf( one + ( ux*ux + ( uy*uy + uz*uz ) ) );
+
+      v1   = ux + ( hax + hax ) + v0*( uy*cbz - uz*cby ); // Vay - ustar
+      v2   = uy + ( hay + hay ) + v0*( uz*cbx - ux*cbz );
+      v3   = uz + ( haz + haz ) + v0*( ux*cby - uy*cbx );
+
+      v4   = cbx*cbx + ( cby*cby + cbz*cbz ); // Vay - gamma at new step
+      v5   = v1*cbx + ( v2*cby + v3*cbz );
+      v0   = one + ( v1*v1 + ( v2*v2 + v3*v3 ) ) - v4;
+      v0   = one / sqrtf( one_half*( v0 + sqrtf( v0*v0 + four*( v4 + v5*v5 ) ) ) );
+
+      cbx *= v0;                              // Vay - t
+      cby *= v0;
+      cbz *= v0;
+
+      v4   = one / ( one + ( cbx*cbx + ( cby*cby + cbz*cbz ) ) );
+      v5   = v1*cbx + ( v2*cby + v3*cbz );
+
+      ux   = v4*( v1 + v5*cbx + ( v2*cbz - v3*cby ) ); // Vay - rotation
+      uy   = v4*( v2 + v5*cby + ( v3*cbx - v1*cbz ) );
+      uz   = v4*( v3 + v5*cbz + ( v1*cby - v2*cbx ) );
+    }
+
+    P_ELEM( p0, ip, ux ) = ux;                // Store momentum
+    P_ELEM( p0, ip, uy ) = uy;
+    P_ELEM( p0, ip, uz ) = uz;
 
     v0   = one / sqrtf( one + ( ux*ux+ ( uy*uy + uz*uz ) ) );
                                               // Get norm displacement
@@ -171,9 +279,9 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
 
       q *= qsp;
 
-      p->dx = v3;                             // Store new position
-      p->dy = v4;
-      p->dz = v5;
+      P_ELEM( p0, ip, dx ) = v3;              // Store new position
+      P_ELEM( p0, ip, dy ) = v4;
+      P_ELEM( p0, ip, dz ) = v5;
 
       dx = v0;                                // Streak midpoint
       dy = v1;
@@ -216,11 +324,35 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
       local_pm->dispy = uy;
       local_pm->dispz = uz;
 
-      local_pm->i     = p - p0;
+      local_pm->i     = ip;
+
+      if ( uz > one || uz < -one )              // Unlikely
+      {
+        vl = 0;                                 // Can cross more than one
+        vh = g->nv - 1;                         // z face
+      }
+
+      if ( moved )                              // Record for the next sort
+      {
+        moved[ ip >> 3 ] |= 1 << ( ip & 7 );
+      }
+
+      if ( ii < sl || ii > sh )                 // Unlikely
+      {
+        if ( nm + nd < max_nm )
+        {
+          pm[ max_nm - ++nd ] = local_pm[0];
+        }
+
+        else
+        {
+          itmp++;                               // Unlikely
+        }
+      }
 
-      if ( move_p( p0, local_pm, a0, g, qsp ) ) // Unlikely
+      else if ( move_p( p0, local_pm, a0, g, qsp ) ) // Unlikely
       {
-        if ( nm < max_nm )
+        if ( nm + nd < max_nm )
         {
           pm[nm++] = local_pm[0];
         }
@@ -232,7 +364,7 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
           // Also undo the shift that move_p did, to keep p->i in a valid range
           // If we got here, we're running the risk of ruining the physics of
           // the simulation. Take the mover warning very seriously.
-          p->i = p->i >> 3;
+          P_ELEM( p0, ip, i ) = P_ELEM( p0, ip, i ) >> 3;
         }
       }
     }
@@ -242,8 +374,225 @@ advance_p_pipeline_scalar( advance_p_pipeline_args_t * args,
   args->seg[ pipeline_rank ].max_nm    = max_nm;
   args->seg[ pipeline_rank ].nm        = nm;
   args->seg[ pipeline_rank ].n_ignored = itmp;
+  args->seg[ pipeline_rank ].nd        = nd  ;
+  args->seg[ pipeline_rank ].vl        = vl;
+  args->seg[ pipeline_rank ].vh        = vh;
 }
 
+//----------------------------------------------------------------------------//
+// Gather the movers of a pipeline into the species mover list.
+//----------------------------------------------------------------------------//
+
+static void
+collect_movers( species_t * RESTRICT sp,
+                const particle_mover_seg_t * RESTRICT seg,
+                int rank )
+{
+  if ( seg[rank].n_ignored )
+  {
+#ifdef EXIT_ON_LOST_MOVER
+      ERROR( ( "Pipeline %i (species = %s) ran out of storage for %i movers.  This is an extremely serious problem that affects the physics of your run.",
+                  rank,
+                  sp->name,
+                  seg[rank].n_ignored ) );
+#else
+      // If you see this warning, particles are essentially being held at the
+      // boundary instead of finishing their move. They are now in the wrong
+      // place and have not deposited correct currents....
+      WARNING( ( "Pipeline %i (species = %s) ran out of storage for %i movers.  This is an extremely serious problem that affects the physics of your run.",
+                  rank,
+                  sp->name,
+                  seg[rank].n_ignored ) );
+#endif
+  }
+
+  if ( sp->pm + sp->nm != seg[rank].pm )
+  {
+    MOVE( sp->pm + sp->nm,
+          seg[rank].pm,
+          seg[rank].nm );
+  }
+
+  sp->nm += seg[rank].nm;
+}
+
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+
+//----------------------------------------------------------------------------//
+// Tiled accumulation.
+//
+// Instead of giving each pipeline a private copy of the whole accumulator
+// array, each pipeline accumulates into a tile accumulator that only
+// covers the voxels of the particles it pushes plus a halo.  Since the
+// particles are sorted, the particles assigned to a pipeline are in a
+// contiguous range of voxels, its tile.  The range is found from the
+// partitioning of the last sort.  Particles that are no longer in the
+// tile of their pipeline are pushed by the host into the host
+// accumulator.  The tile accumulators are then flushed into the host
+// accumulator so that there is nothing left for reduce_accumulator_array
+// to do.
+//----------------------------------------------------------------------------//
+
+// boundary_p needs the movers in increasing particle order.  Movers of
+// particles pushed by the host after the pipelines are out of order.
+
+static int
+compare_mover( const void * a,
+               const void * b )
+{
+  return ( (const particle_mover_t *) a )->i -
+         ( (const particle_mover_t *) b )->i;
+}
+
+// Find the voxel on [vl,vh] that contained particle i at the last sort.
+
+static int
+find_voxel( const int * RESTRICT partition,
+            int vl,
+            int vh,
+            int i )
+{
+  int v;
+
+  while( vl < vh )
+  {
+    v = vl + ( vh - vl + 1 ) / 2;
+
+    if ( partition[v] <= i ) vl = v;
+    else                     vh = v - 1;
+  }
+
+  return vl;
+}
+
+static void
+setup_tiles( species_t * RESTRICT sp,
+             accumulator_array_t * RESTRICT aa,
+             advance_p_pipeline_args_t * RESTRICT args,
+             advance_p_tile_t * RESTRICT tile )
+{
+  const grid_t * g = sp->g;
+
+  const int halo = ACCUMULATOR_TILE_HALO( g );
+  const int vl   = VOXEL( 1,     1,     1,     g->nx, g->ny, g->nz );
+  const int vh   = VOXEL( g->nx, g->ny, g->nz, g->nx, g->ny, g->nz );
+
+  int sl = 0, sh = g->nv - 1;
+
+  accumulator_t * ALIGNED(128) a = aa->tile;
+
+  advance_p_tile_t * t;
+
+  int n_pipeline = N_PIPELINE;
+  int rank, itmp, max_nm;
+
+  if ( g->sfc_type != voxel_order )
+  {
+    ERROR( ( "Tiled accumulation requires voxel_order." ) );
+  }
+
+  if ( g->nv + n_pipeline * ( 2 * halo + 1 ) > aa->n_tile )
+  {
+    ERROR( ( "Tile accumulators are too small for %i pipelines.",
+             n_pipeline ) );
+  }
+
+  // If the local domain is periodic in z, particles in the first and last
+  // z-planes can wrap around to the other end of the local domain.  The
+  // halo does not cover that.
+
+  if ( g->nz > 2 )
+  {
+    int64_t nn = g->neighbor[ 6 * vh + 5 ];
+
+    if ( nn >= g->rangel && nn <= g->rangeh )
+    {
+      sl = VOXEL( 0,     0,     2,     g->nx, g->ny, g->nz );
+      sh = VOXEL( g->nx+1, g->ny+1, g->nz-1, g->nx, g->ny, g->nz );
+    }
+  }
+
+  // A subcycled species can cross more than one face on an axis in a
+  // push.  The halo does not cover that either, so all its moves are left
+  // to the host.
+
+  if ( sp->subcycle > 1 )
+  {
+    sl = g->nv;
+    sh = -1;
+  }
+
+  // Tiles are found from the partitioning of the last sort.
+
+  if ( sp->last_sorted == INT64_MIN && sp->np )
+  {
+    sort_p( sp );
+  }
+
+  // Movers are reserved the same way as in the pipeline functions.
+
+  max_nm = args->max_nm - ( args->np&15 );
+
+  if ( max_nm < 0 ) max_nm = 0;
+
+  for( rank = 0; rank < n_pipeline; rank++ )
+  {
+    t = tile + rank;
+
+    DISTRIBUTE( args->np, 16, rank, n_pipeline, t->i0, t->np );
+
+    DISTRIBUTE( max_nm, 8, rank, n_pipeline, itmp, t->max_nm );
+
+    t->pm = args->pm + itmp;
+    t->n  = 0;
+    t->sl = sl;
+    t->sh = sh;
+
+    if ( t->np )
+    {
+      t->vl = find_voxel( sp->partition, vl, vh, t->i0             );
+      t->vh = find_voxel( sp->partition, vl, vh, t->i0 + t->np - 1 );
+      t->wl = t->vl - halo > 0         ? t->vl - halo : 0;
+      t->wh = t->vh + halo < g->nv - 1 ? t->vh + halo : g->nv - 1;
+      t->a0 = a - t->wl;
+
+      a += t->wh - t->wl + 1;
+    }
+
+    else
+    {
+      t->vl = 0;
+      t->vh = -1;
+      t->wl = 0;
+      t->wh = -1;
+      t->a0 = a;
+    }
+  }
+
+  // The host pushes the last incomplete block into the host accumulator.
+
+  t = tile + n_pipeline;
+
+  DISTRIBUTE( args->np, 16, n_pipeline, n_pipeline, t->i0, t->np );
+
+  DISTRIBUTE( max_nm, 8, n_pipeline, n_pipeline, itmp, t->max_nm );
+
+  t->max_nm = args->max_nm - itmp;
+  t->pm     = args->pm + itmp;
+  t->n      = t->np;
+  t->a0     = aa->a;
+  t->vl     = 0;
+  t->vh     = -1;
+  t->wl     = 0;
+  t->wh     = -1;
+  t->sl     = 0;
+  t->sh     = g->nv - 1;
+
+  args->tile = tile;
+}
+
+#endif // VPIC_USE_TILED_ACCUMULATORS
+
 //----------------------------------------------------------------------------//
 // Top level function to select and call the proper advance_p pipeline
 // function.
@@ -258,6 +607,18 @@ advance_p_pipeline( species_t * RESTRICT sp,
 
   DECLARE_ALIGNED_ARRAY( particle_mover_seg_t, 128, seg, MAX_PIPELINE + 1 );
 
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+  DECLARE_ALIGNED_ARRAY( advance_p_tile_t, 128, tile, MAX_PIPELINE + 1 );
+
+  DECLARE_ALIGNED_ARRAY( tile_p_pipeline_args_t, 128, targs, 1 );
+
+  DECLARE_ALIGNED_ARRAY( particle_mover_t, 16, local_pm, 1 );
+
+  advance_p_tile_t * t;
+
+  int n_deferred = 0;
+#endif
+
   int rank;
 
   if ( ! sp           ||
@@ -269,17 +630,28 @@ advance_p_pipeline( species_t * RESTRICT sp,
     ERROR( ( "Bad args." ) );
   }
 
+  if ( sp->pusher != boris_pusher &&
+       sp->pusher != vay_pusher   &&
+       sp->pusher != higuera_cary_pusher )
+  {
+    ERROR( ( "Unknown particle pusher %i for species \"%s\".",
+             sp->pusher, sp->name ) );
+  }
+
   args->p0      = sp->p;
   args->pm      = sp->pm;
   args->a0      = aa->a;
   args->f0      = ia->i;
+  args->fh      = ia->h;
   args->seg     = seg;
   args->g       = sp->g;
+  args->tile    = NULL;
+  args->moved   = NULL;
 
-  args->qdt_2mc = ( sp->q * sp->g->dt ) / ( 2 * sp->m * sp->g->cvac );
-  args->cdt_dx  = sp->g->cvac * sp->g->dt * sp->g->rdx;
-  args->cdt_dy  = sp->g->cvac * sp->g->dt * sp->g->rdy;
-  args->cdt_dz  = sp->g->cvac * sp->g->dt * sp->g->rdz;
+  args->qdt_2mc = ( sp->q * SPECIES_DT( sp ) ) / ( 2 * sp->m * sp->g->cvac );
+  args->cdt_dx  = sp->g->cvac * SPECIES_DT( sp ) * sp->g->rdx;
+  args->cdt_dy  = sp->g->cvac * SPECIES_DT( sp ) * sp->g->rdy;
+  args->cdt_dz  = sp->g->cvac * SPECIES_DT( sp ) * sp->g->rdz;
   args->qsp     = sp->q;
 
   args->np      = sp->np;
@@ -287,6 +659,33 @@ advance_p_pipeline( species_t * RESTRICT sp,
   args->nx      = sp->g->nx;
   args->ny      = sp->g->ny;
   args->nz      = sp->g->nz;
+  args->pusher  = sp->pusher;
+
+  // For a fused species that was sorted this step, every particle is in
+  // the partition of its voxel.  So only the particles the push moves to
+  // another voxel (which the kernels mark in the moved bitmap) and
+  // particles boundary_p later changes or adds need repair by the next
+  // sort.  See sort_p_pipeline.
+
+  sp->moved_np = -1;
+
+  if ( sp->sort_fused                   &&
+      !sp->sort_in_place                &&
+       sp->last_sorted == sp->g->step )
+  {
+    if ( sp->max_moved < sp->max_np )
+    {
+      FREE_ALIGNED( sp->moved );
+
+      MALLOC_ALIGNED( sp->moved, ( sp->max_np + 7 ) / 8, 128 );
+
+      sp->max_moved = sp->max_np;
+    }
+
+    CLEAR( sp->moved, ( sp->np + 7 ) / 8 );
+
+    args->moved = sp->moved;
+  }
 
   // Have the host processor do the last incomplete bundle if necessary.
   // Note: This is overlapped with the pipelined processing.  As such,
@@ -299,10 +698,37 @@ advance_p_pipeline( species_t * RESTRICT sp,
   // However, it is worth reconsidering this at some point in the
   // future.
 
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+  setup_tiles( sp, aa, args, tile );
+
+  // setup_tiles may have sorted the particles.
+  args->p0      = sp->p;
+
+  targs->p0     = sp->p;
+  targs->tile   = tile;
+  targs->a0     = aa->a;
+  targs->n_tile = N_PIPELINE;
+  targs->nv     = sp->g->nv;
+
+  tile_p_pipeline( targs );
+#endif
+
   EXEC_PIPELINES( advance_p, args, 0 );
 
   WAIT_PIPELINES();
 
+  // Record the voxels of the particles pushed into each pipeline
+  // accumulator so that they can be reduced and cleared sparsely.
+
+  for( rank = 0; rank < aa->n_pipeline; rank++ )
+  {
+    if ( seg[rank].vl < aa->pushed[ 2*rank     ] )
+      aa->pushed[ 2*rank     ] = seg[rank].vl;
+
+    if ( seg[rank].vh > aa->pushed[ 2*rank + 1 ] )
+      aa->pushed[ 2*rank + 1 ] = seg[rank].vh;
+  }
+
   // FIXME: HIDEOUS HACK UNTIL BETTER PARTICLE MOVER SEMANTICS
   // INSTALLED FOR DEALING WITH PIPELINES.  COMPACT THE PARTICLE
   // MOVERS TO ELIMINATE HOLES FROM THE PIPELINING.
@@ -310,31 +736,62 @@ advance_p_pipeline( species_t * RESTRICT sp,
   sp->nm = 0;
   for( rank = 0; rank <= N_PIPELINE; rank++ )
   {
-    if ( args->seg[rank].n_ignored )
-    {
-#ifdef EXIT_ON_LOST_MOVER
-        ERROR( ( "Pipeline %i (species = %s) ran out of storage for %i movers.  This is an extremely serious problem that affects the physics of your run.",
-                    rank,
-                    sp->name,
-                    args->seg[rank].n_ignored ) );
-#else
-        // If you see this warning, particles are essentially being held at the
-        // boundary instead of finishing their move. They are now in the wrong
-        // place and have not deposited correct currents....
-        WARNING( ( "Pipeline %i (species = %s) ran out of storage for %i movers.  This is an extremely serious problem that affects the physics of your run.",
-                    rank,
-                    sp->name,
-                    args->seg[rank].n_ignored ) );
-#endif
-    }
+    collect_movers( sp, seg, rank );
+
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+    // Finish the moves the pipeline deferred.  These are at the end of the
+    // pipeline's movers, past where the compacted movers are written.
 
-    if ( sp->pm + sp->nm != args->seg[rank].pm )
+    for( int n = seg[rank].max_nm - seg[rank].nd; n < seg[rank].max_nm; n++ )
     {
-      MOVE( sp->pm + sp->nm,
-            args->seg[rank].pm,
-            args->seg[rank].nm );
+      local_pm[0] = seg[rank].pm[n];
+
+      if ( move_p( sp->p, local_pm, aa->a, sp->g, sp->q ) )
+      {
+        sp->pm[ sp->nm++ ] = local_pm[0];
+      }
     }
 
-    sp->nm += args->seg[rank].nm;
+    n_deferred += seg[rank].nd;
+#endif
+  }
+
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+  // Push the particles that were not in the tile of their pipeline into
+  // the host accumulator and flush the tile accumulators.
+
+  t = tile + N_PIPELINE;
+
+  for( rank = 0; rank < N_PIPELINE; rank++ )
+  {
+    if ( tile[rank].n == tile[rank].np ) continue;
+
+    t->i0     = tile[rank].i0 + tile[rank].n;
+    t->n      = tile[rank].np - tile[rank].n;
+    t->pm     = sp->pm + sp->nm;
+    t->max_nm = sp->max_nm - sp->nm;
+
+    advance_p_pipeline_scalar( args, N_PIPELINE, N_PIPELINE );
+
+    collect_movers( sp, seg, N_PIPELINE );
+
+    n_deferred++;
+  }
+
+  if ( n_deferred )
+  {
+    qsort( sp->pm, sp->nm, sizeof( particle_mover_t ), compare_mover );
+  }
+
+  flush_tile_pipeline( targs );
+#endif
+
+  // Particles that boundary_p removes are back filled from the end of the
+  // particle array and particles it adds are appended.  A particle past
+  // the first np - nm can thus be changed before the next sort.
+
+  if ( args->moved )
+  {
+    sp->moved_np = sp->np - sp->nm;
   }
 }
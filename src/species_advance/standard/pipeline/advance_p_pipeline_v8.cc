@@ -11,12 +11,13 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
                        int pipeline_rank,
                        int n_pipeline )
 {
-  particle_t           * ALIGNED(128) p0 = args->p0;
+  particle_block_t     * ALIGNED(128) p0 = args->p0;
   accumulator_t        * ALIGNED(128) a0 = args->a0;
   const interpolator_t * ALIGNED(128) f0 = args->f0;
+  const interpolator_bf16_t * ALIGNED(128) fh = args->fh;
   const grid_t         *              g  = args->g;
 
-  particle_t           * ALIGNED(128) p;
+  particle_block_t     * ALIGNED(128) p;
   particle_mover_t     * ALIGNED(16)  pm;
 
   float                * ALIGNED(32)  vp00;
@@ -38,23 +39,31 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
   const v8float one_third(1.0/3.0);
   const v8float two_fifteenths(2.0/15.0);
   const v8float neg_one(-1.0);
+  const v8float one_half(0.5);
+  const v8float four(4.0);
 
   const float _qsp = args->qsp;
 
+  const int pusher = args->pusher;
+
+  unsigned char * RESTRICT moved = args->moved;
+
   v8float dx, dy, dz, ux, uy, uz, q;
   v8float hax, hay, haz, cbx, cby, cbz;
   v8float v00, v01, v02, v03, v04, v05, v06, v07, v08, v09;
   v8int   ii, outbnd;
 
-  int itmp, nq, nm, max_nm;
+  int ip, itmp, nq, nm, nd, max_nm, sl, sh, vl, vh;
+
+  DECLARE_ALIGNED_ARRAY( particle_mover_t, 16, batch_pm, 8 );
 
-  DECLARE_ALIGNED_ARRAY( particle_mover_t, 16, local_pm, 1 );
+  DECLARE_ALIGNED_ARRAY( interpolator_t, 32, local_f, 8 );
 
   // Determine which quads of particle quads this pipeline processes.
 
   DISTRIBUTE( args->np, 16, pipeline_rank, n_pipeline, itmp, nq );
 
-  p = args->p0 + itmp;
+  ip = itmp;
 
   nq >>= 3;
 
@@ -86,28 +95,92 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
           POW2_CEIL( (args->nx+2)*(args->ny+2)*(args->nz+2), 2 );
   }
 
+  // Particles in voxels outside [sl,sh] that leave their voxel are not
+  // moved by this pipeline.  Their movers are deferred to the caller
+  // and are stored at the end of this pipeline's movers.
+
+  nd = 0;
+  sl = 0;
+  sh = g->nv - 1;
+
+  // Voxels of the particles pushed.  See reduce_accumulator_array.
+
+  vl = g->nv;
+  vh = -1;
+
+  // With tiled accumulation, the work assignment of this pipeline was
+  // set up by the caller.
+
+  if ( args->tile )
+  {
+    ip     = args->tile[ pipeline_rank ].i0;
+    nq     = args->tile[ pipeline_rank ].n >> 3;
+    a0     = args->tile[ pipeline_rank ].a0;
+    pm     = args->tile[ pipeline_rank ].pm;
+    max_nm = args->tile[ pipeline_rank ].max_nm;
+    sl     = args->tile[ pipeline_rank ].sl;
+    sh     = args->tile[ pipeline_rank ].sh;
+  }
+
   // Process the particle blocks for this pipeline.
 
-  for( ; nq; nq--, p+=8 )
+  for( ; nq; nq--, ip+=8 )
   {
+#   if defined(VPIC_USE_AOSOA_P)
+    p = p0 + ip / PARTICLE_BLOCK_SIZE;
+#   else
+    p = p0 + ip;
+#   endif
+
     //--------------------------------------------------------------------------
     // Load particle data.
     //--------------------------------------------------------------------------
+#   if defined(VPIC_USE_AOSOA_P)
+    load_8x1( &p->dx[ ip % PARTICLE_BLOCK_SIZE ], dx );
+    load_8x1( &p->dy[ ip % PARTICLE_BLOCK_SIZE ], dy );
+    load_8x1( &p->dz[ ip % PARTICLE_BLOCK_SIZE ], dz );
+    load_8x1( &p->i [ ip % PARTICLE_BLOCK_SIZE ], ii );
+    load_8x1( &p->ux[ ip % PARTICLE_BLOCK_SIZE ], ux );
+    load_8x1( &p->uy[ ip % PARTICLE_BLOCK_SIZE ], uy );
+    load_8x1( &p->uz[ ip % PARTICLE_BLOCK_SIZE ], uz );
+    load_8x1( &p->w [ ip % PARTICLE_BLOCK_SIZE ], q  );
+#   else
     load_8x8_tr( &p[0].dx, &p[1].dx, &p[2].dx, &p[3].dx,
                  &p[4].dx, &p[5].dx, &p[6].dx, &p[7].dx,
                  dx, dy, dz, ii, ux, uy, uz, q );
+#   endif
 
     //--------------------------------------------------------------------------
     // Set field interpolation pointers.
     //--------------------------------------------------------------------------
-    vp00 = ( float * ALIGNED(32) ) ( f0 + ii( 0) );
-    vp01 = ( float * ALIGNED(32) ) ( f0 + ii( 1) );
-    vp02 = ( float * ALIGNED(32) ) ( f0 + ii( 2) );
-    vp03 = ( float * ALIGNED(32) ) ( f0 + ii( 3) );
-    vp04 = ( float * ALIGNED(32) ) ( f0 + ii( 4) );
-    vp05 = ( float * ALIGNED(32) ) ( f0 + ii( 5) );
-    vp06 = ( float * ALIGNED(32) ) ( f0 + ii( 6) );
-    vp07 = ( float * ALIGNED(32) ) ( f0 + ii( 7) );
+    if ( fh )
+    {
+      // Expand the BF16 interpolators of the particles.
+      for( int k = 0; k < 8; k++ )
+      {
+        load_interpolator_bf16( local_f + k, fh + ii(k) );
+      }
+
+      vp00 = ( float * ALIGNED(32) ) ( local_f +  0 );
+      vp01 = ( float * ALIGNED(32) ) ( local_f +  1 );
+      vp02 = ( float * ALIGNED(32) ) ( local_f +  2 );
+      vp03 = ( float * ALIGNED(32) ) ( local_f +  3 );
+      vp04 = ( float * ALIGNED(32) ) ( local_f +  4 );
+      vp05 = ( float * ALIGNED(32) ) ( local_f +  5 );
+      vp06 = ( float * ALIGNED(32) ) ( local_f +  6 );
+      vp07 = ( float * ALIGNED(32) ) ( local_f +  7 );
+    }
+    else
+    {
+      vp00 = ( float * ALIGNED(32) ) ( f0 + ii( 0) );
+      vp01 = ( float * ALIGNED(32) ) ( f0 + ii( 1) );
+      vp02 = ( float * ALIGNED(32) ) ( f0 + ii( 2) );
+      vp03 = ( float * ALIGNED(32) ) ( f0 + ii( 3) );
+      vp04 = ( float * ALIGNED(32) ) ( f0 + ii( 4) );
+      vp05 = ( float * ALIGNED(32) ) ( f0 + ii( 5) );
+      vp06 = ( float * ALIGNED(32) ) ( f0 + ii( 6) );
+      vp07 = ( float * ALIGNED(32) ) ( f0 + ii( 7) );
+    }
 
     //--------------------------------------------------------------------------
     // Load interpolation data for particles.
@@ -150,28 +223,95 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
     // frequencies approaching the nyquist frequency.
     //--------------------------------------------------------------------------
 
-    ux  += hax;
-    uy  += hay;
-    uz  += haz;
-
-    v00  = qdt_2mc*rsqrt( one + fma( ux, ux, fma( uy, uy, uz*uz ) ) );
-    v01  = fma( cbx, cbx, fma( cby, cby, cbz*cbz ) );
-    v02  = (v00*v00)*v01;
-    v03  = v00*fma( fma( two_fifteenths, v02, one_third ), v02, one );
-    v04  = v03*rcp( fma( v03*v03, v01, one ) );
-    v04 += v04;
-
-    v00  = fma( fms(  uy, cbz,  uz*cby ), v03, ux );
-    v01  = fma( fms(  uz, cbx,  ux*cbz ), v03, uy );
-    v02  = fma( fms(  ux, cby,  uy*cbx ), v03, uz );
-
-    ux   = fma( fms( v01, cbz, v02*cby ), v04, ux );
-    uy   = fma( fms( v02, cbx, v00*cbz ), v04, uy );
-    uz   = fma( fms( v00, cby, v01*cbx ), v04, uz );
-
-    ux  += hax;
-    uy  += hay;
-    uz  += haz;
+    if ( pusher == boris_pusher )
+    {
+      ux  += hax;
+      uy  += hay;
+      uz  += haz;
+
+      v00  = qdt_2mc*rsqrt( one + fma( ux, ux, fma( uy, uy, uz*uz ) ) );
+      v01  = fma( cbx, cbx, fma( cby, cby, cbz*cbz ) );
+      v02  = (v00*v00)*v01;
+      v03  = v00*fma( fma( two_fifteenths, v02, one_third ), v02, one );
+      v04  = v03*rcp( fma( v03*v03, v01, one ) );
+      v04 += v04;
+
+      v00  = fma( fms(  uy, cbz,  uz*cby ), v03, ux );
+      v01  = fma( fms(  uz, cbx,  ux*cbz ), v03, uy );
+      v02  = fma( fms(  ux, cby,  uy*cbx ), v03, uz );
+
+      ux   = fma( fms( v01, cbz, v02*cby ), v04, ux );
+      uy   = fma( fms( v02, cbx, v00*cbz ), v04, uy );
+      uz   = fma( fms( v00, cby, v01*cbx ), v04, uz );
+
+      ux  += hax;
+      uy  += hay;
+      uz  += haz;
+    }
+
+    else if ( pusher == higuera_cary_pusher )
+    {
+      ux  += hax;                             // Half advance E
+      uy  += hay;
+      uz  += haz;
+
+      cbx *= qdt_2mc;                         // tau
+      cby *= qdt_2mc;
+      cbz *= qdt_2mc;
+
+      v04  = fma( cbx, cbx, fma( cby, cby, cbz*cbz ) );
+      v05  = fma(  ux, cbx, fma(  uy, cby,  uz*cbz ) );
+      v00  = one + fma( ux, ux, fma( uy, uy, uz*uz ) ) - v04;
+      v04  = fma( v00, v00, four*fma( v05, v05, v04 ) );
+      v04 *= rsqrt( v04 );
+      v00  = rsqrt( one_half*( v00 + v04 ) ); // 1/gamma at time step
+
+      cbx *= v00;                             // t
+      cby *= v00;
+      cbz *= v00;
+
+      v04  = rcp( one + fma( cbx, cbx, fma( cby, cby, cbz*cbz ) ) );
+      v05  = fma( ux, cbx, fma( uy, cby, uz*cbz ) );
+
+      v00  = v04*fma( v05, cbx, ux + fms( uy, cbz, uz*cby ) );
+      v01  = v04*fma( v05, cby, uy + fms( uz, cbx, ux*cbz ) );
+      v02  = v04*fma( v05, cbz, uz + fms( ux, cby, uy*cbx ) );
+
+      ux   = fms( v01, cbz, v02*cby ) + v00 + hax;
+      uy   = fms( v02, cbx, v00*cbz ) + v01 + hay;
+      uz   = fms( v00, cby, v01*cbx ) + v02 + haz;
+    }
+
+    else // vay_pusher
+    {
+      cbx *= qdt_2mc;                         // tau
+      cby *= qdt_2mc;
+      cbz *= qdt_2mc;
+
+      v00  = rsqrt( one + fma( ux, ux, fma( uy, uy, uz*uz ) ) );
+
+      v01  = fma( fms( uy, cbz, uz*cby ), v00, ux + ( hax + hax ) );
+      v02  = fma( fms( uz, cbx, ux*cbz ), v00, uy + ( hay + hay ) );
+      v03  = fma( fms( ux, cby, uy*cbx ), v00, uz + ( haz + haz ) );
+
+      v04  = fma( cbx, cbx, fma( cby, cby, cbz*cbz ) );
+      v05  = fma( v01, cbx, fma( v02, cby, v03*cbz ) );
+      v00  = one + fma( v01, v01, fma( v02, v02, v03*v03 ) ) - v04;
+      v04  = fma( v00, v00, four*fma( v05, v05, v04 ) );
+      v04 *= rsqrt( v04 );
+      v00  = rsqrt( one_half*( v00 + v04 ) ); // 1/gamma at new step
+
+      cbx *= v00;                             // t
+      cby *= v00;
+      cbz *= v00;
+
+      v04  = rcp( one + fma( cbx, cbx, fma( cby, cby, cbz*cbz ) ) );
+      v05  = fma( v01, cbx, fma( v02, cby, v03*cbz ) );
+
+      ux   = v04*fma( v05, cbx, v01 + fms( v02, cbz, v03*cby ) );
+      uy   = v04*fma( v05, cby, v02 + fms( v03, cbx, v01*cbz ) );
+      uz   = v04*fma( v05, cbz, v03 + fms( v01, cby, v02*cbx ) );
+    }
 
     // Store ux, uy, uz in v06, v07, v08 so particle velocity store can be done
     // later with the particle positions.
@@ -214,9 +354,18 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
     //--------------------------------------------------------------------------
     // Store particle data, final.
     //--------------------------------------------------------------------------
+#   if defined(VPIC_USE_AOSOA_P)
+    store_8x1( v03, &p->dx[ ip % PARTICLE_BLOCK_SIZE ] );
+    store_8x1( v04, &p->dy[ ip % PARTICLE_BLOCK_SIZE ] );
+    store_8x1( v05, &p->dz[ ip % PARTICLE_BLOCK_SIZE ] );
+    store_8x1( v06, &p->ux[ ip % PARTICLE_BLOCK_SIZE ] );
+    store_8x1( v07, &p->uy[ ip % PARTICLE_BLOCK_SIZE ] );
+    store_8x1( v08, &p->uz[ ip % PARTICLE_BLOCK_SIZE ] );
+#   else
     store_8x8_tr( v03, v04, v05, ii, v06, v07, v08, q,
                   &p[0].dx, &p[1].dx, &p[2].dx, &p[3].dx,
                   &p[4].dx, &p[5].dx, &p[6].dx, &p[7].dx );
+#   endif
 
     // Accumulate current of inbnd particles.
     // Note: accumulator values are 4 times the total physical charge that
@@ -241,6 +390,12 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
     vp06 = ( float * ALIGNED(32) ) ( a0 + ii( 6) );
     vp07 = ( float * ALIGNED(32) ) ( a0 + ii( 7) );
 
+    for( int k = 0; k < 8; k++ )
+    {
+      if ( ii(k) < vl ) vl = ii(k);
+      if ( ii(k) > vh ) vh = ii(k);
+    }
+
     //--------------------------------------------------------------------------
     // Accumulate current density.
     //--------------------------------------------------------------------------
@@ -346,24 +501,20 @@ advance_p_pipeline_v8( advance_p_pipeline_args_t * args,
     // particles.
     //--------------------------------------------------------------------------
 
-    #include "move_outbnd_v4.inc"
+    #include "move_outbnd_batch.inc"
 
-    MOVE_OUTBND( 0);
-    MOVE_OUTBND( 1);
-    MOVE_OUTBND( 2);
-    MOVE_OUTBND( 3);
-    MOVE_OUTBND( 4);
-    MOVE_OUTBND( 5);
-    MOVE_OUTBND( 6);
-    MOVE_OUTBND( 7);
+    MOVE_OUTBND_BATCH(8);
 
-#   undef MOVE_OUTBND
+    #undef MOVE_OUTBND_BATCH
   }
 
   args->seg[pipeline_rank].pm        = pm;
   args->seg[pipeline_rank].max_nm    = max_nm;
   args->seg[pipeline_rank].nm        = nm;
   args->seg[pipeline_rank].n_ignored = itmp;
+  args->seg[pipeline_rank].nd        = nd  ;
+  args->seg[pipeline_rank].vl        = vl;
+  args->seg[pipeline_rank].vh        = vh;
 }
 
 #else
@@ -2,7 +2,7 @@
 
 #include "spa_private.h"
 
-#if defined(V8_ACCELERATION)
+#if defined(V8_ACCELERATION) && !defined(VPIC_USE_AOSOA_P)
 
 using namespace v8;
 
@@ -1,8 +1,12 @@
 #define IN_spa
 
+// The vector variants use transposing loads which assume the AoS
+// particle layout.
+#if !defined(VPIC_USE_AOSOA_P)
 #define HAS_V4_PIPELINE
 #define HAS_V8_PIPELINE
 #define HAS_V16_PIPELINE
+#endif
 
 #include "spa_private.h"
 
@@ -20,7 +24,7 @@ energy_p_pipeline_scalar( energy_p_pipeline_args_t * RESTRICT args,
                           int n_pipeline )
 {
   const interpolator_t * RESTRICT ALIGNED(128) f = args->f;
-  const particle_t     * RESTRICT ALIGNED(32)  p = args->p;
+  const particle_block_t * RESTRICT ALIGNED(128) p = args->p;
 
   const float qdt_2mc = args->qdt_2mc;
   const float msp     = args->msp;
@@ -43,23 +47,23 @@ energy_p_pipeline_scalar( energy_p_pipeline_args_t * RESTRICT args,
 
   for( n = n0; n < n1; n++ )
   {
-    dx  = p[n].dx;
-    dy  = p[n].dy;
-    dz  = p[n].dz;
-    i   = p[n].i;
+    dx  = P_ELEM( p, n, dx );
+    dy  = P_ELEM( p, n, dy );
+    dz  = P_ELEM( p, n, dz );
+    i   = P_ELEM( p, n, i );
 
-    v0  = p[n].ux + qdt_2mc*(    ( f[i].ex    + dy*f[i].dexdy    ) +
-                              dz*( f[i].dexdz + dy*f[i].d2exdydz ) );
+    v0  = P_ELEM( p, n, ux ) + qdt_2mc*(    ( f[i].ex    + dy*f[i].dexdy    ) +
+                                         dz*( f[i].dexdz + dy*f[i].d2exdydz ) );
 
-    v1  = p[n].uy + qdt_2mc*(    ( f[i].ey    + dz*f[i].deydz    ) +
-                              dx*( f[i].deydx + dz*f[i].d2eydzdx ) );
+    v1  = P_ELEM( p, n, uy ) + qdt_2mc*(    ( f[i].ey    + dz*f[i].deydz    ) +
+                                         dx*( f[i].deydx + dz*f[i].d2eydzdx ) );
 
-    v2  = p[n].uz + qdt_2mc*(    ( f[i].ez    + dx*f[i].dezdx    ) +
-                              dy*( f[i].dezdy + dx*f[i].d2ezdxdy ) );
+    v2  = P_ELEM( p, n, uz ) + qdt_2mc*(    ( f[i].ez    + dx*f[i].dezdx    ) +
+                                         dy*( f[i].dezdy + dx*f[i].d2ezdxdy ) );
 
     v0  = v0*v0 + v1*v1 + v2*v2;
 
-    v0  = (msp * p[n].w) * (v0 / (one + sqrtf(one + v0)));
+    v0  = (msp * P_ELEM( p, n, w )) * (v0 / (one + sqrtf(one + v0)));
 
     en += ( double ) v0;
   }
@@ -94,7 +98,7 @@ energy_p_pipeline( const species_t * RESTRICT sp,
   args->p       = sp->p;
   args->f       = ia->i;
   args->en      = en;
-  args->qdt_2mc = (sp->q*sp->g->dt)/(2*sp->m*sp->g->cvac);
+  args->qdt_2mc = (sp->q*SPECIES_DT(sp))/(2*sp->m*sp->g->cvac);
   args->msp     = sp->m;
   args->np      = sp->np;
 
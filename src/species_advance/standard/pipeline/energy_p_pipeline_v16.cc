@@ -2,7 +2,7 @@
 
 #include "spa_private.h"
 
-#if defined(V16_ACCELERATION)
+#if defined(V16_ACCELERATION) && !defined(VPIC_USE_AOSOA_P)
 
 using namespace v16;
 
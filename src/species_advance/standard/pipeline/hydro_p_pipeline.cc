@@ -1,8 +1,12 @@
 #define IN_spa
 
+// The vector variants use transposing loads which assume the AoS
+// particle layout.
+#if !defined(VPIC_USE_AOSOA_P)
 #define HAS_V4_PIPELINE
 #define HAS_V8_PIPELINE
 #define HAS_V16_PIPELINE
+#endif
 
 #include "spa_private.h"
 
@@ -23,7 +27,7 @@ accumulate_hydro_p_pipeline_scalar( accumulate_hydro_p_pipeline_args_t * args,
 {
   const species_t      *              sp = args->sp;
   /**/  hydro_t        * ALIGNED(128) h  = args->h + pipeline_rank * args->h_size;
-  const particle_t     * ALIGNED(128) p  = sp->p;
+  const particle_block_t * ALIGNED(128) p = sp->p;
   const interpolator_t * ALIGNED(128) f  = args->f;
 
   // Constants.
@@ -74,15 +78,15 @@ accumulate_hydro_p_pipeline_scalar( accumulate_hydro_p_pipeline_args_t * args,
     // Load particle data.
     //--------------------------------------------------------------------------
 
-    dx = p[n].dx;
-    dy = p[n].dy;
-    dz = p[n].dz;
-    i  = p[n].i;
+    dx = P_ELEM( p, n, dx );
+    dy = P_ELEM( p, n, dy );
+    dz = P_ELEM( p, n, dz );
+    i  = P_ELEM( p, n, i );
 
-    ux = p[n].ux;
-    uy = p[n].uy;
-    uz = p[n].uz;
-    w  = p[n].w;
+    ux = P_ELEM( p, n, ux );
+    uy = P_ELEM( p, n, uy );
+    uz = P_ELEM( p, n, uz );
+    w  = P_ELEM( p, n, w );
 
     //--------------------------------------------------------------------------
     // Load interpolation data for particles and half advance with E.
@@ -234,7 +238,7 @@ accumulate_hydro_p_pipeline( hydro_array_t * RESTRICT ha,
   args->f       = ia->i;
   args->h       = ha->h;
   args->h_size  = ha->stride;
-  args->qdt_2mc = ( sp->q * sp->g->dt ) / ( 2 * sp->m * sp->g->cvac );
+  args->qdt_2mc = ( sp->q * SPECIES_DT( sp ) ) / ( 2 * sp->m * sp->g->cvac );
   args->msp     = sp->m;
   args->np      = sp->np;
 
@@ -0,0 +1,275 @@
+#define IN_spa
+
+#include "spa_private.h"
+
+#if defined(V8_ACCELERATION)
+
+using namespace v8;
+
+//----------------------------------------------------------------------------//
+// Batched variant of move_p used by advance_p_pipeline_v8.  The particles
+// of the n <= 8 movers pm[0:n-1] are moved together, one particle per
+// vector lane.  Each pass computes the next streak of every particle and
+// accumulates its current the same way the pipeline accumulates the
+// current of the particles that stay in their voxel.  The face crossings
+// are then resolved per lane as in move_p.  A lane with no displacement
+// left has an empty streak and accumulates nothing.
+//
+// Returns a bit mask of the movers still in use.  If bit k is set, the
+// particle of pm[k] interacted with something move_p could not handle
+// and the particle and pm[k] were left as move_p would leave them.
+//----------------------------------------------------------------------------//
+
+int
+move_p_v8( particle_block_t * RESTRICT ALIGNED(128) p0,
+           particle_mover_t * RESTRICT ALIGNED(16)  pm,
+           int                                      n,
+           accumulator_t    * RESTRICT ALIGNED(128) a0,
+           const grid_t     *                       g,
+           const float                              qsp )
+{
+  const v8float one(1.0);
+  const v8float neg_one(-1.0);
+  const v8float one_third(1.0/3.0);
+  const v8float one_half(0.5);
+  const v8float two(2.0);
+  const v8float zero(0.0);
+  const v8float big(3.4e38);
+
+  const v8int   end_axis(3);
+
+  v8float rx, ry, rz;        // Particle positions
+  v8float mx, my, mz;        // Remaining particle displacements
+  v8float dx, dy, dz;        // Streak midpoints
+  v8float ux, uy, uz;        // Streak displacements
+  v8float sx, sy, sz, s, q;
+  v8float v00, v01, v02, v03, v04, v05, v06, v07, v08, v09;
+  v8int   axis, c;
+
+  float * ALIGNED(32) vp[8];
+
+  int32_t voxel[8];
+  int64_t neighbor;
+  int k, face, i, crossed, in_use = 0;
+
+  // Lanes past n hold a copy of the first particle with no displacement
+  // and no charge.
+
+  for( k = 0; k < 8; k++ )
+  {
+    i = pm[ k < n ? k : 0 ].i;
+
+    rx[k] = P_ELEM( p0, i, dx );
+    ry[k] = P_ELEM( p0, i, dy );
+    rz[k] = P_ELEM( p0, i, dz );
+
+    mx[k] = k < n ? pm[k].dispx : 0;
+    my[k] = k < n ? pm[k].dispy : 0;
+    mz[k] = k < n ? pm[k].dispz : 0;
+
+    q[k]     = k < n ? qsp * P_ELEM( p0, i, w ) : 0;
+    voxel[k] = P_ELEM( p0, i, i );
+  }
+
+  for( ; ; )
+  {
+    sx = merge( mx > zero, one, neg_one );
+    sy = merge( my > zero, one, neg_one );
+    sz = merge( mz > zero, one, neg_one );
+
+    // Compute twice the fractional distance to each potential
+    // streak/cell face intersection and find the axis of the face the
+    // streak ends on (3: the streak ends at the end of the track).
+
+    c    = mx == zero;
+    v00  = merge( c, big, ( sx - rx ) / merge( c, one, mx ) );
+    c    = my == zero;
+    v01  = merge( c, big, ( sy - ry ) / merge( c, one, my ) );
+    c    = mz == zero;
+    v02  = merge( c, big, ( sz - rz ) / merge( c, one, mz ) );
+
+    s    = two;
+    axis = end_axis;
+
+    c = v00 < s; s = merge( c, v00, s ); axis = merge( c, v8int(0), axis );
+    c = v01 < s; s = merge( c, v01, s ); axis = merge( c, v8int(1), axis );
+    c = v02 < s; s = merge( c, v02, s ); axis = merge( c, v8int(2), axis );
+
+    s *= one_half;
+
+    // Compute the streak midpoint and normalized displacement and update
+    // the particle position and remaining displacement.
+
+    ux = mx*s;
+    uy = my*s;
+    uz = mz*s;
+
+    dx = rx + ux;
+    dy = ry + uy;
+    dz = rz + uz;
+
+    rx = dx + ux;
+    ry = dy + uy;
+    rz = dz + uz;
+
+    mx -= ux;
+    my -= uy;
+    mz -= uz;
+
+    // Accumulate the streaks.  Note: accumulator values are 4 times the
+    // total physical charge that passed through the appropriate current
+    // quadrant in a time-step.
+
+    v09 = q*ux*uy*uz*one_third;    // Charge conservation correction
+
+    for( k = 0; k < 8; k++ )
+    {
+      vp[k] = ( float * ALIGNED(32) ) ( a0 + voxel[k] );
+    }
+
+#   define ACCUMULATE_J(X,Y,Z,V0,V1,V2,V3)                             \
+    v08  = q*u##X;    /* v08 = q ux                            */      \
+    V1   = v08*d##Y;  /* V1  = q ux dy                         */      \
+    V0   = v08-V1;    /* V0  = q ux (1-dy)                     */      \
+    V1  += v08;       /* V1  = q ux (1+dy)                     */      \
+    v08  = one+d##Z;  /* v08 = 1+dz                            */      \
+    V2   = V0*v08;    /* V2  = q ux (1-dy)(1+dz)               */      \
+    V3   = V1*v08;    /* V3  = q ux (1+dy)(1+dz)               */      \
+    v08  = one-d##Z;  /* v08 = 1-dz                            */      \
+    V0  *= v08;       /* V0  = q ux (1-dy)(1-dz)               */      \
+    V1  *= v08;       /* V1  = q ux (1+dy)(1-dz)               */      \
+    V0  += v09;       /* V0  = q ux [ (1-dy)(1-dz) + uy*uz/3 ] */      \
+    V1  -= v09;       /* V1  = q ux [ (1+dy)(1-dz) - uy*uz/3 ] */      \
+    V2  -= v09;       /* V2  = q ux [ (1-dy)(1+dz) - uy*uz/3 ] */      \
+    V3  += v09;       /* V3  = q ux [ (1+dy)(1+dz) + uy*uz/3 ] */
+
+    ACCUMULATE_J( x, y, z, v00, v01, v02, v03 );
+    ACCUMULATE_J( y, z, x, v04, v05, v06, v07 );
+
+    transpose( v00, v01, v02, v03, v04, v05, v06, v07 );
+
+    increment_8x1( vp[0], v00 );
+    increment_8x1( vp[1], v01 );
+    increment_8x1( vp[2], v02 );
+    increment_8x1( vp[3], v03 );
+    increment_8x1( vp[4], v04 );
+    increment_8x1( vp[5], v05 );
+    increment_8x1( vp[6], v06 );
+    increment_8x1( vp[7], v07 );
+
+    ACCUMULATE_J( z, x, y, v00, v01, v02, v03 );
+
+    v04 = 0.0;
+    v05 = 0.0;
+    v06 = 0.0;
+    v07 = 0.0;
+
+    transpose( v00, v01, v02, v03, v04, v05, v06, v07 );
+
+    increment_8x1( vp[0] + 8, v00 );
+    increment_8x1( vp[1] + 8, v01 );
+    increment_8x1( vp[2] + 8, v02 );
+    increment_8x1( vp[3] + 8, v03 );
+    increment_8x1( vp[4] + 8, v04 );
+    increment_8x1( vp[5] + 8, v05 );
+    increment_8x1( vp[6] + 8, v06 );
+    increment_8x1( vp[7] + 8, v07 );
+
+#   undef ACCUMULATE_J
+
+    // Resolve the streaks that ended on a voxel face.  This is done as in
+    // move_p.  Lanes past n never cross a face.
+
+    crossed = 0;
+
+    for( k = 0; k < n; k++ )
+    {
+      if ( axis(k) == 3 ) continue;
+
+      v8float & r   = axis(k) == 0 ? rx : axis(k) == 1 ? ry : rz;
+      v8float & m   = axis(k) == 0 ? mx : axis(k) == 1 ? my : mz;
+      float     dir = axis(k) == 0 ? sx(k) : axis(k) == 1 ? sy(k) : sz(k);
+
+      crossed = 1;
+      i       = pm[k].i;
+
+      // Avoid roundoff fiascos--put the particle _exactly_ on the boundary.
+
+      r[k] = dir;
+
+      face = axis(k);
+
+      if ( dir > 0.0f )
+      {
+        face += 3;
+      }
+
+      neighbor = g->neighbor[ 6 * voxel[k] + face ];
+
+      if ( UNLIKELY( neighbor == reflect_particles ) )
+      {
+        // Hit a reflecting boundary condition.  Reflect the particle
+        // momentum and remaining displacement and keep moving the
+        // particle.
+
+        ( &P_ELEM( p0, i, ux ) )[ axis(k)*PARTICLE_BLOCK_SIZE ] =
+          - ( &P_ELEM( p0, i, ux ) )[ axis(k)*PARTICLE_BLOCK_SIZE ];
+
+        m[k] = - m[k];
+
+        continue;
+      }
+
+      if ( UNLIKELY( neighbor < g->rangel ||
+                     neighbor > g->rangeh ) )
+      {
+        // Cannot handle the boundary condition here.  Save the updated
+        // particle position, face it hit and remaining displacement and
+        // retire the lane.
+
+        P_ELEM( p0, i, dx ) = rx(k);
+        P_ELEM( p0, i, dy ) = ry(k);
+        P_ELEM( p0, i, dz ) = rz(k);
+        P_ELEM( p0, i, i  ) = 8 * voxel[k] + face;
+
+        pm[k].dispx = mx(k);
+        pm[k].dispy = my(k);
+        pm[k].dispz = mz(k);
+
+        mx[k] = 0;
+        my[k] = 0;
+        mz[k] = 0;
+        q[k]  = 0;
+
+        in_use |= 1 << k;
+
+        continue;
+      }
+
+      // Crossed into a normal voxel.  Update the voxel index and convert
+      // the particle coordinate system.
+
+      voxel[k] = neighbor - g->rangel;
+
+      r[k] = - dir;
+    }
+
+    if ( !crossed ) break;
+  }
+
+  for( k = 0; k < n; k++ )
+  {
+    if ( in_use & ( 1 << k ) ) continue;
+
+    i = pm[k].i;
+
+    P_ELEM( p0, i, dx ) = rx(k);
+    P_ELEM( p0, i, dy ) = ry(k);
+    P_ELEM( p0, i, dz ) = rz(k);
+    P_ELEM( p0, i, i  ) = voxel[k];
+  }
+
+  return in_use;
+}
+
+#endif
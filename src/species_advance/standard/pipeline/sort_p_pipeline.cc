@@ -17,12 +17,11 @@
 // This is the new thread parallel version of the particle sort.
 //----------------------------------------------------------------------------//
 
-#if defined( __SSE__ )
+#if defined( __SSE__ ) && !defined( VPIC_USE_AOSOA_P )
+#define SORT_P_SSE_COPY
 #include "xmmintrin.h"
 #endif
 
-// FIXME: HOOK UP IN-PLACE / OUT-PLACE OPTIONS AGAIN.
-
 //----------------------------------------------------------------------------//
 // 
 //----------------------------------------------------------------------------//
@@ -32,7 +31,8 @@ coarse_count_pipeline_scalar( sort_p_pipeline_args_t * args,
                               int pipeline_rank,
                               int n_pipeline )
 {
-  const particle_t * RESTRICT ALIGNED(128) p_src = args->p;
+  const particle_block_t * RESTRICT ALIGNED(128) p_src = args->p;
+  const int              * RESTRICT ALIGNED(128) sfc   = args->sfc;
 
   int i, i1;
 
@@ -65,7 +65,7 @@ coarse_count_pipeline_scalar( sort_p_pipeline_args_t * args,
   // Local coarse count the input particles.
   for( ; i < i1; i++ )
   {
-    count[ V2P( p_src[i].i, n_subsort, vl, vh ) ]++;
+    count[ V2P( sfc[ P_ELEM( p_src, i, i ) ], n_subsort, vl, vh ) ]++;
   }
 
   // Copy local coarse count to output.
@@ -83,8 +83,9 @@ coarse_sort_pipeline_scalar( sort_p_pipeline_args_t * args,
                              int pipeline_rank,
                              int n_pipeline )
 {
-  const particle_t * RESTRICT ALIGNED(128) p_src = args->p;
-  /**/  particle_t * RESTRICT ALIGNED(128) p_dst = args->aux_p;
+  const particle_block_t * RESTRICT ALIGNED(128) p_src = args->p;
+  /**/  particle_block_t * RESTRICT ALIGNED(128) p_dst = args->aux_p;
+  const int              * RESTRICT ALIGNED(128) sfc   = args->sfc;
 
   int i, i1;
   int n_subsort = args->n_subsort;
@@ -120,16 +121,16 @@ coarse_sort_pipeline_scalar( sort_p_pipeline_args_t * args,
   // Copy particles into aux array in coarse sorted order.
   for( ; i < i1; i++ )
   {
-    j = next[ V2P( p_src[i].i, n_subsort, vl, vh ) ]++;
+    j = next[ V2P( sfc[ P_ELEM( p_src, i, i ) ], n_subsort, vl, vh ) ]++;
 
-#   if defined( __SSE__ )
+#   if defined( SORT_P_SSE_COPY )
 
     _mm_store_ps( &p_dst[j].dx, _mm_load_ps( &p_src[i].dx ) );
     _mm_store_ps( &p_dst[j].ux, _mm_load_ps( &p_src[i].ux ) );
 
 #   else
 
-    p_dst[j] = p_src[i];
+    COPY_PARTICLE( p_dst, j, p_src, i );
 
 #   endif
   }
@@ -144,8 +145,9 @@ subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
                          int pipeline_rank,
                          int n_pipeline )
 {
-  const particle_t * RESTRICT ALIGNED(128) p_src = args->aux_p;
-  /**/  particle_t * RESTRICT ALIGNED(128) p_dst = args->p;
+  const particle_block_t * RESTRICT ALIGNED(128) p_src = args->aux_p;
+  /**/  particle_block_t * RESTRICT ALIGNED(128) p_dst = args->p;
+  const int              * RESTRICT ALIGNED(128) sfc   = args->sfc;
 
   int i0, i1, v0, v1, i, j, v, sum, count;
 
@@ -165,7 +167,7 @@ subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
   for( subsort = pipeline_rank; subsort < n_subsort; subsort += n_pipeline )
   {
     // This subsort sorts particles in [i0,i1) in the aux array. These
-    // particles are in voxels [v0,v1).
+    // particles are in voxels with sort keys [v0,v1).
     i0 = args->coarse_partition[ subsort   ];
     i1 = args->coarse_partition[ subsort+1 ];
 
@@ -178,7 +180,7 @@ subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
     // Fine grained count.
     for( i = i0; i < i1; i++ )
     {
-      next[ p_src[i].i ]++;
+      next[ sfc[ P_ELEM( p_src, i, i ) ] ]++;
     }
 
     // Compute the partitioning.
@@ -196,23 +198,625 @@ subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
     // Local fine grained sort.
     for( i = i0; i < i1; i++ )
     {
-      v = p_src[i].i;
+      v = sfc[ P_ELEM( p_src, i, i ) ];
       j = next[v]++;
 
-#     if defined( __SSE__ )
+#     if defined( SORT_P_SSE_COPY )
 
       _mm_store_ps( &p_dst[j].dx, _mm_load_ps( &p_src[i].dx ) );
       _mm_store_ps( &p_dst[j].ux, _mm_load_ps( &p_src[i].ux ) );
 
 #     else
 
-      p_dst[j] = p_src[i];
+      COPY_PARTICLE( p_dst, j, p_src, i );
 
 #     endif
     }
   }
 }
 
+//----------------------------------------------------------------------------//
+// Incremental sort.  Between sorts, most particles stay in the voxel they
+// were in at the last sort and thus stay inside the partition of their
+// voxel.  Such particles are kept in place relative to one another and
+// only the remaining particles (particles that changed voxel, were back
+// filled by boundary_p or were injected) are repaired, i.e. merged into
+// the partition of their new voxel.  The merge is by particle index so the
+// result is identical to what the full (stable) sort gives.
+//----------------------------------------------------------------------------//
+
+// The incremental sort is used when at most this many particles are out of
+// order.  Beyond this, the full sort is faster.
+
+#define MAX_REPAIR( n ) ( (n) / 4 )
+
+// A particle in the voxel with sort key v is in order if its index is in
+// the partition of v left by the last sort.
+
+#define IN_ORDER( i, v, partition ) \
+  ( (i) >= (partition)[v] && (i) < (partition)[(v)+1] )
+
+void
+repair_count_pipeline_scalar( sort_p_pipeline_args_t * args,
+                              int pipeline_rank,
+                              int n_pipeline )
+{
+  const particle_block_t * RESTRICT ALIGNED(128) p_src     = args->p;
+  const int              * RESTRICT ALIGNED(128) sfc       = args->sfc;
+  const int              * RESTRICT ALIGNED(128) partition = args->partition;
+
+  int i, i1, v, subsort;
+
+  int n_subsort = args->n_subsort;
+  int vl        = args->vl;
+  int vh        = args->vh;
+  int cp_stride = POW2_CEIL( n_subsort, 4 );
+
+  // On pipeline stack to avoid cache hot spots.
+  int keep[256];
+  int count[256];
+
+  // No straggler cleanup needed.
+  if ( pipeline_rank == n_pipeline )
+  {
+    return;
+  }
+
+  if ( n_subsort > 256 )
+  {
+    ERROR( ( "n_subsort too large." ) );
+  }
+
+  DISTRIBUTE( args->n, 1, pipeline_rank, n_pipeline, i, i1 );
+
+  i1 += i;
+
+  CLEAR( keep,  n_subsort );
+  CLEAR( count, n_subsort );
+
+  // Count the particles each subsort keeps in place and has to repair.
+  for( ; i < i1; i++ )
+  {
+    v       = sfc[ P_ELEM( p_src, i, i ) ];
+    subsort = V2P( v, n_subsort, vl, vh );
+
+    if ( IN_ORDER( i, v, partition ) ) keep[ subsort]++;
+    else                               count[subsort]++;
+  }
+
+  COPY( args->coarse_keep      + cp_stride*pipeline_rank, keep,  n_subsort );
+  COPY( args->coarse_partition + cp_stride*pipeline_rank, count, n_subsort );
+}
+
+//----------------------------------------------------------------------------//
+// Lists the particles outside the partition of their voxel in the repair
+// list, grouped by the subsort that repairs them.
+//----------------------------------------------------------------------------//
+
+void
+repair_list_pipeline_scalar( sort_p_pipeline_args_t * args,
+                             int pipeline_rank,
+                             int n_pipeline )
+{
+  const particle_block_t * RESTRICT ALIGNED(128) p_src     = args->p;
+  const int              * RESTRICT ALIGNED(128) sfc       = args->sfc;
+  const int              * RESTRICT ALIGNED(128) partition = args->partition;
+  /**/  int              * RESTRICT ALIGNED(128) repair    = args->repair;
+
+  int i, i1, v;
+
+  int n_subsort = args->n_subsort;
+  int vl        = args->vl;
+  int vh        = args->vh;
+  int cp_stride = POW2_CEIL( n_subsort, 4 );
+
+  // On pipeline stack to avoid cache hot spots.
+  int next[256];
+
+  // No straggler cleanup needed.
+  if ( pipeline_rank == n_pipeline )
+  {
+    return;
+  }
+
+  DISTRIBUTE( args->n, 1, pipeline_rank, n_pipeline, i, i1 );
+
+  i1 += i;
+
+  COPY( next,
+        args->coarse_partition + cp_stride*pipeline_rank,
+        n_subsort );
+
+  // List the out of order particles by the subsort that repairs them.
+  for( ; i < i1; i++ )
+  {
+    v = sfc[ P_ELEM( p_src, i, i ) ];
+
+    if ( !IN_ORDER( i, v, partition ) )
+    {
+      repair[ next[ V2P( v, n_subsort, vl, vh ) ]++ ] = i;
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Merges each subsort's repairs with the particles kept in the old
+// partitions of its voxels into the aux particle array.
+//----------------------------------------------------------------------------//
+
+void
+repair_merge_pipeline_scalar( sort_p_pipeline_args_t * args,
+                              int pipeline_rank,
+                              int n_pipeline )
+{
+  const particle_block_t * RESTRICT ALIGNED(128) p_src      = args->p;
+  /**/  particle_block_t * RESTRICT ALIGNED(128) p_dst      = args->aux_p;
+  const int              * RESTRICT ALIGNED(128) sfc        = args->sfc;
+  const int              * RESTRICT ALIGNED(128) repair     = args->repair;
+  /**/  int              * RESTRICT ALIGNED(128) aux_repair = args->aux_repair;
+  /**/  int              * RESTRICT ALIGNED(128) partition  = args->partition;
+  /**/  int              * RESTRICT ALIGNED(128) next       = args->next;
+
+  int i, i1, j, k, k0, k1, kv, v, v0, v1, src, sum, count;
+
+  int subsort;
+
+  int n         = args->n;
+  int n_subsort = args->n_subsort;
+
+  // No straggler cleanup needed.
+  if ( pipeline_rank == n_pipeline )
+  {
+    return;
+  }
+
+  for( subsort = pipeline_rank; subsort < n_subsort; subsort += n_pipeline )
+  {
+    // This subsort repairs particles [k0,k1) of the repair list and writes
+    // the particles with sort keys [v0,v1) to the aux array starting at j.
+    k0 = args->coarse_partition[ subsort   ];
+    k1 = args->coarse_partition[ subsort+1 ];
+
+    v0 = P2V( subsort,   n_subsort, args->vl, args->vh );
+    v1 = P2V( subsort+1, n_subsort, args->vl, args->vh );
+
+    j  = args->coarse_keep[ subsort ];
+
+    // Sort the repair list by voxel, keeping it in particle order within a
+    // voxel.  Afterward, next[v] is the end of the repairs for voxel v.
+    CLEAR( &next[v0], v1 - v0 );
+
+    for( k = k0; k < k1; k++ )
+    {
+      next[ sfc[ P_ELEM( p_src, repair[k], i ) ] ]++;
+    }
+
+    sum = k0;
+    for( v = v0; v < v1; v++ )
+    {
+      count    = next[v];
+      next[v]  = sum;
+      sum     += count;
+    }
+
+    for( k = k0; k < k1; k++ )
+    {
+      i = repair[k];
+
+      aux_repair[ next[ sfc[ P_ELEM( p_src, i, i ) ] ]++ ] = i;
+    }
+
+    // Merge the particles kept in each voxel's old partition with the
+    // voxel's repairs in particle order.  The partition is updated as we
+    // go; the partitions at subsort boundaries are written by the caller
+    // as neighboring subsorts still need the old values.
+    k  = k0;
+    i1 = partition[v0] < n ? partition[v0] : n;
+
+    for( v = v0; v < v1; v++ )
+    {
+      i  = i1;
+      i1 = partition[v+1] < n ? partition[v+1] : n;
+      kv = next[v];
+
+      if ( v > v0 ) partition[v] = j;
+
+      for( ; ; )
+      {
+        while( i < i1 && sfc[ P_ELEM( p_src, i, i ) ] != v ) i++;
+
+        if      ( k < kv && ( i >= i1 || aux_repair[k] < i ) ) src = aux_repair[k++];
+        else if ( i < i1                                     ) src = i++;
+        else                                                   break;
+
+#       if defined( SORT_P_SSE_COPY )
+
+        _mm_store_ps( &p_dst[j].dx, _mm_load_ps( &p_src[src].dx ) );
+        _mm_store_ps( &p_dst[j].ux, _mm_load_ps( &p_src[src].ux ) );
+
+#       else
+
+        COPY_PARTICLE( p_dst, j, p_src, src );
+
+#       endif
+
+        j++;
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Incremental sort of a fused species (see species_advance.h).  The out of
+// order particles are the particles the last push marked in sp->moved
+// (that are still out of order) and the out of order particles past
+// moved_np.  This lists them by subsort like repair_count and
+// repair_list do, but without reading the other particles.  It is done by
+// the host as the list is usually short.  Returns the number of particles
+// to repair or max_repair+1 if there are more than max_repair.
+//----------------------------------------------------------------------------//
+
+static int
+repair_moved( const species_t        * RESTRICT sp,
+              sort_p_pipeline_args_t * RESTRICT args,
+              int moved_np,
+              int max_repair )
+{
+  const particle_block_t * RESTRICT ALIGNED(128) p_src     = args->p;
+  const int              * RESTRICT ALIGNED(128) sfc       = args->sfc;
+  const int              * RESTRICT ALIGNED(128) partition = args->partition;
+  const unsigned char    * RESTRICT ALIGNED(128) moved     = sp->moved;
+  /**/  int              * RESTRICT ALIGNED(128) repair    = args->repair;
+  /**/  int              * RESTRICT ALIGNED(128) list      = args->aux_repair;
+  /**/  int              * RESTRICT ALIGNED(128) count     = args->coarse_partition;
+  /**/  int              * RESTRICT ALIGNED(128) total     = args->coarse_keep;
+
+  int i, i1, b, k, v, subsort, sum, n_repair;
+
+  int n         = args->n;
+  int n_subsort = args->n_subsort;
+  int vl        = args->vl;
+  int vh        = args->vh;
+  int tail      = moved_np < n ? moved_np : n;
+  int origin    = 0;
+
+  int next[256];
+
+  // total[subsort] starts as the number of particles in the subsort's part
+  // of the last partitioning and ends as the number of particles the
+  // subsort ends up with.
+  i1 = 0;
+  for( subsort = 0; subsort < n_subsort; subsort++ )
+  {
+    i  = i1;
+    i1 = partition[ P2V( subsort+1, n_subsort, vl, vh ) ];
+    i1 = i1 < n ? i1 : n;
+
+    count[subsort] = 0;
+    total[subsort] = i1 - i;
+  }
+
+  // List the out of order particles in particle order.  A marked particle
+  // can be in order if boundary_p back filled its slot.
+  n_repair = 0;
+
+# define REPAIR( i ) do {                                                \
+    v = sfc[ P_ELEM( p_src, i, i ) ];                                   \
+    if ( !IN_ORDER( i, v, partition ) )                                 \
+    {                                                                   \
+      if ( n_repair == max_repair ) return max_repair + 1;              \
+      list[ n_repair++ ] = i;                                           \
+      count[ V2P( v, n_subsort, vl, vh ) ]++;                           \
+      while( origin < n_subsort &&                                      \
+             i >= partition[ P2V( origin+1, n_subsort, vl, vh ) ] )     \
+        origin++;                                                       \
+      if ( origin < n_subsort ) total[origin]--;                        \
+    }                                                                   \
+  } while(0)
+
+  for( b = 0; b < ( tail + 7 ) / 8; b++ )
+  {
+    if ( !moved[b] ) continue;
+
+    for( i = 8*b; i < 8*b + 8 && i < tail; i++ )
+    {
+      if ( moved[b] & ( 1 << ( i & 7 ) ) ) REPAIR( i );
+    }
+  }
+
+  for( i = tail; i < n; i++ )
+  {
+    REPAIR( i );
+  }
+
+# undef REPAIR
+
+  if ( n_repair == 0 )
+  {
+    return 0;
+  }
+
+  // Partition the repair list by subsort and the particle list by subsort
+  // (as repair_count does) and list the repairs by subsort, keeping them
+  // in particle order (as repair_list does).
+  sum = 0;
+  for( subsort = 0; subsort < n_subsort; subsort++ )
+  {
+    next[subsort]   = sum;
+    total[subsort] += count[subsort];
+    sum            += count[subsort];
+    count[subsort]  = next[subsort];
+  }
+  count[ n_subsort ] = n_repair;
+
+  sum = 0;
+  for( subsort = 0; subsort < n_subsort; subsort++ )
+  {
+    k               = total[subsort];
+    total[subsort]  = sum;
+    sum            += k;
+  }
+  total[ n_subsort ] = sum;
+
+  for( k = 0; k < n_repair; k++ )
+  {
+    i = list[k];
+
+    repair[ next[ V2P( sfc[ P_ELEM( p_src, i, i ) ], n_subsort, vl, vh ) ]++ ] = i;
+  }
+
+  return n_repair;
+}
+
+//----------------------------------------------------------------------------//
+// In-place sort.  This is used when the species sets sp->sort_in_place
+// and needs no particle storage beyond the particle array.  Particles are
+// first coarse sorted in place into one bucket per subsort in rounds as
+// described in sort_p_pipeline.  Then each subsort sorts its bucket in place
+// by following permutation cycles like the legacy in-place sort.  Unlike
+// the out-of-place sort, this sort is not stable.
+//----------------------------------------------------------------------------//
+
+// After this many rounds of the parallel coarse sort, the remainder is done
+// by a single pipeline.
+
+#define MAX_INPLACE_ROUND 8
+
+#define BUCKET( p, n ) V2P( sfc[ P_ELEM( p, n, i ) ], n_subsort, vl, vh )
+
+void
+inplace_permute_pipeline_scalar( sort_p_pipeline_args_t * args,
+                                 int pipeline_rank,
+                                 int n_pipeline )
+{
+  particle_block_t * RESTRICT ALIGNED(128) p   = args->p;
+  const int        * RESTRICT ALIGNED(128) sfc = args->sfc;
+
+  int n_subsort = args->n_subsort;
+  int vl        = args->vl;
+  int vh        = args->vh;
+  int cp_stride = POW2_CEIL( n_subsort, 4 );
+
+  int b, k, head;
+
+  particle_t v, w;
+
+  // On pipeline stack to avoid cache hot spots.  Particles of each bucket
+  // stripe before head[b] are in the right bucket.
+  int head_p[256];
+  int tail_p[256];
+
+  // No straggler cleanup needed.
+  if ( pipeline_rank == n_pipeline )
+  {
+    return;
+  }
+
+  if ( n_subsort > 256 )
+  {
+    ERROR( ( "n_subsort too large." ) );
+  }
+
+  COPY( head_p, args->coarse_head + cp_stride*pipeline_rank, n_subsort );
+  COPY( tail_p, args->coarse_tail + cp_stride*pipeline_rank, n_subsort );
+
+  for( b = 0; b < n_subsort; b++ )
+  {
+    for( head = head_p[b]; head < tail_p[b]; head++ )
+    {
+      // Carry the particle at head to its bucket stripe, swapping out the
+      // particles found there, until a particle of this bucket is found or
+      // the destination stripe is full.
+      LOAD_PARTICLE( v, p, head );
+
+      k = V2P( sfc[ v.i ], n_subsort, vl, vh );
+
+      while( k != b && head_p[k] < tail_p[k] )
+      {
+        LOAD_PARTICLE( w, p, head_p[k] );
+        STORE_PARTICLE( p, head_p[k], v );
+
+        head_p[k]++;
+
+        v = w;
+        k = V2P( sfc[ v.i ], n_subsort, vl, vh );
+      }
+
+      if ( k == b )
+      {
+        if ( head_p[b] != head ) COPY_PARTICLE( p, head, p, head_p[b] );
+
+        STORE_PARTICLE( p, head_p[b], v );
+
+        head_p[b]++;
+      }
+
+      else
+      {
+        STORE_PARTICLE( p, head, v );
+      }
+    }
+  }
+
+  COPY( args->coarse_head + cp_stride*pipeline_rank, head_p, n_subsort );
+}
+
+//----------------------------------------------------------------------------//
+// Gathers the particles a round of inplace_permute left in the wrong
+// bucket at the end of the bucket for the next round.
+//----------------------------------------------------------------------------//
+
+void
+inplace_repair_pipeline_scalar( sort_p_pipeline_args_t * args,
+                                int pipeline_rank,
+                                int n_pipeline )
+{
+  particle_block_t * RESTRICT ALIGNED(128) p   = args->p;
+  const int        * RESTRICT ALIGNED(128) sfc = args->sfc;
+
+  int n_subsort = args->n_subsort;
+  int vl        = args->vl;
+  int vh        = args->vh;
+  int cp_stride = POW2_CEIL( n_subsort, 4 );
+
+  int b, r, head, tail, end;
+
+  particle_t v;
+
+  // No straggler cleanup needed.
+  if ( pipeline_rank == n_pipeline )
+  {
+    return;
+  }
+
+  for( b = pipeline_rank; b < n_subsort; b += n_pipeline )
+  {
+    // Swap the particles left in the wrong bucket with particles of this
+    // bucket from the end of the bucket.  Afterward, the particles in
+    // [bucket_head,tail) are in this bucket and the particles in
+    // [tail,bucket end) are not.
+    tail = args->coarse_partition[ b+1 ];
+
+    for( r = 0; r < n_pipeline; r++ )
+    {
+      head = args->coarse_head[ b + cp_stride*r ];
+      end  = args->coarse_tail[ b + cp_stride*r ];
+
+      while( head < end && head < tail )
+      {
+        if ( BUCKET( p, head ) != b )
+        {
+          for( ; ; )
+          {
+            if ( --tail == head ) break;
+
+            if ( BUCKET( p, tail ) == b )
+            {
+              LOAD_PARTICLE( v, p, head );
+              COPY_PARTICLE( p, head, p, tail );
+              STORE_PARTICLE( p, tail, v );
+
+              break;
+            }
+          }
+        }
+
+        head++;
+      }
+    }
+
+    args->bucket_head[b] = tail;
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Sorts each subsort's bucket by voxel in place by following permutation
+// cycles.
+//----------------------------------------------------------------------------//
+
+void
+inplace_subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
+                                 int pipeline_rank,
+                                 int n_pipeline )
+{
+  particle_block_t * RESTRICT ALIGNED(128) p   = args->p;
+  const int        * RESTRICT ALIGNED(128) sfc = args->sfc;
+
+  int * RESTRICT ALIGNED(128) partition = args->partition;
+  int * RESTRICT ALIGNED(128) next      = args->next;
+
+  int i0, i1, v0, v1, i, v, sum, count, src, dest;
+
+  int subsort;
+
+  int n_subsort = args->n_subsort;
+
+  particle_t save_p;
+
+  // No straggler cleanup needed.
+  if ( pipeline_rank == n_pipeline )
+  {
+    return;
+  }
+
+  for( subsort = pipeline_rank; subsort < n_subsort; subsort += n_pipeline )
+  {
+    // This subsort sorts particles in [i0,i1) in place.  These particles
+    // are in voxels with sort keys [v0,v1).
+    i0 = args->coarse_partition[ subsort   ];
+    i1 = args->coarse_partition[ subsort+1 ];
+
+    v0 = P2V( subsort,   n_subsort, args->vl, args->vh );
+    v1 = P2V( subsort+1, n_subsort, args->vl, args->vh );
+
+    // Fine grained count.
+    CLEAR( &next[v0], v1 - v0 );
+
+    for( i = i0; i < i1; i++ )
+    {
+      next[ sfc[ P_ELEM( p, i, i ) ] ]++;
+    }
+
+    // Compute the partitioning.
+    sum = i0;
+    for( v = v0; v < v1; v++ )
+    {
+      count         = next[v];
+      next[v]       = sum;
+      partition[v]  = sum;
+      sum          += count;
+    }
+    // All subsorts who write this agree.
+    partition[v1] = sum;
+
+    // Run sort cycles until the subsort is sorted.
+    v = v0;
+    while( v < v1 )
+    {
+      if ( next[v] >= partition[v+1] )
+      {
+        v++;
+      }
+
+      else
+      {
+        src = next[v];
+
+        for( ; ; )
+        {
+          dest = next[ sfc[ P_ELEM( p, src, i ) ] ]++;
+
+          if ( src == dest ) break;
+
+          LOAD_PARTICLE( save_p, p, dest );
+          COPY_PARTICLE( p, dest, p, src );
+          STORE_PARTICLE( p, src, save_p );
+        }
+      }
+    }
+  }
+}
+
 //----------------------------------------------------------------------------//
 // 
 //----------------------------------------------------------------------------//
@@ -225,15 +829,29 @@ sort_p_pipeline( species_t * sp )
     ERROR( ( "Bad args" ) );
   }
 
+  // The partition left by the last sort is needed for an incremental sort.
+  int incremental = ( sp->last_sorted != INT64_MIN );
+
   sp->last_sorted = sp->g->step;
 
+  // Particles marked by the last push of a fused species (see
+  // advance_p_pipeline).  The marks are only good for this sort.
+  int moved_np = sp->sort_in_place ? -1 : sp->moved_np;
+
+  sp->moved_np = -1;
+
   static char * ALIGNED(128)     scratch = NULL;
   static size_t              max_scratch = 0;
 
+  // Spare particle storage.  This is not part of the scratch as an
+  // incremental sort swaps it with the particle array of the species.
+  static particle_block_t * ALIGNED(128) spare_p   = NULL;
+  static int                             max_spare = 0;
+
   size_t sz_scratch;
 
-  particle_t * RESTRICT ALIGNED(128) p = sp->p;
-  particle_t * RESTRICT ALIGNED(128) aux_p;
+  particle_block_t * RESTRICT ALIGNED(128) p = sp->p;
+  particle_block_t * RESTRICT ALIGNED(128) aux_p;
 
   int n_particle = sp->np;
 
@@ -247,32 +865,49 @@ sort_p_pipeline( species_t * sp )
 		  sp->g->ny,
 		  sp->g->nz );
 
-  int vh = VOXEL( sp->g->nx,
-		  sp->g->ny,
-		  sp->g->nz,
-		  sp->g->nx,
-		  sp->g->ny,
-		  sp->g->nz );
+  // Non-ghost voxels have sort keys on [vl,vh].  See grid.h.
+  int vh = SFC_KEY_MAX( sp->g );
 
   int n_voxel = sp->g->nv;
 
   int * RESTRICT ALIGNED(128) coarse_partition;
+  int * RESTRICT ALIGNED(128) coarse_keep;
+  int * RESTRICT ALIGNED(128) repair;
+  int * RESTRICT ALIGNED(128) aux_repair;
+  int * RESTRICT ALIGNED(128) coarse_head;
+  int * RESTRICT ALIGNED(128) coarse_tail;
+  int * RESTRICT ALIGNED(128) bucket_head;
 
   int n_pipeline = N_PIPELINE;
   int n_subsort  = N_PIPELINE;
 
   int cp_stride = POW2_CEIL( n_subsort, 4 );
 
-  int i, pipeline_rank, subsort, count, sum;
+  // The incremental sort is not used with the in-place sort as it needs
+  // the spare particle array.
+  int max_repair = sp->sort_in_place ? 0 : MAX_REPAIR( n_particle );
+
+  int i, pipeline_rank, subsort, count, sum, keep, n_repair;
+  int round, n_stripe, start, len, q, r;
 
   DECLARE_ALIGNED_ARRAY( sort_p_pipeline_args_t, 128, args, 1 );
 
   // Ensure enough scratch space is allocated for the sorting.
-  sz_scratch = ( sizeof( *p ) * n_particle      +
+  sz_scratch = ( sizeof( *partition ) * n_voxel +
+		 128                            +
+                 sizeof( *coarse_partition ) * ( cp_stride * n_pipeline + 1 ) +
+		 128                            +
+                 sizeof( *coarse_keep ) * ( cp_stride * n_pipeline + 1 ) +
+		 128                            +
+                 sizeof( *repair ) * max_repair +
+		 128                            +
+                 sizeof( *aux_repair ) * max_repair +
+		 128                            +
+                 sizeof( *coarse_head ) * ( cp_stride * n_pipeline ) +
 		 128                            +
-                 sizeof( *partition ) * n_voxel +
+                 sizeof( *coarse_tail ) * ( cp_stride * n_pipeline ) +
 		 128                            +
-                 sizeof( *coarse_partition ) * ( cp_stride * n_pipeline + 1 ) );
+                 sizeof( *bucket_head ) * n_subsort );
 
   if ( sz_scratch > max_scratch )
   {
@@ -283,15 +918,39 @@ sort_p_pipeline( species_t * sp )
     max_scratch = sz_scratch;
   }
 
-  aux_p            = ALIGN_PTR( particle_t, scratch,            128 );
-  next             = ALIGN_PTR( int,        aux_p + n_particle, 128 );
-  coarse_partition = ALIGN_PTR( int,        next  + n_voxel,    128 );
+  // The in-place sort does not need any particle storage beyond the
+  // particle array.
+  if ( !sp->sort_in_place && max_spare < PARTICLE_BLOCKS( sp->max_np ) )
+  {
+    FREE_ALIGNED( spare_p );
+
+    MALLOC_ALIGNED( spare_p, PARTICLE_BLOCKS( sp->max_np ), 128 );
+
+    max_spare = PARTICLE_BLOCKS( sp->max_np );
+  }
+
+  aux_p            = sp->sort_in_place ? NULL : spare_p;
+  next             = ALIGN_PTR( int,              scratch,         128 );
+  coarse_partition = ALIGN_PTR( int,              next  + n_voxel, 128 );
+  coarse_keep      = ALIGN_PTR( int,              coarse_partition + cp_stride * n_pipeline + 1, 128 );
+  repair           = ALIGN_PTR( int,              coarse_keep      + cp_stride * n_pipeline + 1, 128 );
+  aux_repair       = ALIGN_PTR( int,              repair           + max_repair, 128 );
+  coarse_head      = ALIGN_PTR( int,              aux_repair       + max_repair, 128 );
+  coarse_tail      = ALIGN_PTR( int,              coarse_head      + cp_stride * n_pipeline, 128 );
+  bucket_head      = ALIGN_PTR( int,              coarse_tail      + cp_stride * n_pipeline, 128 );
 
   // Setup pipeline arguments.
   args->p                = p;
   args->aux_p            = aux_p;
   args->coarse_partition = coarse_partition;
   args->next             = next;
+  args->sfc              = sp->g->sfc;
+  args->coarse_keep      = coarse_keep;
+  args->repair           = repair;
+  args->aux_repair       = aux_repair;
+  args->coarse_head      = coarse_head;
+  args->coarse_tail      = coarse_tail;
+  args->bucket_head      = bucket_head;
   args->partition        = partition;
   args->n                = n_particle;
   args->n_subsort        = n_subsort;
@@ -299,6 +958,203 @@ sort_p_pipeline( species_t * sp )
   args->vh               = vh;
   args->n_voxel          = n_voxel;
 
+  if ( sp->sort_in_place )
+  {
+    // Coarse sort the particles in-place into subsort buckets.  Each round,
+    // the unsorted part of each bucket is split into stripes, one per
+    // pipeline, and each pipeline permutes the particles within its own
+    // stripes (see inplace_permute_pipeline_scalar).  The particles left
+    // out of place are then gathered at the end of their bucket to be
+    // handled next round.  Each round, pipeline 0 always makes progress.
+    // If this takes more than a few rounds, the remainder is done by
+    // pipeline 0 alone, which finishes in one round.
+    if ( n_subsort != 1 )
+    {
+      EXEC_PIPELINES( coarse_count, args, 0 );
+
+      WAIT_PIPELINES();
+
+      sum = 0;
+      for( subsort = 0; subsort < n_subsort; subsort++ )
+      {
+        count = 0;
+        for( pipeline_rank = 0; pipeline_rank < n_pipeline; pipeline_rank++ )
+        {
+          count += coarse_partition[ subsort + cp_stride * pipeline_rank ];
+        }
+        bucket_head[subsort] = sum;
+        sum += count;
+      }
+
+      // Bucket boundaries.  Bucket subsort ends where the next one starts.
+      COPY( coarse_partition, bucket_head, n_subsort );
+
+      coarse_partition[ n_subsort ] = n_particle;
+
+      for( round = 0; ; round++ )
+      {
+        for( subsort = 0; subsort < n_subsort; subsort++ )
+        {
+          if ( bucket_head[subsort] < coarse_partition[subsort+1] ) break;
+        }
+
+        if ( subsort == n_subsort ) break;
+
+        n_stripe = round < MAX_INPLACE_ROUND ? n_pipeline : 1;
+
+        for( subsort = 0; subsort < n_subsort; subsort++ )
+        {
+          start = bucket_head[subsort];
+          len   = coarse_partition[subsort+1] - start;
+          q     = len / n_stripe;
+          r     = len % n_stripe;
+
+          for( pipeline_rank = 0; pipeline_rank < n_pipeline; pipeline_rank++ )
+          {
+            i   = subsort + cp_stride * pipeline_rank;
+            len = pipeline_rank >= n_stripe ? 0 :
+                  q + ( pipeline_rank < r ? 1 : 0 );
+
+            coarse_head[i] = start;
+            coarse_tail[i] = start + len;
+
+            start += len;
+          }
+        }
+
+        EXEC_PIPELINES( inplace_permute, args, 0 );
+
+        WAIT_PIPELINES();
+
+        EXEC_PIPELINES( inplace_repair, args, 0 );
+
+        WAIT_PIPELINES();
+      }
+    }
+
+    else
+    {
+      coarse_partition[0] = 0;
+      coarse_partition[1] = n_particle;
+    }
+
+    // Do fine grained in-place subsorts.  While the fine grained subsorts
+    // are executing, clear the ghost parts of the partitioning array.
+    EXEC_PIPELINES( inplace_subsort, args, 0 );
+
+    CLEAR( partition, vl );
+
+    for( i = vh + 1; i < n_voxel; i++ )
+    {
+      partition[i] = n_particle;
+    }
+
+    WAIT_PIPELINES();
+
+    return;
+  }
+
+  if ( incremental && n_particle > 0 && moved_np >= 0 )
+  {
+    // The last push marked the particles that may be out of order.
+    n_repair = repair_moved( sp, args, moved_np, max_repair );
+  }
+
+  else if ( incremental && n_particle > 0 )
+  {
+    // Count the particles to repair.
+    EXEC_PIPELINES( repair_count, args, 0 );
+
+    WAIT_PIPELINES();
+
+    // Convert the repair counts into a partitioning of the repair list by
+    // subsort (as in the coarse sort) and total the particles each subsort
+    // ends up with.
+    n_repair = 0;
+    for( subsort = 0; subsort < n_subsort; subsort++ )
+    {
+      keep = 0;
+      for( pipeline_rank = 0; pipeline_rank < n_pipeline; pipeline_rank++ )
+      {
+        i                   = subsort + cp_stride * pipeline_rank;
+        count               = coarse_partition[i];
+        coarse_partition[i] = n_repair;
+        n_repair           += count;
+        keep               += coarse_keep[i] + count;
+      }
+      coarse_keep[subsort] = keep;
+    }
+
+    if ( n_repair > 0 && n_repair <= max_repair )
+    {
+      // Convert the subsort totals into the partitioning of the particle
+      // list by subsort.
+      sum = 0;
+      for( subsort = 0; subsort < n_subsort; subsort++ )
+      {
+        count                 = coarse_keep[subsort];
+        coarse_keep[subsort]  = sum;
+        sum                  += count;
+      }
+      coarse_keep[ n_subsort ] = sum;
+
+      // List the particles to repair.
+      EXEC_PIPELINES( repair_list, args, 0 );
+
+      WAIT_PIPELINES();
+
+      coarse_partition[ n_subsort ] = n_repair;
+    }
+  }
+
+  if ( incremental && n_particle > 0 )
+  {
+    if ( n_repair == 0 )
+    {
+      // Already sorted.  Only the partitions past the end of the particle
+      // list (if particles were removed from the end) need fixing.
+      for( i = vl; i < n_voxel; i++ )
+      {
+        if ( partition[i] > n_particle ) partition[i] = n_particle;
+      }
+
+      return;
+    }
+
+    if ( n_repair <= max_repair )
+    {
+      // Merge the repairs into the spare particle array.  The merges read
+      // the old partitioning at the subsort boundaries (including vh+1) so
+      // the partitioning is finished after they are done.
+      EXEC_PIPELINES( repair_merge, args, 0 );
+
+      WAIT_PIPELINES();
+
+      // The spare particle array becomes the particle array of the species
+      // and vice versa (like the legacy out-of-place sort, this avoids
+      // copying the particles back).
+      sp->p     = spare_p;
+      spare_p   = p;
+      max_spare = PARTICLE_BLOCKS( sp->max_np );
+
+      for( subsort = 0; subsort <= n_subsort; subsort++ )
+      {
+        partition[ P2V( subsort, n_subsort, vl, vh ) ] = coarse_keep[subsort];
+      }
+
+      CLEAR( partition, vl );
+
+      for( i = vh + 1; i < n_voxel; i++ )
+      {
+        partition[i] = n_particle;
+      }
+
+      return;
+    }
+
+    // Too many particles are out of order.  Do a full sort.
+  }
+
   if ( n_subsort != 1 )
   {
     // Do the coarse count.
@@ -366,6 +1222,6 @@ sort_p_pipeline( species_t * sp )
     // Copy it to the right place and undo the above hack. FIXME: IF WILLING
     // TO MOVE SP->P AROUND AND DO MORE MALLOCS PER STEP I.E. HEAP
     // FRAGMENTATION, COULD AVOID THIS COPY.
-    COPY( p, aux_p, n_particle );
+    COPY( p, aux_p, PARTICLE_BLOCKS( n_particle ) );
   }
 }
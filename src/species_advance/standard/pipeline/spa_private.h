@@ -16,19 +16,54 @@ typedef struct particle_mover_seg
   int max_nm;                         // Maximum number of movers
   int nm;                             // Number of movers used
   int n_ignored;                      // Number of movers ignored
+  int nd;                             // Number of deferred movers.  These
+  /**/                                // are the last nd movers of the
+  /**/                                // segment and still need move_p.
+  int vl, vh;                         // Voxels of the particles pushed
+  /**/                                // (vl > vh if none)
 
-  PAD_STRUCT( SIZEOF_MEM_PTR+3*sizeof(int) )
+  PAD_STRUCT( SIZEOF_MEM_PTR+6*sizeof(int) )
 
 } particle_mover_seg_t;
 
+// When tiled accumulation is used, the work assignment of each pipeline
+// is set up by advance_p_pipeline instead of being derived from the
+// pipeline rank.  See advance_p_pipeline.cc.
+
+typedef struct advance_p_tile
+{
+  MEM_PTR( accumulator_t,    128 ) a0; // Accumulator for this pipeline.
+  /**/                                 // a0 + v is the accumulator of
+  /**/                                 // voxel v for v in [wl,wh].
+  MEM_PTR( particle_mover_t, 16  ) pm; // Movers for this pipeline
+  int max_nm;  // Number of movers for this pipeline
+  int i0;      // First particle assigned to this pipeline
+  int np;      // Number of particles assigned to this pipeline
+  int n;       // Number of particles pushed by this pipeline.  These are
+  /**/         // particles [i0,i0+n).  Particles [i0+n,i0+np) were not
+  /**/         // in the tile and are pushed by the host afterward.
+  int vl, vh;  // Voxels of the tile
+  int wl, wh;  // Voxels covered by the tile accumulator (tile plus halo)
+  int sl, sh;  // Particles in voxels outside [sl,sh] that leave their
+  /**/         // voxel might wrap around a periodic boundary out of the
+  /**/         // tile accumulator.  Their moves are deferred to the host.
+
+  PAD_STRUCT( 2*SIZEOF_MEM_PTR + 11*sizeof(int) )
+} advance_p_tile_t;
+
 typedef struct advance_p_pipeline_args
 {
-  MEM_PTR( particle_t,           128 ) p0;       // Particle array
+  MEM_PTR( particle_block_t,     128 ) p0;       // Particle array
   MEM_PTR( particle_mover_t,     128 ) pm;       // Particle mover array
   MEM_PTR( accumulator_t,        128 ) a0;       // Accumulator arrays
   MEM_PTR( const interpolator_t, 128 ) f0;       // Interpolator array
+  MEM_PTR( const interpolator_bf16_t, 128 ) fh;  // BF16 interpolator array
+  /**/                                           // (NULL if not used)
   MEM_PTR( particle_mover_seg_t, 128 ) seg;      // Dest for return values
   MEM_PTR( const grid_t,         1   ) g;        // Local domain grid params
+  MEM_PTR( advance_p_tile_t,     128 ) tile;     // Tiles (NULL if untiled)
+  MEM_PTR( unsigned char,        128 ) moved;    // Moved particle bitmap
+  /**/                                           // (NULL if not recorded)
 
   float                                qdt_2mc;  // Particle/field coupling
   float                                cdt_dx;   // x-space/time coupling
@@ -41,8 +76,9 @@ typedef struct advance_p_pipeline_args
   int                                  nx;       // x-mesh resolution
   int                                  ny;       // y-mesh resolution
   int                                  nz;       // z-mesh resolution
+  int                                  pusher;   // Particle pusher
  
-  PAD_STRUCT( 6*SIZEOF_MEM_PTR + 5*sizeof(float) + 5*sizeof(int) )
+  PAD_STRUCT( 9*SIZEOF_MEM_PTR + 5*sizeof(float) + 6*sizeof(int) )
 } advance_p_pipeline_args_t;
 
 void
@@ -65,12 +101,62 @@ advance_p_pipeline_v16( advance_p_pipeline_args_t * args,
                         int pipeline_rank,
                         int n_pipeline );
 
+// Batched move_p for the v8 and v16 pipelines.  Moves the particles of the
+// n movers pm[0:n-1] (n at most the vector width) together and returns a
+// bit mask of the movers still in use.  See move_p_v8.cc.
+
+int
+move_p_v8( particle_block_t * RESTRICT ALIGNED(128) p0,
+           particle_mover_t * RESTRICT ALIGNED(16)  pm,
+           int                                      n,
+           accumulator_t    * RESTRICT ALIGNED(128) a0,
+           const grid_t     *                       g,
+           const float                              qsp );
+
+int
+move_p_v16( particle_block_t * RESTRICT ALIGNED(128) p0,
+            particle_mover_t * RESTRICT ALIGNED(16)  pm,
+            int                                      n,
+            accumulator_t    * RESTRICT ALIGNED(128) a0,
+            const grid_t     *                       g,
+            const float                              qsp );
+
+///////////////////////////////////////////////////////////////////////////////
+// tile_p_pipeline and flush_tile_pipeline interface
+
+typedef struct tile_p_pipeline_args
+{
+  MEM_PTR( particle_block_t, 128 ) p0;   // Particle array
+  MEM_PTR( advance_p_tile_t, 128 ) tile; // Tiles
+  MEM_PTR( accumulator_t,    128 ) a0;   // Host accumulator
+  int n_tile;                            // Number of tiles
+  int nv;                                // Number of voxels
+
+  PAD_STRUCT( 3*SIZEOF_MEM_PTR + 2*sizeof(int) )
+} tile_p_pipeline_args_t;
+
+void
+tile_p_pipeline_scalar( tile_p_pipeline_args_t * args,
+                        int pipeline_rank,
+                        int n_pipeline );
+
+void
+flush_tile_pipeline_scalar( tile_p_pipeline_args_t * args,
+                            int pipeline_rank,
+                            int n_pipeline );
+
+void
+tile_p_pipeline( tile_p_pipeline_args_t * args );
+
+void
+flush_tile_pipeline( tile_p_pipeline_args_t * args );
+
 ///////////////////////////////////////////////////////////////////////////////
 // center_p_pipeline and uncenter_p_pipeline interface
 
 typedef struct center_p_pipeline_args
 {
-  MEM_PTR( particle_t,           128 ) p0;      // Particle array
+  MEM_PTR( particle_block_t,     128 ) p0;      // Particle array
   MEM_PTR( const interpolator_t, 128 ) f0;      // Interpolator array
   float                                qdt_2mc; // Particle/field coupling
   int                                  np;      // Number of particles
@@ -122,7 +208,7 @@ uncenter_p_pipeline_v16( center_p_pipeline_args_t * args,
 
 typedef struct energy_p_pipeline_args
 {
-  MEM_PTR( const particle_t,     128 ) p;       // Particle array
+  MEM_PTR( const particle_block_t, 128 ) p;     // Particle array
   MEM_PTR( const interpolator_t, 128 ) f;       // Interpolator array
   MEM_PTR( double,               128 ) en;      // Return values
   float                                qdt_2mc; // Particle/field coupling
@@ -219,18 +305,32 @@ accumulate_hydro_p_pipeline_v16( accumulate_hydro_p_pipeline_args_t * args,
 
 typedef struct sort_p_pipeline_args
 {
-  MEM_PTR( particle_t, 128 ) p;                // Particles (0:n-1)
-  MEM_PTR( particle_t, 128 ) aux_p;            // Aux particle atorage (0:n-1)
+  MEM_PTR( particle_block_t, 128 ) p;          // Particles (0:n-1)
+  MEM_PTR( particle_block_t, 128 ) aux_p;      // Aux particle atorage (0:n-1)
   MEM_PTR( int,        128 ) coarse_partition; // Coarse partition storage
   /**/ // (0:max_subsort-1,0:MAX_PIPELINE-1)
   MEM_PTR( int,        128 ) partition;        // Partitioning (0:n_voxel)
   MEM_PTR( int,        128 ) next;             // Aux partitioning (0:n_voxel)
+  MEM_PTR( const int,  128 ) sfc;              // Voxel sort keys (0:n_voxel-1)
+  MEM_PTR( int,        128 ) coarse_keep;      // Incremental sort: particles
+  /**/ // kept in place (0:max_subsort-1,0:MAX_PIPELINE-1)
+  MEM_PTR( int,        128 ) repair;           // Incremental sort: indices of
+  /**/ // out of order particles by subsort (0:n_repair-1)
+  MEM_PTR( int,        128 ) aux_repair;       // Incremental sort: indices of
+  /**/ // out of order particles by voxel (0:n_repair-1)
+  MEM_PTR( int,        128 ) coarse_head;      // In-place sort: start of the
+  /**/ // unsorted part of each bucket stripe (0:max_subsort-1,0:MAX_PIPELINE-1)
+  MEM_PTR( int,        128 ) coarse_tail;      // In-place sort: end of each
+  /**/ // bucket stripe (0:max_subsort-1,0:MAX_PIPELINE-1)
+  MEM_PTR( int,        128 ) bucket_head;      // In-place sort: start of the
+  /**/ // unsorted part of each bucket (0:n_subsort-1)
   int n;         // Number of particles
   int n_subsort; // Number of pipelines to be used for subsorts
-  int vl, vh;    // Particles may be contained in voxels [vl,vh].
+  int vl, vh;    // Particles may be contained in voxels with sort keys
+  /**/           // [vl,vh].
   int n_voxel;   // Number of voxels total (including ghosts)
 
-  PAD_STRUCT( 5*SIZEOF_MEM_PTR + 5*sizeof(int) )
+  PAD_STRUCT( 12*SIZEOF_MEM_PTR + 5*sizeof(int) )
 } sort_p_pipeline_args_t;
 
 void
@@ -248,4 +348,34 @@ subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
                          int pipeline_rank,
                          int n_pipeline );
 
+void
+repair_count_pipeline_scalar( sort_p_pipeline_args_t * args,
+                              int pipeline_rank,
+                              int n_pipeline );
+
+void
+repair_list_pipeline_scalar( sort_p_pipeline_args_t * args,
+                             int pipeline_rank,
+                             int n_pipeline );
+
+void
+repair_merge_pipeline_scalar( sort_p_pipeline_args_t * args,
+                              int pipeline_rank,
+                              int n_pipeline );
+
+void
+inplace_permute_pipeline_scalar( sort_p_pipeline_args_t * args,
+                                 int pipeline_rank,
+                                 int n_pipeline );
+
+void
+inplace_repair_pipeline_scalar( sort_p_pipeline_args_t * args,
+                                int pipeline_rank,
+                                int n_pipeline );
+
+void
+inplace_subsort_pipeline_scalar( sort_p_pipeline_args_t * args,
+                                 int pipeline_rank,
+                                 int n_pipeline );
+
 #endif // _spa_private_h_
@@ -0,0 +1,139 @@
+#define IN_spa
+
+#include "spa_private.h"
+
+#include "../../../util/pipelines/pipelines_exec.h"
+
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+
+//----------------------------------------------------------------------------//
+// Prepare the tile of a pipeline for tiled accumulation.  The particles
+// assigned to the pipeline that are in the voxels of the tile are moved
+// to the front of the pipeline's particle range and the tile accumulator
+// is cleared.  The pipeline pushes these particles.  The remaining
+// particles (particles that drifted out of the tile since the last sort
+// or that were back filled into the range) are left for the host.
+//----------------------------------------------------------------------------//
+
+void
+tile_p_pipeline_scalar( tile_p_pipeline_args_t * args,
+                        int pipeline_rank,
+                        int n_pipeline )
+{
+  if ( pipeline_rank == n_pipeline )
+  {
+    return; // The host does not have a tile.
+  }
+
+  particle_block_t * RESTRICT ALIGNED(128) p0 = args->p0;
+  advance_p_tile_t * RESTRICT              t  = args->tile + pipeline_rank;
+
+  particle_t tmp;
+
+  int vl = t->vl, vh = t->vh;
+  int i  = t->i0;
+  int j  = t->i0 + t->np - 1;
+  int v;
+
+  if ( !t->np )
+  {
+    t->n = 0;
+
+    return;
+  }
+
+  CLEAR( t->a0 + t->wl, t->wh - t->wl + 1 );
+
+  for( ; ; )
+  {
+    for( ; i <= j; i++ )                      // Find a particle not in tile
+    {
+      v = P_ELEM( p0, i, i );
+
+      if ( v < vl || v > vh ) break;
+    }
+
+    for( ; i < j; j-- )                       // Find a particle in tile
+    {
+      v = P_ELEM( p0, j, i );
+
+      if ( v >= vl && v <= vh ) break;
+    }
+
+    if ( i >= j ) break;
+
+    LOAD_PARTICLE( tmp, p0, i );              // Swap them
+    COPY_PARTICLE( p0, i, p0, j );
+    STORE_PARTICLE( p0, j, tmp );
+
+    i++;
+    j--;
+  }
+
+  // Pipelines push particles in blocks of 16.  Stragglers are left for the
+  // host.
+
+  t->n = ( i - t->i0 ) & ~15;
+}
+
+//----------------------------------------------------------------------------//
+// Add the tile accumulators into the host accumulator.  Each pipeline
+// handles a range of voxels of the host accumulator and sums the tiles
+// that overlap it in tile order.
+//----------------------------------------------------------------------------//
+
+void
+flush_tile_pipeline_scalar( tile_p_pipeline_args_t * args,
+                            int pipeline_rank,
+                            int n_pipeline )
+{
+  const advance_p_tile_t * RESTRICT tile = args->tile;
+
+  const int nfloats = sizeof(accumulator_t) / sizeof(float);
+
+  int v0, v1, vl, vh, n, r, k;
+
+  DISTRIBUTE( args->nv, 16, pipeline_rank, n_pipeline, v0, n );
+
+  v1 = v0 + n - 1;
+
+  for( r = 0; r < args->n_tile; r++ )
+  {
+    vl = tile[r].wl > v0 ? tile[r].wl : v0;
+    vh = tile[r].wh < v1 ? tile[r].wh : v1;
+
+    if ( vl > vh ) continue;
+
+    /**/  float * RESTRICT ALIGNED(16) a = (float *)( args->a0    + vl );
+    const float * RESTRICT ALIGNED(16) b = (float *)( tile[r].a0 + vl );
+
+    n = ( vh - vl + 1 ) * nfloats;
+
+    for( k = 0; k < n; k++ )
+    {
+      a[k] += b[k];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------//
+// Top level functions to run the tiled accumulation stages.
+//----------------------------------------------------------------------------//
+
+void
+tile_p_pipeline( tile_p_pipeline_args_t * args )
+{
+  EXEC_PIPELINES( tile_p, args, 0 );
+
+  WAIT_PIPELINES();
+}
+
+void
+flush_tile_pipeline( tile_p_pipeline_args_t * args )
+{
+  EXEC_PIPELINES( flush_tile, args, 0 );
+
+  WAIT_PIPELINES();
+}
+
+#endif // VPIC_USE_TILED_ACCUMULATORS
@@ -1,8 +1,12 @@
 #define IN_spa
 
+// The vector variants use transposing loads which assume the AoS
+// particle layout.
+#if !defined(VPIC_USE_AOSOA_P)
 #define HAS_V4_PIPELINE
 #define HAS_V8_PIPELINE
 #define HAS_V16_PIPELINE
+#endif
 
 #include "spa_private.h"
 
@@ -20,7 +24,7 @@ uncenter_p_pipeline_scalar( center_p_pipeline_args_t * args,
 {
   const interpolator_t * ALIGNED(128) f0 = args->f0;
 
-  particle_t           * ALIGNED(32)  p;
+  particle_block_t     * ALIGNED(128) p0 = args->p0;
 
   const interpolator_t * ALIGNED(16)  f;
 
@@ -35,22 +39,22 @@ uncenter_p_pipeline_scalar( center_p_pipeline_args_t * args,
   float v0, v1, v2, v3, v4;
   int   ii;
 
-  int first, n;
+  int first, n, ip;
 
   // Determine which particles this pipeline processes.
 
   DISTRIBUTE( args->np, 16, pipeline_rank, n_pipeline, first, n );
 
-  p = args->p0 + first;
+  ip = first;
 
   // Process particles for this pipeline.
 
-  for( ; n; n--, p++ )
+  for( ; n; n--, ip++ )
   {
-    dx   = p->dx;                            // Load position
-    dy   = p->dy;
-    dz   = p->dz;
-    ii   = p->i;
+    dx   = P_ELEM( p0, ip, dx );             // Load position
+    dy   = P_ELEM( p0, ip, dy );
+    dz   = P_ELEM( p0, ip, dz );
+    ii   = P_ELEM( p0, ip, i );
 
     f    = f0 + ii;                          // Interpolate E
 
@@ -67,9 +71,9 @@ uncenter_p_pipeline_scalar( center_p_pipeline_args_t * args,
     cby  = f->cby + dy*f->dcbydy;
     cbz  = f->cbz + dz*f->dcbzdz;
 
-    ux   = p->ux;                            // Load momentum
-    uy   = p->uy;
-    uz   = p->uz;
+    ux   = P_ELEM( p0, ip, ux );             // Load momentum
+    uy   = P_ELEM( p0, ip, uy );
+    uz   = P_ELEM( p0, ip, uz );
 
     v0   = qdt_4mc/(float)sqrt(one + (ux*ux + (uy*uy + uz*uz)));
     /**/                                     // Boris - scalars
@@ -91,9 +95,9 @@ uncenter_p_pipeline_scalar( center_p_pipeline_args_t * args,
     uy  += hay;
     uz  += haz;
 
-    p->ux = ux;                              // Store momentum
-    p->uy = uy;
-    p->uz = uz;
+    P_ELEM( p0, ip, ux ) = ux;               // Store momentum
+    P_ELEM( p0, ip, uy ) = uy;
+    P_ELEM( p0, ip, uz ) = uz;
   }
 }
 
@@ -120,7 +124,7 @@ uncenter_p_pipeline( species_t * RESTRICT sp,
 
   args->p0      = sp->p;
   args->f0      = ia->i;
-  args->qdt_2mc = ( sp->q * sp->g->dt ) / ( 2 * sp->m * sp->g->cvac );
+  args->qdt_2mc = ( sp->q * SPECIES_DT( sp ) ) / ( 2 * sp->m * sp->g->cvac );
   args->np      = sp->np;
 
   EXEC_PIPELINES( uncenter_p, args, 0 );
@@ -26,7 +26,7 @@ accumulate_rho_p( /**/  field_array_t * RESTRICT fa,
   if( !fa || !sp || fa->g!=sp->g ) ERROR(( "Bad args" ));
 
   /**/  field_t    * RESTRICT ALIGNED(128) f = fa->f;
-  const particle_t * RESTRICT ALIGNED(128) p = sp->p;
+  const particle_block_t * RESTRICT ALIGNED(128) p = sp->p;
 
   const float q_8V = sp->q*sp->g->r8V;
   const int np = sp->np;
@@ -55,11 +55,11 @@ accumulate_rho_p( /**/  field_array_t * RESTRICT fa,
  
     // Load the particle data
 
-    w0 = p[n].dx;
-    w1 = p[n].dy;
-    dz = p[n].dz;
-    v  = p[n].i;
-    w7 = p[n].w*q_8V;
+    w0 = P_ELEM( p, n, dx );
+    w1 = P_ELEM( p, n, dy );
+    dz = P_ELEM( p, n, dz );
+    v  = P_ELEM( p, n, i  );
+    w7 = P_ELEM( p, n, w  )*q_8V;
 
     // Compute the trilinear weights
     // Though the PPE should have hardware fma/fmaf support, it was
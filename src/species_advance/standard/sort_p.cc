@@ -17,19 +17,12 @@
 
 #if defined(VPIC_USE_LEGACY_SORT) 
 
-//----------------------------------------------------------------------------//
-// 
-//----------------------------------------------------------------------------//
-
-void
-sort_p( species_t * sp )
+static void
+sort_p_legacy( species_t * sp )
 {
-  if ( !sp )
-    ERROR( ( "Bad args" ) );
-
   sp->last_sorted = sp->g->step;
 
-  particle_t * ALIGNED(128) p = sp->p;
+  particle_block_t * ALIGNED(128) p = sp->p;
 
   const int np                = sp->np; 
   const int nc                = sp->g->nv;
@@ -37,6 +30,8 @@ sort_p( species_t * sp )
 
   int * RESTRICT ALIGNED(128) partition = sp->partition;
 
+  const int * RESTRICT ALIGNED(128) sfc = sp->g->sfc;
+
   static int * RESTRICT ALIGNED(128) next = NULL;
 
   static int max_nc1 = 0;
@@ -63,12 +58,13 @@ sort_p( species_t * sp )
     max_nc1 = nc1;
   }
 
-  // Count particles in each cell.
+  // Count particles in each cell.  Cells are visited in the order of their
+  // sort keys.
   CLEAR( next, nc1 );
 
   for( i = 0; i < np; i++ )
   {
-    next[ p[i].i ]++;
+    next[ sfc[ P_ELEM( p, i, i ) ] ]++;
   }
 
   // Convert the count to a partitioning and save a copy in next.
@@ -84,18 +80,20 @@ sort_p( species_t * sp )
   {
     // Throw down the particle array in order.
 
-    /**/  particle_t *          ALIGNED(128) new_p;
-    const particle_t * RESTRICT ALIGNED( 32)  in_p;
-    /**/  particle_t * RESTRICT ALIGNED( 32) out_p;
+    /**/  particle_block_t *          ALIGNED(128) new_p;
+    const particle_block_t * RESTRICT ALIGNED( 32)  in_p;
+    /**/  particle_block_t * RESTRICT ALIGNED( 32) out_p;
 
-    MALLOC_ALIGNED( new_p, sp->max_np, 128 );
+    MALLOC_ALIGNED( new_p, PARTICLE_BLOCKS( sp->max_np ), 128 );
 
     in_p  = sp->p;
     out_p = new_p;
 
     for( i = 0; i < np; i++ )
     {
-      out_p[ next[ in_p[i].i ]++ ] = in_p[i];
+      j = next[ sfc[ P_ELEM( in_p, i, i ) ] ]++;
+
+      COPY_PARTICLE( out_p, j, in_p, i );
     }
 
     FREE_ALIGNED( sp->p );
@@ -107,9 +105,9 @@ sort_p( species_t * sp )
   {
     // Run sort cycles until the list is sorted.
 
-    particle_t               save_p;
-    particle_t * ALIGNED(32) src;
-    particle_t * ALIGNED(32) dest;
+    particle_t save_p;
+    int        src;
+    int        dest;
 
     i = 0;
     while( i < nc )
@@ -121,33 +119,30 @@ sort_p( species_t * sp )
 
       else
       {
-        src = &p[ next[i] ];
+        src = next[i];
 
         for( ; ; )
         {
-          dest = &p[ next[ src->i ]++ ];
+          dest = next[ sfc[ P_ELEM( p, src, i ) ] ]++;
 
           if ( src == dest ) break;
 
-          save_p = *dest;
-          *dest  = *src;
-          *src   = save_p;
+          LOAD_PARTICLE( save_p, p, dest );
+          COPY_PARTICLE( p, dest, p, src );
+          STORE_PARTICLE( p, src, save_p );
         }
       }
     }
   }
 }
 
-//----------------------------------------------------------------------------//
-// This is the new thread parallel version of the particle sort.
-//----------------------------------------------------------------------------//
-
-#else
+#endif
 
 //----------------------------------------------------------------------------//
 // Top level function to select and call the proper sort_p function using the
 // desired particle sort abstraction.  Currently, the only abstraction
-// available is the pipeline abstraction.
+// available is the pipeline abstraction (or the legacy thread serial sort).
+// The time taken is recorded for AUTO_SORT_INTERVAL species.
 //----------------------------------------------------------------------------//
 
 void
@@ -158,8 +153,95 @@ sort_p( species_t * sp )
     ERROR( ( "Bad args." ) );
   }
 
+  double t0 = wallclock();
+
+# if defined(VPIC_USE_LEGACY_SORT)
+  sort_p_legacy( sp );
+# else
   // Conditionally execute this when more abstractions are available.
   sort_p_pipeline( sp );
+# endif
+
+  sp->sort_cost   = wallclock() - t0;
+  sp->push_cost   = 0;
+  sp->push_excess = 0;
 }
 
-#endif
+//----------------------------------------------------------------------------//
+// Estimate how out of order the particles are.  A particle is in order if
+// its index is inside the partition of its voxel.  Particles that moved to
+// a different voxel, were back filled by boundary_p or were injected since
+// the last sort are out of order.  Only a strided sample of the particles
+// is checked so this is cheap enough to call every step.
+//----------------------------------------------------------------------------//
+
+#define SORT_P_DISORDER_SAMPLES 1024
+
+double
+sort_p_disorder( const species_t * RESTRICT sp )
+{
+  if ( ! sp )
+  {
+    ERROR( ( "Bad args." ) );
+  }
+
+  const particle_block_t * RESTRICT ALIGNED(128) p = sp->p;
+
+  const int * RESTRICT ALIGNED(128) partition = sp->partition;
+  const int * RESTRICT ALIGNED(128) sfc       = sp->g->sfc;
+
+  int np = sp->np, stride, n, i, j, k;
+
+  if ( np == 0 || sp->last_sorted == INT64_MIN )
+  {
+    return 0;
+  }
+
+  stride = np / SORT_P_DISORDER_SAMPLES;
+  if ( stride < 1 ) stride = 1;
+
+  n = 0;
+  k = 0;
+  for( j = stride / 2; j < np; j += stride )
+  {
+    i = sfc[ P_ELEM( p, j, i ) ];
+
+    if ( j < partition[i] || j >= partition[i+1] ) k++;
+
+    n++;
+  }
+
+  return (double) k / (double) n;
+}
+
+//----------------------------------------------------------------------------//
+// Decide if an AUTO_SORT_INTERVAL species should be sorted.  advance_p
+// accumulates in push_excess how much slower each push was than the fastest
+// push since the last sort.  This is the time sorting would have saved so
+// sorting when it exceeds the cost of the last sort costs at most twice the
+// best schedule.  Timer noise can also grow push_excess so the particles
+// must also be measurably out of order (cold species stay unsorted).
+//----------------------------------------------------------------------------//
+
+#define SORT_P_MIN_DISORDER 0.05
+
+int
+sort_p_due( const species_t * RESTRICT sp )
+{
+  if ( ! sp )
+  {
+    ERROR( ( "Bad args." ) );
+  }
+
+  if ( sp->last_sorted == INT64_MIN )
+  {
+    return 1;
+  }
+
+  if ( sp->push_excess < sp->sort_cost )
+  {
+    return 0;
+  }
+
+  return sort_p_disorder( sp ) >= SORT_P_MIN_DISORDER;
+}
@@ -225,6 +225,14 @@ struct DMPPolicy {
     FREE( mp );
   }
   
+  // The ports are point-to-point here and need no setup.
+
+  inline void
+  mp_connect_ports( mp_t * mp,
+                    const int * rank ) {
+    if( !mp || !rank ) ERROR(( "Bad args" ));
+  }
+
   inline void * ALIGNED(128)
   mp_recv_buffer( mp_t * mp,
                   int port ) {
@@ -341,6 +349,20 @@ struct DMPPolicy {
     if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
     TRAP( MPI_Wait( &mp->sreq[port], MPI_STATUS_IGNORE ) );
   }
+
+  inline int
+  mp_probe_recv( mp_t * mp,
+                 int port,
+                 int src,
+                 int tag ) {
+    MPI_Status status;
+    int sz;
+    if( !mp || port<0 || port>=mp->n_port ||
+        src<0 || src>=world_size ) ERROR(( "Bad args" ));
+    TRAP( MPI_Probe( src, tag, world->comm, &status ) );
+    TRAP( MPI_Get_count( &status, MPI_BYTE, &sz ) );
+    return sz;
+  }
   
 # undef RESIZE_FACTOR
 # undef TRAP
@@ -16,6 +16,9 @@ private:
 #ifdef USE_MPRELAY
 #include "RelayPolicy.h"
 typedef MPWrapper_T<RelayPolicy> MPWrapper;
+#elif defined USE_MPNEIGHBOR
+#include "NeighborPolicy.h"
+typedef MPWrapper_T<NeighborPolicy> MPWrapper;
 #else
 #include "DMPPolicy.h"
 typedef MPWrapper_T<DMPPolicy> MPWrapper;
@@ -0,0 +1,559 @@
+#ifndef NeighborPolicy_h
+#define NeighborPolicy_h
+
+#include <mpi.h>
+#include <cstdlib>
+
+#include "../checkpt/checkpt.h"
+
+/* Define this comm and mp opaque handles */
+/* Only the world collective exists.  The graph communicators of the
+   mps are built on its comm. */
+
+struct collective {
+  collective_t * parent;
+  int color;
+  int key;
+  MPI_Comm comm;
+};
+
+/* The ports of an mp are exchanged with MPI-3 neighborhood collectives
+   on a distributed graph communicator.  The graph has an edge for each
+   connected port.  A message sent on port p arrives on port n_port-1-p
+   of the receiver (the grid ports are numbered such that this is the
+   opposite port).  The destinations of the graph are the connected
+   ports in increasing order and the sources the connected ports in
+   decreasing order, so the edges between two processes match up in
+   order, even when a process is connected to the same process (or to
+   itself) through several ports.
+
+   Begun sends and receives are only recorded.  The first end (or
+   probe) after them does the exchange of all the ports with a begun
+   send.  The message sizes are exchanged first in one collective
+   (unless a probe already did), so the receivers know which ports get
+   a message and can check its size against the begun receive as
+   DMPPolicy does.  The messages are then exchanged in a second
+   collective.  Since the collectives are done on the graph
+   communicator, all processes must take part in the same exchanges in
+   the same order.  This is the case for the grid exchanges of the box
+   partitions and for boundary_p, which every process calls.
+
+   Nothing is transferred before the exchange.  So, unlike DMPPolicy,
+   the transfers do not overlap the work a caller does between the
+   begin and the end of a send or receive. */
+
+enum { port_idle = 0, port_begun = 1, port_done = 2 };
+
+struct mp {
+  int n_port;
+  char * ALIGNED(128) * rbuf; char * ALIGNED(128) * sbuf;
+  int * rbuf_sz;              int * sbuf_sz;
+  int * rreq_sz;              int * sreq_sz;
+  int * rstate;               int * sstate;
+  int * psz;                  // Size of the message coming to a port
+  int sized;                  // Nonzero if psz holds the sizes of the
+                              // pending exchange
+  int * rank;                 // Rank connected to a port (-1 if none)
+  int n_edge;                 // Number of connected ports
+  int * edge;                 // Connected ports in increasing order
+  int * rcount;               int * scount;
+  MPI_Aint * rdispl;          MPI_Aint * sdispl;
+  MPI_Datatype * type;
+  MPI_Comm graph;             // MPI_COMM_NULL if not built yet
+};
+
+/* Create the world collective */
+
+static collective_t __world = { NULL, 0, 0, MPI_COMM_SELF };
+collective_t * _world = &__world;
+int _world_rank = 0;
+int _world_size = 1;
+
+/* collective checkpointer */
+/* Only the world collective exists, so this just checks that a restore
+   is done by the same process of a world of the same size. */
+
+void
+checkpt_collective( const collective_t * /*comm*/ ) {
+  CHECKPT_VAL( int, world_rank );
+  CHECKPT_VAL( int, world_size );
+}
+
+collective_t *
+restore_collective( void ) {
+  int rank, size;
+  RESTORE_VAL( int, rank );
+  RESTORE_VAL( int, size );
+  if( size!=world_size )
+    ERROR(( "The number of nodes that made this checkpt (%i) is different "
+            "from the number of nodes currently (%i)",
+            size, world_size ));
+  if( rank!=world_rank )
+    ERROR(( "This node (%i) is reading a checkpoint previously written by "
+            "a different node (%i).", rank, world_rank ));
+  return world;
+}
+
+/* mp checkpointer */
+/* The graph communicator is rebuilt by the first exchange after a
+   restore.  MPI handles are not valid across runs. */
+
+void
+checkpt_mp( mp_t * mp ) {
+  int port;
+  CHECKPT( mp, 1 );
+  CHECKPT( mp->rbuf,    mp->n_port ); CHECKPT( mp->sbuf,    mp->n_port );
+  CHECKPT( mp->rbuf_sz, mp->n_port ); CHECKPT( mp->sbuf_sz, mp->n_port );
+  CHECKPT( mp->rreq_sz, mp->n_port ); CHECKPT( mp->sreq_sz, mp->n_port );
+  CHECKPT( mp->rstate,  mp->n_port ); CHECKPT( mp->sstate,  mp->n_port );
+  CHECKPT( mp->psz,     mp->n_port ); CHECKPT( mp->rank,    mp->n_port );
+  CHECKPT( mp->edge,    mp->n_port );
+  CHECKPT( mp->rcount,  mp->n_port ); CHECKPT( mp->scount,  mp->n_port );
+  CHECKPT( mp->rdispl,  mp->n_port ); CHECKPT( mp->sdispl,  mp->n_port );
+  CHECKPT( mp->type,    mp->n_port );
+  for( port=0; port<mp->n_port; port++ ) {
+    CHECKPT_ALIGNED( mp->rbuf[port], mp->rbuf_sz[port], 128 );
+    CHECKPT_ALIGNED( mp->sbuf[port], mp->sbuf_sz[port], 128 );
+  }
+}
+
+mp_t *
+restore_mp( void ) {
+  mp_t * mp;
+  int port;
+  RESTORE( mp );
+  RESTORE( mp->rbuf    ); RESTORE( mp->sbuf    );
+  RESTORE( mp->rbuf_sz ); RESTORE( mp->sbuf_sz );
+  RESTORE( mp->rreq_sz ); RESTORE( mp->sreq_sz );
+  RESTORE( mp->rstate  ); RESTORE( mp->sstate  );
+  RESTORE( mp->psz     ); RESTORE( mp->rank    );
+  RESTORE( mp->edge    );
+  RESTORE( mp->rcount  ); RESTORE( mp->scount  );
+  RESTORE( mp->rdispl  ); RESTORE( mp->sdispl  );
+  RESTORE( mp->type    );
+  for( port=0; port<mp->n_port; port++ ) {
+    RESTORE_ALIGNED( mp->rbuf[port] );
+    RESTORE_ALIGNED( mp->sbuf[port] );
+    mp->type[port] = MPI_BYTE;
+  }
+  mp->graph = MPI_COMM_NULL;
+  return mp;
+}
+
+struct NeighborPolicy {
+
+  // The port buffers only grow.  The messages are sent from and received
+  // into them in place, so a buffer may be resized between the begin and
+  // the exchange and must keep its data.
+
+# define RESIZE_FACTOR 1.3125
+# define TRAP( x ) do {                                                  \
+     int ierr = (x);                                                     \
+     if( ierr!=MPI_SUCCESS ) ERROR(( "MPI error %i on "#x, ierr ));      \
+   } while(0)
+
+  inline void
+  boot_mp( int * pargc,
+           char *** pargv ) {
+    TRAP( MPI_Init( pargc, pargv ) );
+    TRAP( MPI_Comm_dup( MPI_COMM_WORLD, &__world.comm ) );
+    __world.parent = NULL, __world.color = 0, __world.key = 0;
+    TRAP( MPI_Comm_rank( __world.comm, &_world_rank ) );
+    TRAP( MPI_Comm_size( __world.comm, &_world_size ) );
+    REGISTER_OBJECT( &__world, checkpt_collective, restore_collective, NULL );
+  }
+
+  inline void
+  halt_mp( void ) {
+    UNREGISTER_OBJECT( &__world );
+    TRAP( MPI_Comm_free( &__world.comm ) );
+    __world.parent = NULL, __world.color = 0, __world.key = 0;
+    __world.comm = MPI_COMM_SELF;
+    _world_size = 1;
+    _world_rank = 0;
+    TRAP( MPI_Finalize() );
+  }
+
+  inline void
+  mp_abort( int reason ) {
+    MPI_Abort( world->comm, reason );
+  }
+
+  inline void
+  mp_barrier( void ) {
+    TRAP( MPI_Barrier( world->comm ) );
+  }
+
+  inline void
+  mp_allsum_d( double * local,
+               double * global,
+               int n ) {
+    if( !local || !global || n<1 || std::abs(local-global)<n ) {
+      ERROR(( "Bad args" ));
+    } // if
+    TRAP( MPI_Allreduce( local, global, n, MPI_DOUBLE, MPI_SUM, world->comm ) );
+  }
+
+  inline void
+  mp_allsum_i( int * local,
+               int * global,
+               int n ) {
+    if( !local || !global || n<1 || std::abs(local-global)<n ) {
+      ERROR(( "Bad args" ));
+    } // if
+    TRAP( MPI_Allreduce( local, global, n, MPI_INT, MPI_SUM, world->comm ) );
+  }
+
+  inline void
+  mp_allgather_i( int * sbuf,
+                  int * rbuf,
+                  int n ) {
+    if( !sbuf || !rbuf || n<1 ) ERROR(( "Bad args" ));
+    TRAP( MPI_Allgather( sbuf, n, MPI_INT, rbuf, n, MPI_INT, world->comm ) );
+  }
+
+  inline void
+  mp_allgather_i64( int64_t * sbuf,
+                    int64_t * rbuf,
+                    int n ) {
+    if( !sbuf || !rbuf || n<1 ) ERROR(( "Bad args" ));
+    TRAP( MPI_Allgather( sbuf, n, MPI_LONG_LONG, rbuf, n, MPI_LONG_LONG, world->comm ) );
+  }
+
+  inline void
+  mp_gather_uc( unsigned char * sbuf,
+                unsigned char * rbuf,
+                int n ) {
+    if( !sbuf || (!rbuf && world_rank==0) || n<1 ) ERROR(( "Bad args" ));
+    TRAP( MPI_Gather( sbuf, n, MPI_CHAR, rbuf, n, MPI_CHAR, 0, world->comm ) );
+  }
+
+  inline void
+  mp_send_i( int * buf,
+             int n,
+             int dst ) {
+    if( !buf || n<1 || dst<0 || dst>=world_size ) ERROR(( "Bad args" ));
+    TRAP( MPI_Send( buf, n, MPI_INT, dst, 0, world->comm ) );
+  }
+
+  inline void
+  mp_recv_i( int * buf,
+             int n,
+             int src ) {
+    if( !buf || n<1 || src<0 || src>=world_size ) ERROR(( "Bad args" ));
+    TRAP( MPI_Recv( buf, n, MPI_INT, src, 0, world->comm, MPI_STATUS_IGNORE ) );
+  }
+
+  inline mp_t *
+  new_mp( int n_port ) {
+    mp_t * mp;
+    int port;
+    if( n_port<1 ) ERROR(( "Bad args" ));
+    MALLOC( mp, 1 );
+    mp->n_port = n_port;
+    MALLOC( mp->rbuf,    n_port ); MALLOC( mp->sbuf,    n_port );
+    MALLOC( mp->rbuf_sz, n_port ); MALLOC( mp->sbuf_sz, n_port );
+    MALLOC( mp->rreq_sz, n_port ); MALLOC( mp->sreq_sz, n_port );
+    MALLOC( mp->rstate,  n_port ); MALLOC( mp->sstate,  n_port );
+    MALLOC( mp->psz,     n_port ); MALLOC( mp->rank,    n_port );
+    MALLOC( mp->edge,    n_port );
+    MALLOC( mp->rcount,  n_port ); MALLOC( mp->scount,  n_port );
+    MALLOC( mp->rdispl,  n_port ); MALLOC( mp->sdispl,  n_port );
+    MALLOC( mp->type,    n_port );
+    CLEAR(  mp->rbuf,    n_port ); CLEAR(  mp->sbuf,    n_port );
+    CLEAR(  mp->rbuf_sz, n_port ); CLEAR(  mp->sbuf_sz, n_port );
+    CLEAR(  mp->rreq_sz, n_port ); CLEAR(  mp->sreq_sz, n_port );
+    CLEAR(  mp->rstate,  n_port ); CLEAR(  mp->sstate,  n_port );
+    CLEAR(  mp->edge,    n_port );
+    CLEAR(  mp->rcount,  n_port ); CLEAR(  mp->scount,  n_port );
+    CLEAR(  mp->rdispl,  n_port ); CLEAR(  mp->sdispl,  n_port );
+    for( port=0; port<n_port; port++ ) {
+      mp->psz[port]  = -1;
+      mp->rank[port] = -1;
+      mp->type[port] = MPI_BYTE;
+    }
+    mp->sized  = 0;
+    mp->n_edge = 0;
+    mp->graph  = MPI_COMM_NULL;
+    REGISTER_OBJECT( mp, checkpt_mp, restore_mp, NULL );
+    return mp;
+  }
+
+  inline void
+  delete_mp( mp_t * mp ) {
+    int port;
+    if( !mp ) return;
+    UNREGISTER_OBJECT( mp );
+    if( mp->graph!=MPI_COMM_NULL ) TRAP( MPI_Comm_free( &mp->graph ) );
+    for( port=0; port<mp->n_port; port++ ) {
+      FREE_ALIGNED( mp->rbuf[port] ); FREE_ALIGNED( mp->sbuf[port] );
+    }
+    FREE( mp->type    );
+    FREE( mp->rdispl  ); FREE( mp->sdispl  );
+    FREE( mp->rcount  ); FREE( mp->scount  );
+    FREE( mp->edge    );
+    FREE( mp->psz     ); FREE( mp->rank    );
+    FREE( mp->rstate  ); FREE( mp->sstate  );
+    FREE( mp->rreq_sz ); FREE( mp->sreq_sz );
+    FREE( mp->rbuf_sz ); FREE( mp->sbuf_sz );
+    FREE( mp->rbuf    ); FREE( mp->sbuf    );
+    FREE( mp );
+  }
+
+  inline void
+  mp_connect_ports( mp_t * mp,
+                    const int * rank ) {
+    int port, changed = 0;
+
+    if( !mp || !rank ) ERROR(( "Bad args" ));
+
+    for( port=0; port<mp->n_port; port++ ) {
+      if( rank[port]<-1 || rank[port]>=world_size ) ERROR(( "Bad args" ));
+      if( mp->rank[port]!=rank[port] ) changed = 1;
+    }
+    if( !changed ) return;
+
+    // Changing the connections of a built graph would need all the
+    // processes to rebuild it together.
+    if( mp->graph!=MPI_COMM_NULL )
+      ERROR(( "The ports cannot be reconnected after the first exchange" ));
+
+    mp->n_edge = 0;
+    for( port=0; port<mp->n_port; port++ ) {
+      mp->rank[port] = rank[port];
+      if( rank[port]>=0 ) mp->edge[ mp->n_edge++ ] = port;
+    }
+  }
+
+  inline void * ALIGNED(128)
+  mp_recv_buffer( mp_t * mp,
+                  int port ) {
+    if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    return mp->rbuf[port];
+  }
+
+  inline void * ALIGNED(128)
+  mp_send_buffer( mp_t * mp,
+                  int port ) {
+    if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    return mp->sbuf[port];
+  }
+
+  inline void
+  mp_size_recv_buffer( mp_t * mp,
+                       int port,
+                       int sz ) {
+    char * ALIGNED(128) buf;
+
+    if( !mp || port<0 || port>mp->n_port || sz<1 ) ERROR(( "Bad args" ));
+
+    // If there already a large enough buffer, we are done
+    if( mp->rbuf_sz[port]>=sz ) return;
+
+    // Try to reduce the number of reallocs
+    sz = (int)( sz*(double)RESIZE_FACTOR );
+
+    // If no buffer allocated for this port, malloc it and return
+    if( !mp->rbuf[port] ) {
+      MALLOC_ALIGNED( mp->rbuf[port], sz, 128 );
+      mp->rbuf_sz[port] = sz;
+      return;
+    }
+
+    // Resize the existing buffer (preserving any data in it)
+    MALLOC_ALIGNED( buf, sz, 128 );
+    COPY( buf, mp->rbuf[port], mp->rbuf_sz[port] );
+    FREE_ALIGNED( mp->rbuf[port] );
+    mp->rbuf[port]    = buf;
+    mp->rbuf_sz[port] = sz;
+  }
+
+  inline void
+  mp_size_send_buffer( mp_t * mp,
+                       int port,
+                       int sz ) {
+    char * ALIGNED(128) buf;
+
+    // Check input arguments
+    if( !mp || port<0 || port>mp->n_port || sz<1 ) ERROR(( "Bad args" ));
+
+    // Is there already a large enough buffer
+    if( mp->sbuf_sz[port]>=sz ) return;
+
+    // Try to reduce the number of reallocs
+    sz = (int)( sz*(double)RESIZE_FACTOR );
+
+    // If no buffer allocated for this port, malloc it and return
+    if( !mp->sbuf[port] ) {
+      MALLOC_ALIGNED( mp->sbuf[port], sz, 128 );
+      mp->sbuf_sz[port] = sz;
+      return;
+    }
+
+    // Resize the existing buffer (preserving any data in it)
+    MALLOC_ALIGNED( buf, sz, 128 );
+    COPY( buf, mp->sbuf[port], mp->sbuf_sz[port] );
+    FREE_ALIGNED( mp->sbuf[port] );
+    mp->sbuf[port]    = buf;
+    mp->sbuf_sz[port] = sz;
+  }
+
+  // Build the graph communicator from the connected ports.  This is
+  // collective over the world and done by the first exchange.
+
+  inline void
+  build_graph( mp_t * mp ) {
+    int e;
+
+    for( e=0; e<mp->n_edge; e++ ) {
+      mp->scount[e] = mp->rank[ mp->edge[e] ];
+      mp->rcount[e] = mp->rank[ mp->edge[ mp->n_edge-1-e ] ];
+    }
+
+    TRAP( MPI_Dist_graph_create_adjacent( world->comm,
+                                          mp->n_edge, mp->rcount, MPI_UNWEIGHTED,
+                                          mp->n_edge, mp->scount, MPI_UNWEIGHTED,
+                                          MPI_INFO_NULL, 0, &mp->graph ) );
+  }
+
+  // Exchange the sizes of the begun sends so the receivers can probe
+  // them.  Edge e sends on port edge[e] and receives on the port
+  // edge[n_edge-1-e].  A port that gets no message gets size 0.
+
+  inline void
+  exchange_size( mp_t * mp ) {
+    int e, port;
+
+    if( mp->graph==MPI_COMM_NULL ) build_graph( mp );
+
+    for( e=0; e<mp->n_edge; e++ ) {
+      port = mp->edge[e];
+      mp->scount[e] = ( mp->sstate[port]==port_begun ) ? mp->sreq_sz[port] : 0;
+    }
+
+    TRAP( MPI_Neighbor_alltoall( mp->scount, 1, MPI_INT,
+                                 mp->rcount, 1, MPI_INT, mp->graph ) );
+
+    for( e=0; e<mp->n_edge; e++ )
+      mp->psz[ mp->edge[ mp->n_edge-1-e ] ] = mp->rcount[e];
+    mp->sized = 1;
+  }
+
+  // Exchange all the ports with a begun send.  A begun recv that gets no
+  // message in this exchange stays begun for a later one (the grid
+  // exchanges begin some receives before the matching sends).  Edge e
+  // receives on the port that edge n_edge-1-e sends on.  The buffers are given by their
+  // absolute addresses relative to MPI_BOTTOM, so they do not have to be
+  // copied into one buffer.
+
+  inline void
+  exchange( mp_t * mp ) {
+    int e, port, sz;
+
+    if( !mp->sized ) exchange_size( mp );
+
+    for( e=0; e<mp->n_edge; e++ ) {
+      mp->scount[e] = 0, mp->sdispl[e] = 0;
+      port = mp->edge[e];
+      if( mp->sstate[port]==port_begun ) {
+        mp->scount[e] = mp->sreq_sz[port];
+        TRAP( MPI_Get_address( mp->sbuf[port], &mp->sdispl[e] ) );
+        mp->sstate[port] = port_done;
+      }
+    }
+
+    for( e=0; e<mp->n_edge; e++ ) {
+      mp->rcount[e] = 0, mp->rdispl[e] = 0;
+      port = mp->edge[ mp->n_edge-1-e ];
+      sz   = mp->psz[port];
+      if( sz ) {
+        if( mp->rstate[port]!=port_begun )
+          ERROR(( "Port %i gets a message without a pending recv", port ));
+        if( mp->rreq_sz[port]!=sz ) ERROR(( "Sizes do not match" ));
+        mp->rcount[e] = sz;
+        TRAP( MPI_Get_address( mp->rbuf[port], &mp->rdispl[e] ) );
+        mp->rstate[port] = port_done;
+      }
+    }
+
+    TRAP( MPI_Neighbor_alltoallw( MPI_BOTTOM, mp->scount, mp->sdispl, mp->type,
+                                  MPI_BOTTOM, mp->rcount, mp->rdispl, mp->type,
+                                  mp->graph ) );
+
+    for( port=0; port<mp->n_port; port++ ) mp->psz[port] = -1;
+    mp->sized = 0;
+  }
+
+  inline void
+  mp_begin_recv( mp_t * mp,
+                 int port,
+                 int sz,
+                 int src,
+                 int /*tag*/ ) {
+    if( !mp || port<0 || port>=mp->n_port || sz<1 || sz>mp->rbuf_sz[port] ||
+        src<0 || src>=world_size ) ERROR(( "Bad args" ));
+    if( src!=mp->rank[port] )
+      ERROR(( "Port %i is not connected to %i", port, src ));
+    if( mp->rstate[port]!=port_idle )
+      ERROR(( "A recv is already pending on port %i", port ));
+    mp->rreq_sz[port] = sz;
+    mp->rstate[port]  = port_begun;
+  }
+
+  inline void
+  mp_begin_send( mp_t * mp,
+                 int port,
+                 int sz,
+                 int dst,
+                 int /*tag*/ ) {
+    if( !mp || port<0 || port>=mp->n_port || dst<0 || dst>=world_size ||
+        sz<1 || mp->sbuf_sz[port]<sz ) ERROR(( "Bad args" ));
+    if( dst!=mp->rank[port] )
+      ERROR(( "Port %i is not connected to %i", port, dst ));
+    if( mp->sstate[port]!=port_idle )
+      ERROR(( "A send is already pending on port %i", port ));
+    if( mp->sized )
+      ERROR(( "Send begun on port %i after the sizes were exchanged", port ));
+    mp->sreq_sz[port] = sz;
+    mp->sstate[port]  = port_begun;
+  }
+
+  inline void
+  mp_end_recv( mp_t * mp,
+               int port ) {
+    if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    if( mp->rstate[port]==port_begun ) exchange( mp );
+    if( mp->rstate[port]!=port_done ) ERROR(( "No recv pending on port %i", port ));
+    mp->rstate[port] = port_idle;
+  }
+
+  inline void
+  mp_end_send( mp_t * mp,
+               int port ) {
+    if( !mp || port<0 || port>=mp->n_port ) ERROR(( "Bad args" ));
+    if( mp->sstate[port]==port_begun ) exchange( mp );
+    if( mp->sstate[port]!=port_done ) ERROR(( "No send pending on port %i", port ));
+    mp->sstate[port] = port_idle;
+  }
+
+  inline int
+  mp_probe_recv( mp_t * mp,
+                 int port,
+                 int src,
+                 int /*tag*/ ) {
+    if( !mp || port<0 || port>=mp->n_port ||
+        src<0 || src>=world_size ) ERROR(( "Bad args" ));
+    if( src!=mp->rank[port] )
+      ERROR(( "Port %i is not connected to %i", port, src ));
+    if( !mp->sized ) exchange_size( mp );
+    if( mp->psz[port]<1 ) ERROR(( "No message sent to port %i", port ));
+    return mp->psz[port];
+  }
+
+# undef RESIZE_FACTOR
+# undef TRAP
+
+}; // struct NeighborPolicy
+
+
+#endif // NeighborPolicy_h
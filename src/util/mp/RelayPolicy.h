@@ -252,6 +252,12 @@ struct RelayPolicy {
     FREE( mp->rbuf    ); FREE( mp->sbuf    );
     FREE( mp );
   }
+
+  inline void
+  mp_connect_ports( mp_t * mp,
+                    const int * rank ) {
+    if( !mp || !rank ) ERROR(( "Bad args" ));
+  }
   
   inline void * ALIGNED(128)
   mp_recv_buffer( mp_t * mp,
@@ -383,6 +389,17 @@ struct RelayPolicy {
     p2p.wait_send( port );
   }
 
+  inline int
+  mp_probe_recv( mp_t * mp,
+                 int port,
+                 int src,
+                 int tag ) {
+    // The relay has no way of probing for a message.  boundary_p
+    // exchanges the message sizes first when built with the relay.
+    ERROR(( "mp_probe_recv is not supported with MP relay" ));
+    return 0;
+  }
+
 # undef RESIZE_FACTOR
 
 }; // struct RelayPolicy
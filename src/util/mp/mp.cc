@@ -53,6 +53,10 @@ mp_t * new_mp( int n_port ) { return MPWrapper::instance().new_mp( n_port ); }
 
 void delete_mp( mp_t * mp ) { MPWrapper::instance().delete_mp( mp ); }
 
+void mp_connect_ports( mp_t * mp, const int * rank ) {
+  MPWrapper::instance().mp_connect_ports( mp, rank );
+}
+
 void * ALIGNED(16) mp_recv_buffer( mp_t * mp, int tag ) {
   return MPWrapper::instance().mp_recv_buffer( mp, tag );
 }
@@ -85,3 +89,7 @@ void mp_end_send( mp_t * mp, int sbuf ) {
   MPWrapper::instance().mp_end_send( mp, sbuf );
 }
 
+int mp_probe_recv( mp_t * mp, int rbuf, int sender, int tag ) {
+  return MPWrapper::instance().mp_probe_recv( mp, rbuf, sender, tag );
+}
+
@@ -109,6 +109,15 @@ new_mp( int n_port );
 void
 delete_mp( mp_t * mp );
 
+// Gives the rank each port of the mp is connected to (rank[port], -1
+// if the port is not connected).  Sends and receives on a port must
+// use the rank it is connected to.  With the neighborhood collective
+// backend, the ports cannot be reconnected after the first exchange.
+
+void
+mp_connect_ports( mp_t * mp,
+                  const int * rank );
+
 void * ALIGNED(128)
 mp_recv_buffer( mp_t * mp,
                 int port );
@@ -146,6 +155,16 @@ void
 mp_end_recv( mp_t * mp,
              int rbuf );
 
+// Waits for a message from src with the given tag to arrive and
+// returns its size, without receiving it.  This lets the receiver size
+// the receive buffer for a message of unknown size.
+
+int
+mp_probe_recv( mp_t * mp,
+               int port,
+               int src,
+               int tag );
+
 void
 mp_end_send( mp_t * mp,
              int sbuf );
@@ -21,6 +21,7 @@
   _( synchronize_jf    ) \
   _( advance_b         ) \
   _( advance_e         ) \
+  _( advance_fields    ) \
   _( clear_rhof        ) \
   _( accumulate_rho_p  ) \
   _( synchronize_rho   ) \
@@ -32,6 +33,7 @@
   _( clean_div_b       ) \
   _( synchronize_tang_e_norm_b ) \
   _( load_interpolator ) \
+  _( advance_b_load_interpolator ) \
   _( compute_curl_b    ) \
   _( compute_rhob      ) \
   _( center_p          ) \
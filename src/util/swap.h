@@ -141,6 +141,7 @@ void inline swap(field_t & element) {
 	utils::swap(element.jfz);
 	utils::swap(element.rhof);
 
+#if !defined(VPIC_USE_VACUUM_FIELDS)
 	// material
 	utils::swap(element.ematx);
 	utils::swap(element.ematy);
@@ -152,6 +153,7 @@ void inline swap(field_t & element) {
 	utils::swap(element.fmaty);
 	utils::swap(element.fmatz);
 	utils::swap(element.cmat);
+#endif
 } // swap
 
 void inline swap(hydro_t & element) {
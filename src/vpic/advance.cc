@@ -20,13 +20,17 @@ int vpic_simulation::advance(void) {
 
   if( num_step>0 && step()>=num_step ) return 0;
 
-  // Sort the particles for performance if desired.
+  // Sort the particles for performance if desired.  Species with an
+  // AUTO_SORT_INTERVAL are sorted when the local push time lost to disorder
+  // exceeds the local sort cost (so ranks decide independently).
 
   LIST_FOR_EACH( sp, species_list )
     if( (sp->sort_interval>0) && ((step() % sp->sort_interval)==0) ) {
       if( rank()==0 ) MESSAGE(( "Performance sorting \"%s\"", sp->name ));
       TIC sort_p( sp ); TOC( sort_p, 1 );
-    } 
+    } else if( sp->sort_interval==AUTO_SORT_INTERVAL && sort_p_due( sp ) ) {
+      TIC sort_p( sp ); TOC( sort_p, 1 );
+    }
 
   // At this point, fields are at E_0 and B_0 and the particle positions
   // are at r_0 and u_{-1/2}.  Further the mover lists for the particles should
@@ -46,8 +50,12 @@ int vpic_simulation::advance(void) {
     TIC apply_collision_op_list( collision_op_list ); TOC( collision_model, 1 );
   TIC user_particle_collisions(); TOC( user_particle_collisions, 1 );
 
+  // Subcycled species are only pushed on their push steps (see
+  // species_advance.h).
+
   LIST_FOR_EACH( sp, species_list )
-    TIC advance_p( sp, accumulator_array, interpolator_array ); TOC( advance_p, 1 );
+    if( SPECIES_PUSH_STEP( sp ) )
+      TIC advance_p( sp, accumulator_array, interpolator_array ); TOC( advance_p, 1 );
 
   // Because the partial position push when injecting aged particles might
   // place those particles onto the guard list (boundary interaction) and
@@ -70,11 +78,16 @@ int vpic_simulation::advance(void) {
   // guard lists. Particles that absorbed are added to rhob (using a corrected
   // local accumulation).
 
+  // With the edge and corner exchange, one round moves all particles
+  // that satisfy the Courant condition.
+
+  const int n_comm_round = grid->corner_exchange ? 1 : num_comm_round;
+
   TIC
-    for( int round=0; round<num_comm_round; round++ )
+    for( int round=0; round<n_comm_round; round++ )
       boundary_p( particle_bc_list, species_list,
                   field_array, accumulator_array );
-  TOC( boundary_p, num_comm_round );
+  TOC( boundary_p, n_comm_round );
   LIST_FOR_EACH( sp, species_list ) {
     if( sp->nm && verbose )
       WARNING(( "Removing %i particles associated with unprocessed %s movers (increase num_comm_round)",
@@ -88,26 +101,51 @@ int vpic_simulation::advance(void) {
     // mesh before removing the particle.
     int nm = sp->nm;
     particle_mover_t * RESTRICT ALIGNED(16)  pm = sp->pm + sp->nm - 1;
-    particle_t * RESTRICT ALIGNED(128) p0 = sp->p;
+    particle_block_t * RESTRICT ALIGNED(128) p0 = sp->p;
+    DECLARE_PARTICLE_RECORD( p_rec );
     for (; nm; nm--, pm--) {
       int i = pm->i; // particle index we are removing
-      p0[i].i >>= 3; // shift particle voxel down
+      P_ELEM( p0, i, i ) >>= 3; // shift particle voxel down
       // accumulate the particle's charge to the mesh
-      accumulate_rhob( field_array->f, p0+i, sp->g, sp->q );
-      p0[i] = p0[sp->np-1]; // put the last particle into position i
+      accumulate_rhob( field_array->f, PARTICLE_RECORD( p_rec, p0, i ),
+                       sp->g, sp->q );
+      // put the last particle into position i
+      COPY_PARTICLE( p0, i, p0, sp->np-1 );
       sp->np--; // decrement the number of particles
     }
     sp->nm = 0;
   }
 
+  // Add this step's share of the currents held by subcycled species.
+
+  LIST_FOR_EACH( sp, species_list )
+    if( sp->subcycle>1 && sp->held )
+      TIC add_accumulator_array( accumulator_array, sp->held,
+                                 1./sp->subcycle ); TOC( reduce_accumulators, 1 );
+
   // At this point, all particle positions are at r_1 and u_{1/2}, the
   // guard lists are empty and the accumulators on each processor are current.
   // Convert the accumulators into currents.
 
-  TIC FAK->clear_jf( field_array ); TOC( clear_jf, 1 );
-  if( species_list )
-    TIC unload_accumulator_array( field_array, accumulator_array ); TOC( unload_accumulator, 1 );
-  TIC FAK->synchronize_jf( field_array ); TOC( synchronize_jf, 1 );
+  // The unload also begins the shared current exchange.
+
+  if( species_list ) {
+    TIC unload_accumulator_array_begin_synchronize_jf( field_array, accumulator_array ); TOC( unload_accumulator, 1 );
+  } else {
+    TIC FAK->clear_jf( field_array ); TOC( clear_jf, 1 );
+    TIC FAK->begin_synchronize_jf( field_array ); TOC( synchronize_jf, 0 );
+  }
+
+  // With overlap_current_exchange, half advance the magnetic field from
+  // B_0 to B_{1/2} while the shared currents are exchanged (advance_b does
+  // not use jf).  User current injection then sees B_{1/2} rather than B_0.
+
+  const int overlap_advance_b = overlap_current_exchange && !fused_field_advance;
+
+  if( overlap_advance_b )
+    TIC FAK->advance_b( field_array, 0.5 ); TOC( advance_b, 1 );
+
+  TIC FAK->end_synchronize_jf( field_array ); TOC( synchronize_jf, 1 );
 
   // At this point, the particle currents are known at jf_{1/2}.
   // Let the user add their own current contributions. It is the users
@@ -118,23 +156,52 @@ int vpic_simulation::advance(void) {
 
   TIC user_current_injection(); TOC( user_current_injection, 1 );
 
-  // Half advance the magnetic field from B_0 to B_{1/2}
+  // With fused_load_interpolator, the interpolator is loaded by the
+  // last advance_b when no divergence cleaning or shared face
+  // synchronization is scheduled for this step.
+
+  const int fuse_load_interpolator =
+    fused_load_interpolator && species_list && !fused_field_advance &&
+    !( (clean_div_e_interval>0) && ((step() % clean_div_e_interval)==0) ) &&
+    !( (clean_div_b_interval>0) && ((step() % clean_div_b_interval)==0) ) &&
+    !( (sync_shared_interval>0) && ((step() % sync_shared_interval)==0) );
+
+  if( fused_field_advance ) {
+
+    // Advance the fields from E_0, B_0 to E_1, B_1 in a single pass.
+    // User field injection then sees B_1 rather than B_{1/2}.
+
+    TIC FAK->advance_fields( field_array ); TOC( advance_fields, 1 );
 
-  TIC FAK->advance_b( field_array, 0.5 ); TOC( advance_b, 1 );
+    TIC user_field_injection(); TOC( user_field_injection, 1 );
 
-  // Advance the electric field from E_0 to E_1
+  } else {
 
-  TIC FAK->advance_e( field_array, 1.0 ); TOC( advance_e, 1 );
+    // Half advance the magnetic field from B_0 to B_{1/2}
 
-  // Let the user add their own contributions to the electric field. It is the
-  // users responsibility to insure injected electric fields are consistent
-  // across domains.
+    if( !overlap_advance_b )
+      TIC FAK->advance_b( field_array, 0.5 ); TOC( advance_b, 1 );
 
-  TIC user_field_injection(); TOC( user_field_injection, 1 );
+    // Advance the electric field from E_0 to E_1
 
-  // Half advance the magnetic field from B_{1/2} to B_1
+    TIC FAK->advance_e( field_array, 1.0 ); TOC( advance_e, 1 );
 
-  TIC FAK->advance_b( field_array, 0.5 ); TOC( advance_b, 1 );
+    // Let the user add their own contributions to the electric field. It is
+    // the users responsibility to insure injected electric fields are
+    // consistent across domains.
+
+    TIC user_field_injection(); TOC( user_field_injection, 1 );
+
+    // Half advance the magnetic field from B_{1/2} to B_1.  If nothing
+    // below changes the fields, load the interpolator in the same sweep.
+
+    if( fuse_load_interpolator ) {
+      TIC advance_b_load_interpolator_array( interpolator_array, field_array, 0.5 ); TOC( advance_b_load_interpolator, 1 );
+    } else {
+      TIC FAK->advance_b( field_array, 0.5 ); TOC( advance_b, 1 );
+    }
+
+  }
 
   // Divergence clean e
 
@@ -182,7 +249,8 @@ int vpic_simulation::advance(void) {
   // particle diagnostics in user_diagnostics if there are any particle
   // species to worry about
 
-  if( species_list ) TIC load_interpolator_array( interpolator_array, field_array ); TOC( load_interpolator, 1 );
+  if( species_list && !fuse_load_interpolator )
+    TIC load_interpolator_array( interpolator_array, field_array ); TOC( load_interpolator, 1 );
 
   step()++;
 
@@ -198,7 +198,10 @@ vpic_simulation::dump_fields( const char *fbase,
   if( status==fail ) ERROR(( "Could not open \"%s\".", fname ));
 
   // default is to use VPIC native field data
-  if ( f == NULL ) f = field_array->f;
+  if ( f == NULL ) {
+    unload_soa_field_array( field_array );
+    f = field_array->f;
+  }
 
   /* IMPORTANT: these values are written in WRITE_HEADER_V0 */
   nxout = grid->nx;
@@ -279,15 +282,22 @@ vpic_simulation::dump_particles( const char *sp_name,
   char fname[256];
   FileIO fileIO;
   int dim[1], buf_start;
-  static particle_t * ALIGNED(128) p_buf = NULL;
+  static particle_block_t * ALIGNED(128) p_buf = NULL;
 # define PBUF_SIZE 32768 // 1MB of particles
+# if defined(VPIC_USE_AOSOA_P)
+  // Particles are always written out as particle_t records.
+  static particle_t * ALIGNED(128) w_buf = NULL;
+# endif
 
   sp = find_species_name( sp_name, species_list );
   if( !sp ) ERROR(( "Invalid species name \"%s\".", sp_name ));
 
   if( !fbase ) ERROR(( "Invalid filename" ));
 
-  if( !p_buf ) MALLOC_ALIGNED( p_buf, PBUF_SIZE, 128 );
+  if( !p_buf ) MALLOC_ALIGNED( p_buf, PARTICLE_BLOCKS( PBUF_SIZE ), 128 );
+# if defined(VPIC_USE_AOSOA_P)
+  if( !w_buf ) MALLOC_ALIGNED( w_buf, PBUF_SIZE, 128 );
+# endif
 
   if( rank()==0 )
     MESSAGE(("Dumping \"%s\" particles to \"%s\"",sp->name,fbase));
@@ -318,14 +328,23 @@ vpic_simulation::dump_particles( const char *sp_name,
   // FIXME: WITH A PIPELINED CENTER_P, PBUF NOMINALLY SHOULD BE QUITE
   // LARGE.
 
-  particle_t * sp_p = sp->p;      sp->p      = p_buf;
+  // Note: PBUF_SIZE is a multiple of PARTICLE_BLOCK_SIZE so each hunk
+  // starts on a particle block boundary.
+
+  particle_block_t * sp_p = sp->p; sp->p      = p_buf;
   int sp_np         = sp->np;     sp->np     = 0;
   int sp_max_np     = sp->max_np; sp->max_np = PBUF_SIZE;
   for( buf_start=0; buf_start<sp_np; buf_start += PBUF_SIZE ) {
     sp->np = sp_np-buf_start; if( sp->np > PBUF_SIZE ) sp->np = PBUF_SIZE;
-    COPY( sp->p, &sp_p[buf_start], sp->np );
+    COPY( sp->p, &sp_p[buf_start/PARTICLE_BLOCK_SIZE],
+          PARTICLE_BLOCKS( sp->np ) );
     center_p( sp, interpolator_array );
+#   if defined(VPIC_USE_AOSOA_P)
+    for( int n=0; n<sp->np; n++ ) LOAD_PARTICLE( w_buf[n], sp->p, n );
+    fileIO.write( w_buf, sp->np );
+#   else
     fileIO.write( sp->p, sp->np );
+#   endif
   }
   sp->p      = sp_p;
   sp->np     = sp_np;
@@ -565,7 +584,10 @@ vpic_simulation::field_dump( DumpParameters & dumpParams,
   if( status==fail ) ERROR(( "Failed opening file: %s", filename ));
 
   // default is to write field_array->f
-  if ( f==NULL ) f = field_array->f;
+  if ( f==NULL ) {
+    unload_soa_field_array( field_array );
+    f = field_array->f;
+  }
 
   // convenience
   const size_t istride(dumpParams.stride_x);
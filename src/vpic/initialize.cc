@@ -11,6 +11,14 @@ vpic_simulation::initialize( int argc,
 
   TIC user_initialization( argc, argv ); TOC( user_initialization, 1 );
 
+  // Join the edge and corner neighbors before the first exchange (the
+  // ports of some mp policies cannot be reconnected after it)
+
+  if( corner_exchange ) {
+    if( px && py && pz ) partition_join_corners( grid, px, py, pz );
+    set_corner_exchange( grid );
+  }
+
   // Do some consistency checks on user initialized fields
 
   if( rank()==0 ) MESSAGE(( "Checking interdomain synchronization" ));
@@ -47,6 +55,9 @@ vpic_simulation::initialize( int argc,
   TIC err = FAK->synchronize_tang_e_norm_b( field_array ); TOC( synchronize_tang_e_norm_b, 1 );
   if( rank()==0 ) MESSAGE(( "Error = %e (arb units)", err ));
 
+  if( bf16_interpolators )
+    set_interpolator_array_bf16( interpolator_array, 1 );
+
   if( species_list ) {
     if( rank()==0 ) MESSAGE(( "Uncentering particles" ));
     TIC load_interpolator_array( interpolator_array, field_array ); TOC( load_interpolator, 1 );
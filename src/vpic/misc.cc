@@ -71,17 +71,21 @@ vpic_simulation::inject_particle( species_t * sp,
   if( iz==nz ) iz = nz-1;             // On far wall ... conditional move
   iz++;                               // Adjust for mesh indexing
 
-  particle_t * p = sp->p + (sp->np++);
-  p->dx = (float)x; // Note: Might be rounded to be on [-1,1]
-  p->dy = (float)y; // Note: Might be rounded to be on [-1,1]
-  p->dz = (float)z; // Note: Might be rounded to be on [-1,1]
-  p->i  = VOXEL(ix,iy,iz, nx,ny,nz);
-  p->ux = (float)ux;
-  p->uy = (float)uy;
-  p->uz = (float)uz;
-  p->w  = w;
-
-  if( update_rhob ) accumulate_rhob( field_array->f, p, grid, -sp->q );
+  DECLARE_PARTICLE_RECORD( p_rec );
+  particle_block_t * p = sp->p;
+  int n = sp->np++;
+  P_ELEM( p, n, dx ) = (float)x; // Note: Might be rounded to be on [-1,1]
+  P_ELEM( p, n, dy ) = (float)y; // Note: Might be rounded to be on [-1,1]
+  P_ELEM( p, n, dz ) = (float)z; // Note: Might be rounded to be on [-1,1]
+  P_ELEM( p, n, i  ) = VOXEL(ix,iy,iz, nx,ny,nz);
+  P_ELEM( p, n, ux ) = (float)ux;
+  P_ELEM( p, n, uy ) = (float)uy;
+  P_ELEM( p, n, uz ) = (float)uz;
+  P_ELEM( p, n, w  ) = w;
+
+  if( update_rhob ) accumulate_rhob( field_array->f,
+                                     PARTICLE_RECORD( p_rec, p, n ),
+                                     grid, -sp->q );
 
   if( age!=0 ) {
     if( sp->nm>=sp->max_nm )
@@ -230,7 +234,7 @@ void vpic_simulation::checksum_species(const char * species, CheckSum & cs) {
     ERROR(("Invalid species name \"%s\".", species));
   } // if
 
-  checkSumBuffer<particle_t>(sp->p, sp->np, cs, "sha1");
+  checkSumBuffer<particle_block_t>(sp->p, PARTICLE_BLOCKS(sp->np), cs, "sha1");
 
   if(nproc() > 1) {
     const unsigned int csels = cs.length*nproc();
@@ -258,7 +262,7 @@ void vpic_simulation::output_checksum_species(const char * species) {
   } // if
 
   CheckSum cs;
-  checkSumBuffer<particle_t>(sp->p, sp->np, cs, "sha1");
+  checkSumBuffer<particle_block_t>(sp->p, PARTICLE_BLOCKS(sp->np), cs, "sha1");
 
   if(nproc() > 1) {
     const unsigned int csels = cs.length*nproc();
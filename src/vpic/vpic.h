@@ -45,6 +45,17 @@ const uint32_t tca                      (1<<8 | 1<<9 | 1<<10);
 const uint32_t rhob                     (1<<11);
 const uint32_t current          (1<<12 | 1<<13 | 1<<14);
 const uint32_t rhof                     (1<<15);
+
+#if defined(VPIC_USE_VACUUM_FIELDS)
+// There are no material ids to output in vacuum field builds.
+const uint32_t emat                     (0);
+const uint32_t nmat                     (0);
+const uint32_t fmat                     (0);
+const uint32_t cmat                     (0);
+
+const size_t total_field_variables(16);
+const size_t total_field_groups(8); // this counts vectors, tensors etc...
+#else
 const uint32_t emat                     (1<<16 | 1<<17 | 1<<18);
 const uint32_t nmat                     (1<<19);
 const uint32_t fmat                     (1<<20 | 1<<21 | 1<<22);
@@ -52,6 +63,7 @@ const uint32_t cmat                     (1<<23);
 
 const size_t total_field_variables(24);
 const size_t total_field_groups(12); // this counts vectors, tensors etc...
+#endif
 // These bits will be tested to determine which variables to output
 const size_t field_indeces[12] = { 0, 3, 4, 7, 8, 11, 12, 15, 16, 19, 20, 23 };
 
@@ -139,6 +151,14 @@ protected:
   int clean_div_b_interval; // How often to clean div b
   int num_div_b_round;      // How many clean div b rounds per div b interval
   int sync_shared_interval; // How often to synchronize shared faces
+  int fused_field_advance;  // Use the field array's fused field step
+  int overlap_current_exchange; // Half advance B during the shared
+                                // current exchange
+  int fused_load_interpolator; // Load the interpolators in the last
+                               // advance_b sweep
+  int bf16_interpolators;   // Push the particles with BF16 interpolators
+  int corner_exchange;      // Send particles straight to the edge and
+                            // corner neighbours (one boundary_p round)
 
   // FIXME: THESE INTERVALS SHOULDN'T BE PART OF vpic_simulation
   // THE BIG LIST FOLLOWING IT SHOULD BE CLEANED UP TOO
@@ -408,6 +428,12 @@ protected:
     set_pbc( grid, boundary, pbc );
   }
 
+  // Sets the order in which particles are sorted through the local domain
+  // (voxel_order, morton_order or hilbert_order)
+  inline void set_domain_voxel_order( int order ) {
+    set_voxel_order( grid, order );
+  }
+
   ///////////////////
   // Material helpers
 
@@ -552,9 +578,12 @@ protected:
                        float dx, float dy, float dz, int32_t i,
                        float ux, float uy, float uz, float w )
   {
-    particle_t * RESTRICT p = sp->p + (sp->np++);
-    p->dx = dx; p->dy = dy; p->dz = dz; p->i = i;
-    p->ux = ux; p->uy = uy; p->uz = uz; p->w = w;
+    particle_block_t * RESTRICT p = sp->p;
+    int n = sp->np++;
+    P_ELEM( p, n, dx ) = dx; P_ELEM( p, n, dy ) = dy;
+    P_ELEM( p, n, dz ) = dz; P_ELEM( p, n, i  ) = i;
+    P_ELEM( p, n, ux ) = ux; P_ELEM( p, n, uy ) = uy;
+    P_ELEM( p, n, uz ) = uz; P_ELEM( p, n, w  ) = w;
   }
 
   // This variant does a raw inject and moves the particles
@@ -566,12 +595,18 @@ protected:
                        float dispx, float dispy, float dispz,
                        int update_rhob )
   {
-    particle_t       * RESTRICT p  = sp->p  + (sp->np++);
+    particle_block_t * RESTRICT p  = sp->p;
     particle_mover_t * RESTRICT pm = sp->pm + sp->nm;
-    p->dx = dx; p->dy = dy; p->dz = dz; p->i = i;
-    p->ux = ux; p->uy = uy; p->uz = uz; p->w = w;
-    pm->dispx = dispx; pm->dispy = dispy; pm->dispz = dispz; pm->i = sp->np-1;
-    if( update_rhob ) accumulate_rhob( field_array->f, p, grid, -sp->q );
+    int n = sp->np++;
+    DECLARE_PARTICLE_RECORD( p_rec );
+    P_ELEM( p, n, dx ) = dx; P_ELEM( p, n, dy ) = dy;
+    P_ELEM( p, n, dz ) = dz; P_ELEM( p, n, i  ) = i;
+    P_ELEM( p, n, ux ) = ux; P_ELEM( p, n, uy ) = uy;
+    P_ELEM( p, n, uz ) = uz; P_ELEM( p, n, w  ) = w;
+    pm->dispx = dispx; pm->dispy = dispy; pm->dispz = dispz; pm->i = n;
+    if( update_rhob ) accumulate_rhob( field_array->f,
+                                       PARTICLE_RECORD( p_rec, p, n ),
+                                       grid, -sp->q );
     sp->nm += move_p( sp->p, pm, accumulator_array->a, grid, sp->q );
   }
 
@@ -9,12 +9,11 @@ void
 advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
         int pipeline_rank,
         int n_pipeline ) {
-    particle_t           * ALIGNED(128) p0 = args->p0;
+    particle_block_t     * ALIGNED(128) p0 = args->p0;
     accumulator_t        * ALIGNED(128) a0 = args->a0;
     const interpolator_t * ALIGNED(128) f0 = args->f0;
     const grid_t *                      g  = args->g;
 
-    particle_t           * ALIGNED(32)  p;
     particle_mover_t     * ALIGNED(16)  pm;
     const interpolator_t * ALIGNED(16)  f;
     float                * ALIGNED(16)  a;
@@ -32,14 +31,13 @@ advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
     float hax, hay, haz, cbx, cby, cbz;
     float v0, v1, v2, v3, v4, v5;
 
-    int itmp, ii, n, nm, max_nm;
+    int i0, itmp, ii, n, nm, max_nm;
 
     DECLARE_ALIGNED_ARRAY( particle_mover_t, 16, local_pm, 1 );
 
     // Determine which quads of particles quads this pipeline processes
 
-    DISTRIBUTE( args->np, 16, pipeline_rank, n_pipeline, itmp, n );
-    p = args->p0 + itmp;
+    DISTRIBUTE( args->np, 16, pipeline_rank, n_pipeline, i0, n );
 
     // Determine which movers are reserved for this pipeline
     // Movers (16 bytes) should be reserved for pipelines in at least
@@ -58,20 +56,21 @@ advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
 
     // Determine which accumulator array to use
     // The host gets the first accumulator array
+    // (With tiled accumulators there is only the host accumulator array)
 
+#if !defined(VPIC_USE_TILED_ACCUMULATORS)
     if( pipeline_rank!=n_pipeline )
         a0 += (1+pipeline_rank)*
             POW2_CEIL((args->nx+2)*(args->ny+2)*(args->nz+2),2);
+#endif
 
     // Process particles for this pipeline
 
-    particle_t           * ALIGNED(32)  p_ = p;
-    //for(;n;n--,p++) {
-    for(int i = 0; i < n; i++, p_++) {
-        dx   = p[i].dx;                             // Load position
-        dy   = p[i].dy;
-        dz   = p[i].dz;
-        ii   = p[i].i;
+    for(int i = i0; i < i0 + n; i++) {
+        dx   = P_ELEM( p0, i, dx );               // Load position
+        dy   = P_ELEM( p0, i, dy );
+        dz   = P_ELEM( p0, i, dz );
+        ii   = P_ELEM( p0, i, i );
         f    = f0 + ii;                           // Interpolate E
         hax  = qdt_2mc*(    ( f->ex    + dy*f->dexdy    ) +
                 dz*( f->dexdz + dy*f->d2exdydz ) );
@@ -82,10 +81,10 @@ advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
         cbx  = f->cbx + dx*f->dcbxdx;             // Interpolate B
         cby  = f->cby + dy*f->dcbydy;
         cbz  = f->cbz + dz*f->dcbzdz;
-        ux   = p[i].ux;                             // Load momentum
-        uy   = p[i].uy;
-        uz   = p[i].uz;
-        q    = p[i].w;
+        ux   = P_ELEM( p0, i, ux );               // Load momentum
+        uy   = P_ELEM( p0, i, uy );
+        uz   = P_ELEM( p0, i, uz );
+        q    = P_ELEM( p0, i, w );
         ux  += hax;                               // Half advance E
         uy  += hay;
         uz  += haz;
@@ -105,9 +104,9 @@ advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
         ux  += hax;                               // Half advance E
         uy  += hay;
         uz  += haz;
-        p[i].ux = ux;                               // Store momentum
-        p[i].uy = uy;
-        p[i].uz = uz;
+        P_ELEM( p0, i, ux ) = ux;                 // Store momentum
+        P_ELEM( p0, i, uy ) = uy;
+        P_ELEM( p0, i, uz ) = uz;
         v0   = one/sqrtf(one + (ux*ux+ (uy*uy + uz*uz)));
         /**/                                      // Get norm displacement
         ux  *= cdt_dx;
@@ -132,9 +131,9 @@ advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
             // current quadrant in a time-step
 
             q *= qsp;
-            p[i].dx = v3;                             // Store new position
-            p[i].dy = v4;
-            p[i].dz = v5;
+            P_ELEM( p0, i, dx ) = v3;               // Store new position
+            P_ELEM( p0, i, dy ) = v4;
+            P_ELEM( p0, i, dz ) = v5;
             dx = v0;                                // Streak midpoint
             dy = v1;
             dz = v2;
@@ -174,8 +173,7 @@ advance_p2_pipeline_scalar( advance_p_pipeline_args_t * args,
             local_pm->dispy = uy;
             local_pm->dispz = uz;
 
-            // TODO: this could be something like i.. but that fails?!
-            local_pm->i = i + itmp; //p_ - p0;
+            local_pm->i = i;
 
             if( move_p( p0, local_pm, a0, g, qsp ) ) { // Unlikely
                 if( nm<max_nm ) {
@@ -210,8 +208,11 @@ advance_p2( /**/  species_t            * RESTRICT sp,
     args->pm       = sp->pm;
     args->a0       = aa->a;
     args->f0       = ia->i;
+    args->fh       = NULL;
     args->seg      = seg;
     args->g        = sp->g;
+    args->tile     = NULL;
+    args->moved    = NULL;
 
     args->qdt_2mc  = (sp->q*sp->g->dt)/(2*sp->m*sp->g->cvac);
     args->cdt_dx   = sp->g->cvac*sp->g->dt*sp->g->rdx;
@@ -224,6 +225,7 @@ advance_p2( /**/  species_t            * RESTRICT sp,
     args->nx       = sp->g->nx;
     args->ny       = sp->g->ny;
     args->nz       = sp->g->nz;
+    args->pusher   = boris_pusher;
 
     // Have the host processor do the last incomplete bundle if necessary.
     // Note: This is overlapped with the pipelined processing.  As such,
@@ -236,15 +238,25 @@ advance_p2( /**/  species_t            * RESTRICT sp,
     // However, it is worth reconsidering this at some point in the
     // future.
 
+#if defined(VPIC_USE_TILED_ACCUMULATORS)
+    // Tiled accumulators flush all the current into the host accumulator
+    // array, so push everything into it serially.
+
+    int n_pipeline = 1;
+    advance_p2_pipeline_scalar( args, 0, n_pipeline );
+    advance_p2_pipeline_scalar( args, n_pipeline, n_pipeline );
+#else
+    int n_pipeline = N_PIPELINE;
     EXEC_PIPELINES( advance_p2, args, 0 );
     WAIT_PIPELINES();
+#endif
 
     // FIXME: HIDEOUS HACK UNTIL BETTER PARTICLE MOVER SEMANTICS
     // INSTALLED FOR DEALING WITH PIPELINES.  COMPACT THE PARTICLE
     // MOVERS TO ELIMINATE HOLES FROM THE PIPELINING.
 
     sp->nm = 0;
-    for( rank=0; rank<=N_PIPELINE; rank++ ) {
+    for( rank=0; rank<=n_pipeline; rank++ ) {
         if( args->seg[rank].n_ignored )
             WARNING(( "Pipeline %i ran out of storage for %i movers",
                         rank, args->seg[rank].n_ignored ));